@@ -0,0 +1,173 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "captureencoder_p.h"
+
+#include <QDir>
+#include <QImage>
+#include <QDebug>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+CaptureEncoder::CaptureEncoder(const QString &path, Format format, int framesPerSecond, int maxQueuedFrames)
+    : m_path(path)
+    , m_format(format)
+    , m_framesPerSecond(qMax(1, framesPerSecond))
+    , m_maxQueuedFrames(qMax(1, maxQueuedFrames))
+    , m_finishing(false)
+    , m_writtenFrames(0)
+{
+}
+
+CaptureEncoder::~CaptureEncoder()
+{
+    finish();
+}
+
+bool CaptureEncoder::open()
+{
+    if (m_format == Y4m) {
+        m_file.setFileName(m_path);
+        if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "Could not open capture file" << m_path << m_file.errorString();
+            return false;
+        }
+    } else if (!QDir().mkpath(m_path)) {
+        qWarning() << "Could not create capture directory" << m_path;
+        return false;
+    }
+    start(QThread::LowPriority);
+    return true;
+}
+
+bool CaptureEncoder::isFull() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_queue.size() >= m_maxQueuedFrames;
+}
+
+bool CaptureEncoder::enqueue(const Frame &frame)
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_finishing || m_queue.size() >= m_maxQueuedFrames)
+        return false;
+    m_queue.enqueue(frame);
+    m_wakeUp.wakeOne();
+    return true;
+}
+
+void CaptureEncoder::finish()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_finishing = true;
+        m_wakeUp.wakeOne();
+    }
+    wait();
+}
+
+int CaptureEncoder::writtenFrames() const
+{
+    return m_writtenFrames.load();
+}
+
+void CaptureEncoder::run()
+{
+    forever {
+        Frame frame;
+        {
+            QMutexLocker lock(&m_mutex);
+            while (m_queue.isEmpty() && !m_finishing)
+                m_wakeUp.wait(&m_mutex);
+            if (m_queue.isEmpty())
+                break; // Finishing and everything is written
+            frame = m_queue.dequeue();
+        }
+        if (m_format == Y4m)
+            writeY4m(frame);
+        else
+            writePng(frame);
+    }
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+void CaptureEncoder::writeY4m(const Frame &frame)
+{
+    if (m_size.isEmpty()) {
+        m_size = frame.size;
+        m_file.write(QStringLiteral("YUV4MPEG2 W%1 H%2 F%3:1 Ip A1:1 C420jpeg\n")
+                     .arg(m_size.width()).arg(m_size.height()).arg(m_framesPerSecond).toLatin1());
+    }
+    if (frame.size != m_size) {
+        qWarning() << "Captured frame" << frame.index << "does not match the stream size" << m_size;
+        return;
+    }
+    // Full range BT.601, chroma is the average of 2x2 pixels. Width and height are even.
+    const int w = m_size.width();
+    const int h = m_size.height();
+    m_planes.resize(w * h + 2 * (w / 2) * (h / 2));
+    uchar *yPlane = reinterpret_cast<uchar*>(m_planes.data());
+    uchar *uPlane = yPlane + w * h;
+    uchar *vPlane = uPlane + (w / 2) * (h / 2);
+    const uchar *rgba = reinterpret_cast<const uchar*>(frame.rgba.constData());
+    for (int y = 0; y < h; y += 2) {
+        // Frames are bottom up, y4m is top down
+        const uchar *rows[2] = { rgba + (h - 1 - y) * w * 4, rgba + (h - 2 - y) * w * 4 };
+        for (int x = 0; x < w; x += 2) {
+            int r = 0, g = 0, b = 0;
+            for (int j = 0; j < 2; ++j) {
+                for (int i = 0; i < 2; ++i) {
+                    const uchar *p = rows[j] + (x + i) * 4;
+                    yPlane[(y + j) * w + x + i] = static_cast<uchar>((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                }
+            }
+            r /= 4;
+            g /= 4;
+            b /= 4;
+            // Offset by 128 << 8 before shifting, the sums are never negative
+            const int chroma = (y / 2) * (w / 2) + x / 2;
+            uPlane[chroma] = static_cast<uchar>(qMin(255, (-43 * r - 85 * g + 128 * b + 32896) >> 8));
+            vPlane[chroma] = static_cast<uchar>(qMin(255, (128 * r - 107 * g - 21 * b + 32896) >> 8));
+        }
+    }
+    m_file.write("FRAME\n", 6);
+    if (m_file.write(m_planes) != m_planes.size()) {
+        qWarning() << "Could not write captured frame" << frame.index << m_file.errorString();
+        return;
+    }
+    m_writtenFrames.ref();
+}
+
+void CaptureEncoder::writePng(const Frame &frame)
+{
+    const QImage image(reinterpret_cast<const uchar*>(frame.rgba.constData()),
+                       frame.size.width(), frame.size.height(), frame.size.width() * 4, QImage::Format_RGBA8888);
+    const QString fileName = QDir(m_path).filePath(QStringLiteral("frame_%1.png").arg(frame.index, 6, 10, QLatin1Char('0')));
+    if (!image.mirrored().save(fileName)) {
+        qWarning() << "Could not write captured frame" << fileName;
+        return;
+    }
+    m_writtenFrames.ref();
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
@@ -0,0 +1,100 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_CAPTUREENCODER_P_H
+#define QT3DVIRTUALREALITY_CAPTUREENCODER_P_H
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QSize>
+#include <QThread>
+#include <QWaitCondition>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The CaptureEncoder class writes captured frames on its own thread.
+ * Y4m appends all frames to a single yuv 4:2:0 file, Png writes one file per frame into a directory.
+ * At most maxQueuedFrames wait for the encoder, enqueue refuses frames beyond that.
+ */
+class CaptureEncoder : public QThread
+{
+public:
+    enum Format {
+        Y4m,
+        Png
+    };
+
+    struct Frame {
+        QByteArray rgba; //!< Tightly packed 8 bit rgba, bottom row first
+        QSize size;
+        int index;
+    };
+
+    CaptureEncoder(const QString &path, Format format, int framesPerSecond, int maxQueuedFrames = 8);
+    ~CaptureEncoder();
+
+    /*!
+     * \brief open the output and start the thread.
+     * \return false if the output can not be written
+     */
+    bool open();
+    /*!
+     * \brief isFull if the next frame would be refused. Can be called from any thread.
+     */
+    bool isFull() const;
+    /*!
+     * \brief enqueue a frame for writing. Never blocks.
+     * \return false if too many frames are waiting
+     */
+    bool enqueue(const Frame &frame);
+    /*!
+     * \brief finish writes all queued frames and waits for the thread.
+     */
+    void finish();
+
+    int writtenFrames() const;
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    void writeY4m(const Frame &frame);
+    void writePng(const Frame &frame);
+
+    const QString m_path;
+    const Format m_format;
+    const int m_framesPerSecond;
+    const int m_maxQueuedFrames;
+    mutable QMutex m_mutex;
+    QWaitCondition m_wakeUp;
+    QQueue<Frame> m_queue;
+    bool m_finishing;
+    QFile m_file;
+    QSize m_size; // Of the y4m stream, fixed by the first frame
+    QByteArray m_planes;
+    QAtomicInt m_writtenFrames;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_CAPTUREENCODER_P_H
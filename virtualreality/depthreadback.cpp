@@ -0,0 +1,156 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#include "depthreadback_p.h"
+
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions_3_2_Core>
+#include <QDebug>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+DepthReadback::DepthReadback(int ringSize)
+    : m_slots(qMax(2, ringSize))
+    , m_head(0)
+    , m_tail(0)
+    , m_inFlight(0)
+    , m_readFramebuffer(0)
+    , m_funcs(nullptr)
+{
+}
+
+DepthReadback::~DepthReadback()
+{
+    // Gpu resources are freed in destroy(), there is no context here.
+}
+
+void DepthReadback::read(GLuint depthTexture, const QSize &size, const QMatrix4x4 &viewProjection)
+{
+    if (!m_funcs) {
+        m_funcs = QOpenGLContext::currentContext()->versionFunctions<QOpenGLFunctions_3_2_Core>();
+        if (!m_funcs) {
+            qWarning() << "Could not get OpenGLFunctions 3.2, depth will not be read back";
+            return;
+        }
+        m_funcs->initializeOpenGLFunctions();
+        m_funcs->glGenFramebuffers(1, &m_readFramebuffer);
+    }
+    // The gpu has not finished the readbacks of the last frames yet
+    if (m_inFlight == m_slots.size() || size.isEmpty())
+        return;
+
+    Slot &slot = m_slots[m_head];
+    const int byteCount = size.width() * size.height() * int(sizeof(float));
+    if (!slot.buffer) {
+        slot.buffer = new QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer);
+        slot.buffer->setUsagePattern(QOpenGLBuffer::StreamRead);
+        slot.buffer->create();
+    }
+    slot.buffer->bind();
+    if (slot.buffer->size() < byteCount)
+        slot.buffer->allocate(byteCount);
+    // Depth only, a read buffer of none keeps the framebuffer complete
+    m_funcs->glBindFramebuffer(GL_READ_FRAMEBUFFER, m_readFramebuffer);
+    m_funcs->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+    m_funcs->glReadBuffer(GL_NONE);
+    m_funcs->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    // Destination is the bound pixel pack buffer, offset 0. Returns without waiting for the gpu.
+    m_funcs->glReadPixels(0, 0, size.width(), size.height(), GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    m_funcs->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, 0, 0);
+    slot.buffer->release();
+    m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    slot.fence = m_funcs->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.size = size;
+    slot.viewProjection = viewProjection;
+    m_head = (m_head + 1) % m_slots.size();
+    ++m_inFlight;
+}
+
+bool DepthReadback::update()
+{
+    if (!m_funcs)
+        return false;
+    // In order of submission, only the newest finished one is mapped
+    int newest = -1;
+    while (m_inFlight > 0) {
+        Slot &slot = m_slots[m_tail];
+        const GLenum result = m_funcs->glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+            break;
+        if (result == GL_WAIT_FAILED)
+            qWarning() << "Waiting for depth readback failed";
+        m_funcs->glDeleteSync(slot.fence);
+        slot.fence = 0;
+        newest = result == GL_WAIT_FAILED ? -1 : m_tail;
+        m_tail = (m_tail + 1) % m_slots.size();
+        --m_inFlight;
+    }
+    if (newest < 0)
+        return false;
+
+    Slot &slot = m_slots[newest];
+    const int count = slot.size.width() * slot.size.height();
+    slot.buffer->bind();
+    const void *src = slot.buffer->mapRange(0, count * int(sizeof(float)), QOpenGLBuffer::RangeRead);
+    if (!src) {
+        qWarning() << "Could not map pixel buffer of depth readback";
+        slot.buffer->release();
+        return false;
+    }
+    m_frame.depth.resize(count);
+    memcpy(m_frame.depth.data(), src, count * sizeof(float));
+    m_frame.size = slot.size;
+    m_frame.viewProjection = slot.viewProjection;
+    slot.buffer->unmap();
+    slot.buffer->release();
+    return true;
+}
+
+const DepthReadback::Frame &DepthReadback::frame() const
+{
+    return m_frame;
+}
+
+void DepthReadback::clearFrame()
+{
+    m_frame = Frame();
+}
+
+void DepthReadback::destroy()
+{
+    clearFrame();
+    for (Slot &slot : m_slots) {
+        if (slot.fence != 0 && m_funcs)
+            m_funcs->glDeleteSync(slot.fence);
+        delete slot.buffer;
+        slot = Slot();
+    }
+    m_head = 0;
+    m_tail = 0;
+    m_inFlight = 0;
+    if (m_funcs)
+        m_funcs->glDeleteFramebuffers(1, &m_readFramebuffer);
+    m_readFramebuffer = 0;
+    m_funcs = nullptr;
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
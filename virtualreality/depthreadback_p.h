@@ -0,0 +1,91 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#ifndef QT3DVIRTUALREALITY_DEPTHREADBACK_P_H
+#define QT3DVIRTUALREALITY_DEPTHREADBACK_P_H
+
+#include <QMatrix4x4>
+#include <QSize>
+#include <QVector>
+#include <qopengl.h>
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLBuffer;
+class QOpenGLFunctions_3_2_Core;
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The DepthReadback class copies a small depth texture to the cpu without stalling the frame.
+ * Each frame the texture is read into the next pixel buffer object of a ring, guarded by a fence.
+ * Only the newest readback whose fence signaled is mapped, together with the view projection it was rendered with.
+ * If all buffers are in flight, the frame is skipped.
+ */
+class DepthReadback
+{
+public:
+    struct Frame {
+        QVector<float> depth; // Window depth, rows bottom up
+        QSize size;
+        QMatrix4x4 viewProjection;
+    };
+
+    explicit DepthReadback(int ringSize = 3);
+    ~DepthReadback();
+
+    /*!
+     * \brief read \a depthTexture of \a size pixels. Render thread with the context current, never waits for the gpu.
+     * Leaves the default framebuffer of the context bound.
+     */
+    void read(GLuint depthTexture, const QSize &size, const QMatrix4x4 &viewProjection);
+    /*!
+     * \brief update maps the newest finished readback into frame, older ones are dropped. Context must be current.
+     * \return false if none finished since the last call.
+     */
+    bool update();
+    /*!
+     * \brief frame is the newest depth read back, empty before the first one and after clearFrame.
+     */
+    const Frame &frame() const;
+    void clearFrame();
+
+    /*!
+     * \brief destroy deletes all buffers. Context must be current.
+     */
+    void destroy();
+
+private:
+    struct Slot {
+        Slot() : buffer(nullptr), fence(0) {}
+        QOpenGLBuffer *buffer;
+        GLsync fence;
+        QSize size;
+        QMatrix4x4 viewProjection;
+    };
+
+    QVector<Slot> m_slots;
+    int m_head; // Next slot to read into
+    int m_tail; // Oldest slot in flight
+    int m_inFlight;
+    GLuint m_readFramebuffer;
+    Frame m_frame;
+    QOpenGLFunctions_3_2_Core *m_funcs;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_DEPTHREADBACK_P_H
@@ -0,0 +1,176 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "eyetexturearray_p.h"
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions_3_2_Core>
+#include <QDebug>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+EyeTextureArray::EyeTextureArray()
+    : m_samples(0)
+    , m_framebuffer(0)
+    , m_colorTexture(0)
+    , m_depthTexture(0)
+    , m_funcs(nullptr)
+{
+    m_resolveFramebuffers[0] = 0;
+    m_resolveFramebuffers[1] = 0;
+}
+
+EyeTextureArray::~EyeTextureArray()
+{
+    // Gpu resources are freed in destroy(), there is no context here.
+}
+
+bool EyeTextureArray::create(const QSize &eyeSize, int samples, bool floatDepth)
+{
+    if (!m_funcs) {
+        m_funcs = QOpenGLContext::currentContext()->versionFunctions<QOpenGLFunctions_3_2_Core>();
+        if (!m_funcs) {
+            qWarning() << "Could not get OpenGLFunctions 3.2, eye texture array is not available";
+            return false;
+        }
+        m_funcs->initializeOpenGLFunctions();
+    }
+    destroy();
+    m_eyeSize = eyeSize;
+    m_samples = samples > 1 ? samples : 0;
+    const GLenum target = m_samples ? GL_TEXTURE_2D_MULTISAMPLE_ARRAY : GL_TEXTURE_2D_ARRAY;
+
+    m_funcs->glGenTextures(1, &m_colorTexture);
+    m_funcs->glBindTexture(target, m_colorTexture);
+    if (m_samples) {
+        m_funcs->glTexImage3DMultisample(target, m_samples, GL_RGBA8, eyeSize.width(), eyeSize.height(), 2, GL_TRUE);
+    } else {
+        m_funcs->glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        m_funcs->glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        m_funcs->glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        m_funcs->glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        m_funcs->glTexImage3D(target, 0, GL_RGBA8, eyeSize.width(), eyeSize.height(), 2, 0,
+                              GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+
+    const GLenum depthFormat = floatDepth ? GL_DEPTH32F_STENCIL8 : GL_DEPTH24_STENCIL8;
+    m_funcs->glGenTextures(1, &m_depthTexture);
+    m_funcs->glBindTexture(target, m_depthTexture);
+    if (m_samples) {
+        m_funcs->glTexImage3DMultisample(target, m_samples, depthFormat, eyeSize.width(), eyeSize.height(), 2, GL_TRUE);
+    } else {
+        m_funcs->glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        m_funcs->glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        m_funcs->glTexImage3D(target, 0, depthFormat, eyeSize.width(), eyeSize.height(), 2, 0, GL_DEPTH_STENCIL,
+                              floatDepth ? GL_FLOAT_32_UNSIGNED_INT_24_8_REV : GL_UNSIGNED_INT_24_8, nullptr);
+    }
+    m_funcs->glBindTexture(target, 0);
+
+    // Layered attachments, gl_Layer of the geometry shader picks the eye
+    m_funcs->glGenFramebuffers(1, &m_framebuffer);
+    m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    m_funcs->glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_colorTexture, 0);
+    m_funcs->glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, m_depthTexture, 0);
+    const GLenum status = m_funcs->glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        qWarning() << "Eye texture array framebuffer is incomplete, status:" << hex << status;
+        destroy();
+        return false;
+    }
+    return true;
+}
+
+void EyeTextureArray::destroy()
+{
+    if (!m_funcs)
+        return;
+    if (m_framebuffer)
+        m_funcs->glDeleteFramebuffers(1, &m_framebuffer);
+    if (m_colorTexture)
+        m_funcs->glDeleteTextures(1, &m_colorTexture);
+    if (m_depthTexture)
+        m_funcs->glDeleteTextures(1, &m_depthTexture);
+    if (m_resolveFramebuffers[0])
+        m_funcs->glDeleteFramebuffers(2, m_resolveFramebuffers);
+    m_resolveFramebuffers[0] = 0;
+    m_resolveFramebuffers[1] = 0;
+    m_framebuffer = 0;
+    m_colorTexture = 0;
+    m_depthTexture = 0;
+}
+
+bool EyeTextureArray::bind()
+{
+    if (!m_framebuffer)
+        return false;
+    m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    return true;
+}
+
+void EyeTextureArray::resolveTo(const EyeTextureArray &target, GLbitfield buffers)
+{
+    if (!m_framebuffer || !target.m_framebuffer)
+        return;
+    if (!m_resolveFramebuffers[0])
+        m_funcs->glGenFramebuffers(2, m_resolveFramebuffers);
+    // Blits operate on a single layer, attach one eye at a time
+    m_funcs->glBindFramebuffer(GL_READ_FRAMEBUFFER, m_resolveFramebuffers[0]);
+    m_funcs->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_resolveFramebuffers[1]);
+    for (int layer = 0; layer < 2; ++layer) {
+        m_funcs->glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_colorTexture, 0, layer);
+        m_funcs->glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, target.m_colorTexture, 0, layer);
+        if (buffers & GL_DEPTH_BUFFER_BIT) {
+            m_funcs->glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, m_depthTexture, 0, layer);
+            m_funcs->glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, target.m_depthTexture, 0, layer);
+        }
+        // Depth can only be resolved with nearest, which picks one sample
+        m_funcs->glBlitFramebuffer(0, 0, m_eyeSize.width(), m_eyeSize.height(),
+                                   0, 0, target.m_eyeSize.width(), target.m_eyeSize.height(),
+                                   buffers, GL_NEAREST);
+    }
+    m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool EyeTextureArray::isCreated() const
+{
+    return m_framebuffer != 0;
+}
+
+QSize EyeTextureArray::eyeSize() const
+{
+    return m_eyeSize;
+}
+
+GLuint EyeTextureArray::framebuffer() const
+{
+    return m_framebuffer;
+}
+
+GLuint EyeTextureArray::colorTexture() const
+{
+    return m_colorTexture;
+}
+
+GLuint EyeTextureArray::depthTexture() const
+{
+    return m_depthTexture;
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
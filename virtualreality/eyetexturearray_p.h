@@ -0,0 +1,76 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_EYETEXTUREARRAY_P_H
+#define QT3DVIRTUALREALITY_EYETEXTUREARRAY_P_H
+
+#include <QSize>
+#include <qopengl.h>
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLFunctions_3_2_Core;
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The EyeTextureArray class is a render target with one layer per eye.
+ * Color and depth are 2 layer texture arrays, attached layered, so a geometry shader
+ * selects the eye with gl_Layer. Layer 0 is the left eye.
+ * Multisampled arrays are resolved layer by layer into a single sampled one with resolveTo.
+ */
+class EyeTextureArray
+{
+public:
+    EyeTextureArray();
+    ~EyeTextureArray();
+
+    /*!
+     * \brief create allocates both arrays with \a eyeSize per layer. Context must be current.
+     * \param samples more than 1 creates multisample arrays
+     * \param floatDepth depth32f stencil8 instead of depth24 stencil8
+     */
+    bool create(const QSize &eyeSize, int samples = 0, bool floatDepth = false);
+    /*!
+     * \brief destroy deletes all gl objects. Context must be current.
+     */
+    void destroy();
+    bool bind();
+    /*!
+     * \brief resolveTo blits \a buffers of both layers into \a target, which must be single sampled.
+     */
+    void resolveTo(const EyeTextureArray &target, GLbitfield buffers = GL_COLOR_BUFFER_BIT);
+
+    bool isCreated() const;
+    QSize eyeSize() const;
+    GLuint framebuffer() const;
+    GLuint colorTexture() const;
+    GLuint depthTexture() const;
+
+private:
+    QSize m_eyeSize;
+    int m_samples;
+    GLuint m_framebuffer;
+    GLuint m_resolveFramebuffers[2]; // read and draw, one layer attached at a time
+    GLuint m_colorTexture;
+    GLuint m_depthTexture;
+    QOpenGLFunctions_3_2_Core *m_funcs;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_EYETEXTUREARRAY_P_H
@@ -0,0 +1,68 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "foveation_p.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+namespace Foveation {
+
+namespace {
+
+QRectF centerRect(const QMatrix4x4 &projection, float centerSize)
+{
+    // Optical axis in ndc is (-P(0,2), -P(1,2))
+    const QPointF axis(0.5 * (1.0 - projection(0, 2)), 0.5 * (1.0 - projection(1, 2)));
+    QRectF rect(0.0, 0.0, centerSize, centerSize);
+    rect.moveCenter(axis);
+    // Keep inside the viewport, asymmetric lenses have the axis off center
+    rect.moveLeft(qBound(0.0, rect.left(), 1.0 - rect.width()));
+    rect.moveTop(qBound(0.0, rect.top(), 1.0 - rect.height()));
+    return rect;
+}
+
+} // anonymous
+
+QVirtualRealityApiBackend::FoveationProfile lensProfile(const QMatrix4x4 &leftProjection, const QMatrix4x4 &rightProjection,
+                                                        float centerSize, float peripheryScale)
+{
+    QVirtualRealityApiBackend::FoveationProfile profile;
+    profile.leftCenter = centerRect(leftProjection, centerSize);
+    profile.rightCenter = centerRect(rightProjection, centerSize);
+    profile.peripheryScale = peripheryScale;
+    return profile;
+}
+
+QMatrix4x4 cropProjection(const QMatrix4x4 &projection, const QRectF &rect)
+{
+    // Maps the ndc range of rect to [-1, 1], in clip space so it stays a linear transform
+    const float scaleX = 1.0f / rect.width();
+    const float scaleY = 1.0f / rect.height();
+    const float centerX = 2.0f * rect.center().x() - 1.0f;
+    const float centerY = 2.0f * rect.center().y() - 1.0f;
+    const QMatrix4x4 crop(scaleX, 0.0f, 0.0f, -scaleX * centerX,
+                          0.0f, scaleY, 0.0f, -scaleY * centerY,
+                          0.0f, 0.0f, 1.0f, 0.0f,
+                          0.0f, 0.0f, 0.0f, 1.0f);
+    return crop * projection;
+}
+
+} // namespace Foveation
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
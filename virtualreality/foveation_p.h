@@ -0,0 +1,47 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_FOVEATION_P_H
+#define QT3DVIRTUALREALITY_FOVEATION_P_H
+
+#include "qvirtualrealityapibackend.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+namespace Foveation {
+
+/*!
+ * \brief lensProfile centers the full resolution region on the optical axis of each eye.
+ * \param centerSize width and height of the full resolution region, relative to the eye viewport
+ * \param peripheryScale resolution of the rest of the eye
+ */
+QVirtualRealityApiBackend::FoveationProfile lensProfile(const QMatrix4x4 &leftProjection, const QMatrix4x4 &rightProjection,
+                                                        float centerSize, float peripheryScale);
+
+/*!
+ * \brief cropProjection restricts \a projection to \a rect of the viewport.
+ * Used to render the full resolution center with its own camera.
+ */
+QMatrix4x4 cropProjection(const QMatrix4x4 &projection, const QRectF &rect);
+
+} // namespace Foveation
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_FOVEATION_P_H
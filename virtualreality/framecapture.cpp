@@ -0,0 +1,227 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "framecapture_p.h"
+#include "qvirtualrealityapibackend.h"
+
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions_3_2_Core>
+#include <QDebug>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+FrameCapture::FrameCapture(int ringSize)
+    : m_scale(0.5)
+    , m_slots(qMax(2, ringSize))
+    , m_head(0)
+    , m_tail(0)
+    , m_inFlight(0)
+    , m_frameIndex(0)
+    , m_target(nullptr)
+    , m_readFramebuffer(0)
+    , m_droppedFrames(0)
+    , m_writtenFrames(0)
+    , m_funcs(nullptr)
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+    // Gpu resources are freed in destroy(), there is no context here.
+}
+
+bool FrameCapture::start(const QString &path, CaptureEncoder::Format format, qreal scale, int framesPerSecond)
+{
+    if (m_encoder) {
+        qWarning() << "Already capturing, stop first";
+        return false;
+    }
+    QScopedPointer<CaptureEncoder> encoder(new CaptureEncoder(path, format, framesPerSecond));
+    if (!encoder->open())
+        return false;
+    m_encoder.swap(encoder);
+    m_scale = qBound(0.05, scale, 1.0);
+    m_frameIndex = 0;
+    m_writtenFrames = 0;
+    m_droppedFrames.store(0);
+    return true;
+}
+
+void FrameCapture::stop()
+{
+    if (!m_encoder)
+        return;
+    if (m_funcs)
+        retire(true);
+    m_encoder->finish();
+    m_writtenFrames = m_encoder->writtenFrames();
+    m_encoder.reset();
+}
+
+bool FrameCapture::isActive() const
+{
+    return !m_encoder.isNull();
+}
+
+void FrameCapture::capture(QVirtualRealityApiBackend *apibackend)
+{
+    if (!m_encoder)
+        return;
+    if (!m_funcs) {
+        m_funcs = QOpenGLContext::currentContext()->versionFunctions<QOpenGLFunctions_3_2_Core>();
+        if (!m_funcs) {
+            qWarning() << "Could not get OpenGLFunctions 3.2, frames will not be captured";
+            return;
+        }
+        m_funcs->initializeOpenGLFunctions();
+        m_funcs->glGenFramebuffers(1, &m_readFramebuffer);
+    }
+
+    retire(false);
+    const int index = m_frameIndex++;
+    if (m_inFlight == m_slots.size()) {
+        // The gpu has not finished the readbacks of the last frames yet
+        m_droppedFrames.ref();
+        return;
+    }
+
+    QVirtualRealityApiBackend::MirrorTexture eyes[2];
+    if (!apibackend->getMirrorTexture(0, eyes[0]) || !apibackend->getMirrorTexture(1, eyes[1]))
+        return;
+    // Even sizes, for chroma subsampling of the encoder
+    const QSize eyeSize(qMax(1, qRound(eyes[0].eyeRect.width() * m_scale * 0.5)) * 2,
+                        qMax(1, qRound(qAbs(eyes[0].eyeRect.height()) * m_scale * 0.5)) * 2);
+    const QSize size(eyeSize.width() * 2, eyeSize.height());
+
+    if (!m_target || m_target->size() != size) {
+        delete m_target;
+        m_target = new QOpenGLFramebufferObject(size, QOpenGLFramebufferObject::NoAttachment, GL_TEXTURE_2D, GL_RGBA8);
+    }
+    m_funcs->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_target->handle());
+    m_funcs->glBindFramebuffer(GL_READ_FRAMEBUFFER, m_readFramebuffer);
+    for (int i = 0; i < 2; ++i) {
+        const QVirtualRealityApiBackend::MirrorTexture &source = eyes[i];
+        if (source.layer >= 0)
+            m_funcs->glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, source.textureId, 0, source.layer);
+        else
+            m_funcs->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, source.textureId, 0);
+        const QRect &r = source.eyeRect;
+        m_funcs->glBlitFramebuffer(r.x(), r.y(), r.x() + r.width(), r.y() + r.height(),
+                                   i * eyeSize.width(), 0, (i + 1) * eyeSize.width(), eyeSize.height(),
+                                   GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    }
+    m_funcs->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+
+    Slot &slot = m_slots[m_head];
+    const int byteCount = size.width() * size.height() * 4;
+    if (!slot.buffer) {
+        slot.buffer = new QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer);
+        slot.buffer->setUsagePattern(QOpenGLBuffer::StreamRead);
+        slot.buffer->create();
+    }
+    slot.buffer->bind();
+    if (slot.buffer->size() < byteCount)
+        slot.buffer->allocate(byteCount);
+    m_funcs->glBindFramebuffer(GL_READ_FRAMEBUFFER, m_target->handle());
+    m_funcs->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    // Destination is the bound pixel pack buffer, offset 0. Returns without waiting for the gpu.
+    m_funcs->glReadPixels(0, 0, size.width(), size.height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    slot.buffer->release();
+    m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    slot.fence = m_funcs->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.size = size;
+    slot.index = index;
+    m_head = (m_head + 1) % m_slots.size();
+    ++m_inFlight;
+}
+
+void FrameCapture::retire(bool wait)
+{
+    // In order of submission, so the encoder gets frames in order
+    while (m_inFlight > 0) {
+        Slot &slot = m_slots[m_tail];
+        const GLenum result = m_funcs->glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? GL_TIMEOUT_IGNORED : 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+            return;
+        if (result == GL_WAIT_FAILED)
+            qWarning() << "Waiting for captured frame failed, index:" << slot.index;
+        m_funcs->glDeleteSync(slot.fence);
+        slot.fence = 0;
+        m_tail = (m_tail + 1) % m_slots.size();
+        --m_inFlight;
+
+        // Do not copy frames the encoder would refuse anyway
+        if (m_encoder->isFull()) {
+            m_droppedFrames.ref();
+            continue;
+        }
+        const int byteCount = slot.size.width() * slot.size.height() * 4;
+        slot.buffer->bind();
+        const void *src = slot.buffer->mapRange(0, byteCount, QOpenGLBuffer::RangeRead);
+        if (!src) {
+            qWarning() << "Could not map pixel buffer of captured frame" << slot.index;
+            slot.buffer->release();
+            m_droppedFrames.ref();
+            continue;
+        }
+        CaptureEncoder::Frame frame;
+        frame.rgba = QByteArray(static_cast<const char*>(src), byteCount);
+        frame.size = slot.size;
+        frame.index = slot.index;
+        slot.buffer->unmap();
+        slot.buffer->release();
+        if (!m_encoder->enqueue(frame))
+            m_droppedFrames.ref();
+    }
+}
+
+void FrameCapture::destroy()
+{
+    stop();
+    for (Slot &slot : m_slots) {
+        if (slot.fence != 0 && m_funcs)
+            m_funcs->glDeleteSync(slot.fence);
+        delete slot.buffer;
+        slot = Slot();
+    }
+    m_head = 0;
+    m_tail = 0;
+    m_inFlight = 0;
+    delete m_target;
+    m_target = nullptr;
+    if (m_funcs)
+        m_funcs->glDeleteFramebuffers(1, &m_readFramebuffer);
+    m_readFramebuffer = 0;
+    m_funcs = nullptr;
+}
+
+int FrameCapture::capturedFrames() const
+{
+    return m_encoder ? m_encoder->writtenFrames() : m_writtenFrames;
+}
+
+int FrameCapture::droppedFrames() const
+{
+    return m_droppedFrames.load();
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
@@ -0,0 +1,103 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_FRAMECAPTURE_P_H
+#define QT3DVIRTUALREALITY_FRAMECAPTURE_P_H
+
+#include "captureencoder_p.h"
+
+#include <QAtomicInt>
+#include <QScopedPointer>
+#include <QSize>
+#include <QVector>
+#include <qopengl.h>
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLBuffer;
+class QOpenGLFramebufferObject;
+class QOpenGLFunctions_3_2_Core;
+
+namespace Qt3DVirtualReality {
+
+class QVirtualRealityApiBackend;
+
+/*!
+ * \brief The FrameCapture class records the submitted eyes without stalling the frame.
+ * Each frame both eyes are blitted side by side into a downscaled target and read into the next pixel
+ * buffer object of a ring, guarded by a fence. A buffer is mapped frames later, after its fence signaled,
+ * and the pixels are handed to a CaptureEncoder. If all buffers are in flight or the encoder is behind,
+ * the frame is dropped and counted. Memory is bounded by the ring and the queue of the encoder.
+ */
+class FrameCapture
+{
+public:
+    explicit FrameCapture(int ringSize = 3);
+    ~FrameCapture();
+
+    /*!
+     * \brief start recording into \a path. Does not need a context.
+     * \param scale of the recording relative to the eye textures
+     */
+    bool start(const QString &path, CaptureEncoder::Format format, qreal scale, int framesPerSecond);
+    /*!
+     * \brief stop waits for the frames in flight and for the encoder. Context must be current.
+     */
+    void stop();
+    bool isActive() const;
+
+    /*!
+     * \brief capture the frame submitted last. Render thread, after swapToHeadset. Never waits for the gpu.
+     */
+    void capture(QVirtualRealityApiBackend *apibackend);
+
+    /*!
+     * \brief destroy deletes all buffers. Context must be current.
+     */
+    void destroy();
+
+    int capturedFrames() const;
+    int droppedFrames() const;
+
+private:
+    struct Slot {
+        Slot() : buffer(nullptr), fence(0), index(0) {}
+        QOpenGLBuffer *buffer;
+        GLsync fence;
+        QSize size;
+        int index;
+    };
+
+    void retire(bool wait);
+
+    QScopedPointer<CaptureEncoder> m_encoder;
+    qreal m_scale;
+    QVector<Slot> m_slots;
+    int m_head; // Next slot to read into
+    int m_tail; // Oldest slot in flight
+    int m_inFlight;
+    int m_frameIndex;
+    QOpenGLFramebufferObject *m_target;
+    GLuint m_readFramebuffer;
+    QAtomicInt m_droppedFrames;
+    int m_writtenFrames; // Of encoders already finished
+    QOpenGLFunctions_3_2_Core *m_funcs;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_FRAMECAPTURE_P_H
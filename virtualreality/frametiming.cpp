@@ -0,0 +1,153 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "frametiming_p.h"
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions_3_2_Core>
+#include <QOpenGLTimerQuery>
+#include <QDebug>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+namespace {
+
+// Weight of the newest frame in the moving averages
+const qreal AverageWeight = 0.05;
+
+void accumulate(qreal &average, qreal value)
+{
+    average = average == 0.0 ? value : average + (value - average) * AverageWeight;
+}
+
+} // anonymous
+
+FrameTiming::FrameTiming(int ringSize)
+    : m_slots(qMax(2, ringSize))
+    , m_current(0)
+    , m_queriesFailed(false)
+    , m_funcs(nullptr)
+    , m_cpuTime(0.0)
+    , m_gpuTime(0.0)
+    , m_gpuTimeWithSpectator(0.0)
+    , m_gpuTimeWithoutSpectator(0.0)
+    , m_primitives(0)
+{
+}
+
+FrameTiming::~FrameTiming()
+{
+    // Gpu resources are freed in destroy(), there is no context here.
+}
+
+void FrameTiming::begin(bool spectator)
+{
+    m_cpuTimer.start();
+    if (m_queriesFailed)
+        return;
+    Slot &slot = m_slots[m_current];
+    if (slot.pending)
+        return; // Results of this slot are still outstanding, skip measuring the gpu this frame
+    if (!slot.begin) {
+        slot.begin = new QOpenGLTimerQuery;
+        slot.end = new QOpenGLTimerQuery;
+        m_funcs = QOpenGLContext::currentContext()->versionFunctions<QOpenGLFunctions_3_2_Core>();
+        if (!slot.begin->create() || !slot.end->create() || !m_funcs) {
+            qWarning() << "Timer queries are not supported, gpu frame times will not be measured";
+            m_queriesFailed = true;
+            return;
+        }
+        m_funcs->initializeOpenGLFunctions();
+        m_funcs->glGenQueries(1, &slot.primitives);
+    }
+    slot.begin->recordTimestamp();
+    m_funcs->glBeginQuery(GL_PRIMITIVES_GENERATED, slot.primitives);
+    slot.spectator = spectator;
+}
+
+void FrameTiming::end()
+{
+    accumulate(m_cpuTime, m_cpuTimer.nsecsElapsed() / 1000000.0);
+    if (m_queriesFailed)
+        return;
+    Slot &slot = m_slots[m_current];
+    if (!slot.pending && slot.begin) {
+        m_funcs->glEndQuery(GL_PRIMITIVES_GENERATED);
+        slot.end->recordTimestamp();
+        slot.pending = true;
+        m_current = (m_current + 1) % m_slots.size();
+    }
+    retire();
+}
+
+void FrameTiming::retire()
+{
+    for (Slot &slot : m_slots) {
+        // Only poll, results are read once both timestamps arrived
+        if (!slot.pending || !slot.end->isResultAvailable() || !slot.begin->isResultAvailable())
+            continue;
+        GLuint available = GL_FALSE;
+        m_funcs->glGetQueryObjectuiv(slot.primitives, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+        GLuint primitives = 0;
+        m_funcs->glGetQueryObjectuiv(slot.primitives, GL_QUERY_RESULT, &primitives);
+        m_primitives = static_cast<int>(primitives);
+        slot.pending = false;
+        const qreal gpuTime = (slot.end->waitForResult() - slot.begin->waitForResult()) / 1000000.0;
+        accumulate(m_gpuTime, gpuTime);
+        accumulate(slot.spectator ? m_gpuTimeWithSpectator : m_gpuTimeWithoutSpectator, gpuTime);
+    }
+}
+
+void FrameTiming::destroy()
+{
+    for (Slot &slot : m_slots) {
+        if (slot.primitives != 0 && m_funcs)
+            m_funcs->glDeleteQueries(1, &slot.primitives);
+        delete slot.begin;
+        delete slot.end;
+        slot = Slot();
+    }
+    m_current = 0;
+}
+
+qreal FrameTiming::cpuTime() const
+{
+    return m_cpuTime;
+}
+
+qreal FrameTiming::gpuTime() const
+{
+    return m_gpuTime;
+}
+
+int FrameTiming::primitives() const
+{
+    return m_primitives;
+}
+
+qreal FrameTiming::spectatorGpuTime() const
+{
+    if (m_gpuTimeWithSpectator == 0.0 || m_gpuTimeWithoutSpectator == 0.0)
+        return 0.0;
+    return qMax(0.0, m_gpuTimeWithSpectator - m_gpuTimeWithoutSpectator);
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
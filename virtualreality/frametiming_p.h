@@ -0,0 +1,96 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_FRAMETIMING_P_H
+#define QT3DVIRTUALREALITY_FRAMETIMING_P_H
+
+#include <QElapsedTimer>
+#include <QVector>
+#include <qopengl.h>
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLTimerQuery;
+class QOpenGLFunctions_3_2_Core;
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The FrameTiming class measures how long the frames of the headset take to render.
+ * Cpu time is measured directly, gpu time with timestamp queries read frames later, without waiting.
+ * Frames that also render the spectator are averaged separately, their difference is the cost of the spectator.
+ * The primitives the gpu drew are counted with a query over the same span.
+ * All times are moving averages in milliseconds.
+ */
+class FrameTiming
+{
+public:
+    explicit FrameTiming(int ringSize = 4);
+    ~FrameTiming();
+
+    /*!
+     * \brief begin of the frame, context must be current.
+     * \param spectator if the spectator is rendered this frame
+     */
+    void begin(bool spectator);
+    /*!
+     * \brief end of the frame, after the eyes were submitted. Reads results of earlier frames.
+     */
+    void end();
+    /*!
+     * \brief destroy deletes all queries. Context must be current.
+     */
+    void destroy();
+
+    qreal cpuTime() const;
+    qreal gpuTime() const;
+    /*!
+     * \brief spectatorGpuTime is how much longer the gpu takes for frames that render the spectator.
+     */
+    qreal spectatorGpuTime() const;
+    /*!
+     * \brief primitives the gpu drew per frame, e.g. triangles. Not averaged.
+     */
+    int primitives() const;
+
+private:
+    struct Slot {
+        Slot() : begin(nullptr), end(nullptr), primitives(0), spectator(false), pending(false) {}
+        QOpenGLTimerQuery *begin;
+        QOpenGLTimerQuery *end;
+        GLuint primitives;
+        bool spectator;
+        bool pending;
+    };
+
+    void retire();
+
+    QVector<Slot> m_slots;
+    int m_current;
+    bool m_queriesFailed;
+    QOpenGLFunctions_3_2_Core *m_funcs;
+    QElapsedTimer m_cpuTimer;
+    qreal m_cpuTime;
+    qreal m_gpuTime;
+    qreal m_gpuTimeWithSpectator;
+    qreal m_gpuTimeWithoutSpectator;
+    int m_primitives;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_FRAMETIMING_P_H
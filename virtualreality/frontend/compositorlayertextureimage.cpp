@@ -0,0 +1,89 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "compositorlayertextureimage_p.h"
+
+#include <Qt3DRender/qtextureimagedatagenerator.h>
+#include <Qt3DRender/qtextureimagedata.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DRender;
+
+namespace Qt3DVirtualReality {
+
+class CompositorLayerTextureImageDataFunctor : public QTextureImageDataGenerator
+{
+public:
+    explicit CompositorLayerTextureImageDataFunctor(const QImage &image)
+        : m_image(image)
+    {}
+
+    QTextureImageDataPtr operator ()() Q_DECL_OVERRIDE
+    {
+        if (m_image.isNull())
+            return QTextureImageDataPtr();
+
+        QTextureImageDataPtr imageData = QTextureImageDataPtr::create();
+        imageData->setTarget(QOpenGLTexture::Target2D);
+        imageData->setWidth(m_image.width());
+        imageData->setHeight(m_image.height());
+        imageData->setDepth(1);
+        imageData->setFaces(1);
+        imageData->setLayers(1);
+        imageData->setMipLevels(1);
+        imageData->setFormat(QOpenGLTexture::RGBA8_UNorm);
+        imageData->setPixelFormat(QOpenGLTexture::RGBA);
+        imageData->setPixelType(QOpenGLTexture::UInt8);
+        // Rows go to the texture as they are, texture coordinates of the layer have the top at t = 0
+        imageData->setData(QByteArray(reinterpret_cast<const char*>(m_image.constBits()), m_image.byteCount()), 4);
+        return imageData;
+    }
+
+    bool operator ==(const QTextureImageDataGenerator &other) const Q_DECL_OVERRIDE
+    {
+        const CompositorLayerTextureImageDataFunctor *otherFunctor = functor_cast<CompositorLayerTextureImageDataFunctor>(&other);
+        if (otherFunctor != nullptr)
+            return otherFunctor->m_image.cacheKey() == m_image.cacheKey();
+        return false;
+    }
+
+    QT3D_FUNCTOR(CompositorLayerTextureImageDataFunctor)
+
+private:
+    QImage m_image;
+};
+
+CompositorLayerTextureImage::CompositorLayerTextureImage(Qt3DCore::QNode *parent)
+    : QAbstractTextureImage(parent)
+{
+}
+
+void CompositorLayerTextureImage::setImage(const QImage &image)
+{
+    if (image.cacheKey() == m_image.cacheKey())
+        return;
+    m_image = image;
+    notifyDataGeneratorChanged();
+}
+
+QTextureImageDataGeneratorPtr CompositorLayerTextureImage::dataGenerator() const
+{
+    return QTextureImageDataGeneratorPtr(new CompositorLayerTextureImageDataFunctor(m_image));
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
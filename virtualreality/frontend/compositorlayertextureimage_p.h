@@ -0,0 +1,52 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_COMPOSITORLAYERTEXTUREIMAGE_P_H
+#define QT3DVIRTUALREALITY_COMPOSITORLAYERTEXTUREIMAGE_P_H
+
+#include <Qt3DRender/qabstracttextureimage.h>
+#include <QImage>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The CompositorLayerTextureImage class feeds the image of a QCompositorLayer into Qt3D,
+ * when the layer is drawn by the fallback pass. The texture is regenerated only when the image changed.
+ */
+class CompositorLayerTextureImage : public Qt3DRender::QAbstractTextureImage
+{
+    Q_OBJECT
+public:
+    explicit CompositorLayerTextureImage(Qt3DCore::QNode *parent = nullptr);
+
+    /*!
+     * \brief setImage rgba8 image, top row first.
+     */
+    void setImage(const QImage &image);
+
+protected:
+    Qt3DRender::QTextureImageDataGeneratorPtr dataGenerator() const Q_DECL_OVERRIDE;
+
+private:
+    QImage m_image;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_COMPOSITORLAYERTEXTUREIMAGE_P_H
@@ -0,0 +1,111 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#include "cullingstatisticsjob_p.h"
+#include "jobtypes_p.h"
+
+#include <Qt3DCore/private/qaspectjob_p.h>
+#include <Qt3DRender/private/entity_p.h>
+#include <Qt3DRender/private/geometryrenderer_p.h>
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/nodemanagers_p.h>
+#include <Qt3DRender/private/sphere_p.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DRender;
+
+namespace Qt3DVirtualReality {
+
+CullingStatisticsJob::CullingStatisticsJob()
+    : QAspectJob()
+    , m_managers(nullptr)
+    , m_refinePerEye(false)
+    , m_hasInput(false)
+    , m_hasStatistics(false)
+{
+    SET_JOB_RUN_STAT_TYPE(this, JobTypes::CullingStatistics, 0);
+}
+
+void CullingStatisticsJob::setNodeManagers(Render::NodeManagers *managers)
+{
+    QMutexLocker lock(&m_mutex);
+    m_managers = managers;
+}
+
+void CullingStatisticsJob::setInput(const StereoFrustum &frustum, bool refinePerEye)
+{
+    QMutexLocker lock(&m_mutex);
+    m_frustum = frustum;
+    m_refinePerEye = refinePerEye;
+    m_hasInput = true;
+    m_hasStatistics = false;
+}
+
+bool CullingStatisticsJob::takeStatistics(Statistics &statistics)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_hasStatistics)
+        return false;
+    statistics = m_statistics;
+    m_hasStatistics = false;
+    return true;
+}
+
+void CullingStatisticsJob::run()
+{
+    Render::NodeManagers *managers;
+    StereoFrustum frustum;
+    bool refinePerEye;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (!m_hasInput || !m_managers)
+            return;
+        managers = m_managers;
+        frustum = m_frustum;
+        refinePerEye = m_refinePerEye;
+        m_hasInput = false;
+    }
+
+    // Same entities and spheres as the FrustumCulling of the single pass branch
+    Statistics statistics;
+    Render::EntityManager *entityManager = managers->renderNodesManager();
+    const QVector<Render::HEntity> handles = entityManager->activeHandles();
+    for (const Render::HEntity &handle : handles) {
+        Render::Entity *entity = entityManager->data(handle);
+        if (!entity || !entity->isEnabled())
+            continue;
+        Render::GeometryRenderer *renderer = entity->renderComponent<Render::GeometryRenderer>();
+        if (!renderer || !renderer->isEnabled())
+            continue;
+        ++statistics.submitted;
+        const Render::Sphere *sphere = entity->worldBoundingVolume();
+        const int visibility = frustum.classify(sphere->center(), sphere->radius(), refinePerEye);
+        if (visibility == StereoFrustum::Culled)
+            continue;
+        ++statistics.visible;
+        statistics.eyeDraws += (visibility & StereoFrustum::LeftEye ? 1 : 0) + (visibility & StereoFrustum::RightEye ? 1 : 0);
+    }
+
+    QMutexLocker lock(&m_mutex);
+    // Dropped if new input arrived meanwhile, it is evaluated next
+    if (m_hasInput)
+        return;
+    m_statistics = statistics;
+    m_hasStatistics = true;
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
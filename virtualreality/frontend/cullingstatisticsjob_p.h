@@ -0,0 +1,79 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#ifndef QT3DVIRTUALREALITY_CULLINGSTATISTICSJOB_P_H
+#define QT3DVIRTUALREALITY_CULLINGSTATISTICSJOB_P_H
+
+#include "stereofrustum_p.h"
+
+#include <Qt3DCore/qaspectjob.h>
+#include <QMutex>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+namespace Render {
+class NodeManagers;
+}
+}
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The CullingStatisticsJob class counts the entities the render aspect submits and how many of them
+ * pass the combined stereo frustum, with the world bounding volumes its FrustumCulling tests.
+ * Runs after the render aspect updated the bounding volumes of the frame, its input is the StereoFrustum
+ * of the previous update of the head mounted display.
+ */
+class CullingStatisticsJob : public Qt3DCore::QAspectJob
+{
+public:
+    struct Statistics {
+        Statistics() : submitted(0), visible(0), eyeDraws(0) {}
+        int submitted; // Enabled entities with an enabled geometry renderer
+        int visible; // Of those, inside the combined frustum
+        int eyeDraws; // Eyes the visible ones are drawn for, fewer than two per entity with the per eye check
+    };
+
+    CullingStatisticsJob();
+
+    void setNodeManagers(Qt3DRender::Render::NodeManagers *managers);
+    /*!
+     * \brief setInput replaces the input not yet evaluated. Can be called from any thread.
+     * \param refinePerEye see StereoFrustum::classify
+     */
+    void setInput(const StereoFrustum &frustum, bool refinePerEye);
+    /*!
+     * \brief takeStatistics of the last input. Can be called from any thread.
+     * \return false if the last input has not been evaluated yet.
+     */
+    bool takeStatistics(Statistics &statistics);
+
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    QMutex m_mutex;
+    Qt3DRender::Render::NodeManagers *m_managers;
+    StereoFrustum m_frustum;
+    bool m_refinePerEye;
+    bool m_hasInput;
+    Statistics m_statistics;
+    bool m_hasStatistics;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_CULLINGSTATISTICSJOB_P_H
@@ -0,0 +1,41 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_JOBTYPES_P_H
+#define QT3DVIRTUALREALITY_JOBTYPES_P_H
+
+#include <QtGlobal>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+namespace JobTypes {
+
+    // Above the job types of the Qt3D aspects
+    enum JobType {
+        QueryTrackedObjects = 16384,
+        UpdateLevelOfDetail,
+        OcclusionCulling,
+        CullingStatistics
+    };
+
+} // JobTypes
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_JOBTYPES_P_H
@@ -0,0 +1,59 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "materialtechnique_p.h"
+
+#include <Qt3DRender/qfilterkey.h>
+#include <Qt3DRender/qgraphicsapifilter.h>
+#include <Qt3DRender/qrenderpass.h>
+#include <Qt3DRender/qshaderprogram.h>
+#include <Qt3DRender/qtechnique.h>
+#include <QUrl>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DRender;
+
+namespace Qt3DVirtualReality {
+
+QTechnique *createTechnique(const QString &renderingStyle, const QUrl &vertexShaderSource, const QUrl &fragmentShaderSource,
+                            const QUrl &geometryShaderSource)
+{
+    QShaderProgram *program = new QShaderProgram;
+    program->setVertexShaderCode(QShaderProgram::loadSource(vertexShaderSource));
+    program->setFragmentShaderCode(QShaderProgram::loadSource(fragmentShaderSource));
+    if (!geometryShaderSource.isEmpty())
+        program->setGeometryShaderCode(QShaderProgram::loadSource(geometryShaderSource));
+
+    QRenderPass *renderPass = new QRenderPass;
+    renderPass->setShaderProgram(program);
+
+    QFilterKey *filterKey = new QFilterKey;
+    filterKey->setName(QStringLiteral("renderingStyle"));
+    filterKey->setValue(renderingStyle);
+
+    QTechnique *technique = new QTechnique;
+    technique->graphicsApiFilter()->setApi(QGraphicsApiFilter::OpenGL);
+    technique->graphicsApiFilter()->setMajorVersion(3);
+    technique->graphicsApiFilter()->setMinorVersion(2);
+    technique->graphicsApiFilter()->setProfile(QGraphicsApiFilter::CoreProfile);
+    technique->addFilterKey(filterKey);
+    technique->addRenderPass(renderPass);
+    return technique;
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
@@ -0,0 +1,69 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_MATERIALTECHNIQUE_P_H
+#define QT3DVIRTUALREALITY_MATERIALTECHNIQUE_P_H
+
+#include <QString>
+#include <QUrl>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+class QTechnique;
+}
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * Values of the "renderingStyle" filter key, selected by the TechniqueFilters of StereoFrameGraph.
+ * Forward techniques are drawn once per eye with the camera of the eye.
+ * StereoInstanced techniques are drawn once for both eyes, with twice the instance count.
+ * Their vertex shader picks the eye from gl_InstanceID and reads its matrices from the
+ * StereoEyes uniform block (QVirtualrealityCamera::stereoUniformBuffer).
+ * StereoLayered techniques are drawn once for both eyes into a QHeadMountedDisplayFormat::EyeTextureArray,
+ * their geometry shader emits every triangle to both layers with gl_Layer, also using StereoEyes.
+ * HiddenArea techniques are drawn before the scene to mask pixels not visible through the lenses,
+ * HiddenAreaLayered is the variant for eye texture arrays.
+ * FoveatedComposite techniques upscale the offscreen eye regions of foveated rendering into the target.
+ * TemporalResolve techniques accumulate the jittered eye textures of temporal upsampling into a history target,
+ * TemporalPresent techniques copy that history into the target.
+ * FarFieldComposite techniques draw the far field of hybrid mono rendering, shared by both eyes, into the target.
+ */
+namespace RenderingStyle {
+inline QString forward() { return QStringLiteral("forward"); }
+inline QString stereoInstanced() { return QStringLiteral("stereoInstanced"); }
+inline QString stereoLayered() { return QStringLiteral("stereoLayered"); }
+inline QString hiddenArea() { return QStringLiteral("hiddenArea"); }
+inline QString hiddenAreaLayered() { return QStringLiteral("hiddenAreaLayered"); }
+inline QString foveatedComposite() { return QStringLiteral("foveatedComposite"); }
+inline QString temporalResolve() { return QStringLiteral("temporalResolve"); }
+inline QString temporalPresent() { return QStringLiteral("temporalPresent"); }
+inline QString farFieldComposite() { return QStringLiteral("farFieldComposite"); }
+}
+
+/*!
+ * \brief createTechnique builds an OpenGL 3.2 core technique with a single render pass.
+ * \param renderingStyle value of the "renderingStyle" filter key
+ * \param geometryShaderSource optional, e.g. for StereoLayered techniques
+ */
+Qt3DRender::QTechnique *createTechnique(const QString &renderingStyle, const QUrl &vertexShaderSource, const QUrl &fragmentShaderSource,
+                                        const QUrl &geometryShaderSource = QUrl());
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_MATERIALTECHNIQUE_P_H
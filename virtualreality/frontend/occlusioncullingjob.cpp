@@ -0,0 +1,216 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#include "occlusioncullingjob_p.h"
+#include "jobtypes_p.h"
+
+#include <Qt3DCore/private/qaspectjob_p.h>
+#include <QtMath>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+namespace {
+
+const float Unoccluded = std::numeric_limits<float>::infinity();
+
+} // anonymous
+
+OcclusionCullingJob::OcclusionCullingJob()
+    : QAspectJob()
+    , m_hasInput(false)
+    , m_hasOcclusion(false)
+{
+    SET_JOB_RUN_STAT_TYPE(this, JobTypes::OcclusionCulling, 0);
+}
+
+void OcclusionCullingJob::setInput(const DepthReadback::Frame &frame, const QVector<Entry> &entries, const QVector<View> &views)
+{
+    QMutexLocker lock(&m_mutex);
+    m_frame = frame;
+    m_entries = entries;
+    m_views = views;
+    m_hasInput = true;
+    m_hasOcclusion = false;
+}
+
+bool OcclusionCullingJob::takeOcclusion(QVector<bool> &occluded)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_hasOcclusion)
+        return false;
+    occluded.swap(m_occluded);
+    m_occluded.clear();
+    m_hasOcclusion = false;
+    return true;
+}
+
+OcclusionCullingJob::Level OcclusionCullingJob::reproject(const DepthReadback::Frame &frame, const View &view)
+{
+    Level level;
+    level.width = frame.size.width();
+    level.height = frame.size.height();
+    level.depth.fill(Unoccluded, level.width * level.height);
+    if (frame.depth.size() < level.width * level.height)
+        return level;
+
+    // Window coordinates of the old frame to the space of the current view
+    const QMatrix4x4 toView = view.viewMatrix * frame.viewProjection.inverted();
+    for (int y = 0; y < level.height; ++y) {
+        for (int x = 0; x < level.width; ++x) {
+            const float depth = frame.depth.at(y * level.width + x);
+            // Still cleared, nothing was drawn there
+            if (view.reverseDepth ? depth <= 0.0f : depth >= 1.0f)
+                continue;
+            const QVector4D ndc((x + 0.5f) * 2.0f / level.width - 1.0f,
+                                (y + 0.5f) * 2.0f / level.height - 1.0f,
+                                view.reverseDepth ? depth : 2.0f * depth - 1.0f,
+                                1.0f);
+            const QVector4D position = toView * ndc;
+            if (qFuzzyIsNull(position.w()))
+                continue;
+            const QVector3D viewPosition = position.toVector3DAffine();
+            const float distance = -viewPosition.z();
+            if (distance <= 0.0f)
+                continue;
+            const QVector4D clip = view.projection * QVector4D(viewPosition, 1.0f);
+            const int targetX = qFloor((clip.x() / clip.w() * 0.5f + 0.5f) * level.width);
+            const int targetY = qFloor((clip.y() / clip.w() * 0.5f + 0.5f) * level.height);
+            if (targetX < 0 || targetX >= level.width || targetY < 0 || targetY >= level.height)
+                continue;
+            float &target = level.depth[targetY * level.width + targetX];
+            target = qMin(target, distance);
+        }
+    }
+    return level;
+}
+
+QVector<OcclusionCullingJob::Level> OcclusionCullingJob::buildPyramid(const Level &base)
+{
+    QVector<Level> pyramid;
+    pyramid.append(base);
+    while (pyramid.last().width > 1 || pyramid.last().height > 1) {
+        const Level &finer = pyramid.last();
+        Level level;
+        level.width = (finer.width + 1) / 2;
+        level.height = (finer.height + 1) / 2;
+        level.depth.resize(level.width * level.height);
+        for (int y = 0; y < level.height; ++y) {
+            // The last column and row of odd sizes are taken twice
+            const int y0 = 2 * y;
+            const int y1 = qMin(y0 + 1, finer.height - 1);
+            for (int x = 0; x < level.width; ++x) {
+                const int x0 = 2 * x;
+                const int x1 = qMin(x0 + 1, finer.width - 1);
+                level.depth[y * level.width + x] = qMax(qMax(finer.depth.at(y0 * finer.width + x0), finer.depth.at(y0 * finer.width + x1)),
+                                                        qMax(finer.depth.at(y1 * finer.width + x0), finer.depth.at(y1 * finer.width + x1)));
+            }
+        }
+        pyramid.append(level);
+    }
+    return pyramid;
+}
+
+bool OcclusionCullingJob::isOccluded(const Entry &entry, const QVector<Level> &pyramid, const View &view)
+{
+    const QVector3D center = view.viewMatrix * entry.center;
+    const float nearest = -center.z() - entry.radius;
+    // The viewer is inside or behind the front of the sphere
+    if (nearest <= 0.0f)
+        return false;
+
+    // Rectangle in texels of the finest level covering the corners of the bounding box of the sphere
+    const Level &base = pyramid.first();
+    float left = std::numeric_limits<float>::max();
+    float bottom = std::numeric_limits<float>::max();
+    float right = -std::numeric_limits<float>::max();
+    float top = -std::numeric_limits<float>::max();
+    for (int i = 0; i < 8; ++i) {
+        const QVector3D corner = center + entry.radius * QVector3D(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f);
+        const QVector4D clip = view.projection * QVector4D(corner, 1.0f);
+        if (clip.w() <= 0.0f)
+            return false;
+        const float x = (clip.x() / clip.w() * 0.5f + 0.5f) * base.width;
+        const float y = (clip.y() / clip.w() * 0.5f + 0.5f) * base.height;
+        left = qMin(left, x);
+        right = qMax(right, x);
+        bottom = qMin(bottom, y);
+        top = qMax(top, y);
+    }
+    // The eyes see slightly beyond the depth, spheres reaching out of it are not tested
+    if (left < 0.0f || bottom < 0.0f || right >= base.width || top >= base.height)
+        return false;
+
+    // Coarsest level where the rectangle covers at most 3x3 texels
+    int levelIndex = 0;
+    float extent = qMax(right - left, top - bottom);
+    while (extent > 2.0f && levelIndex < pyramid.size() - 1) {
+        extent *= 0.5f;
+        ++levelIndex;
+    }
+    const Level &level = pyramid.at(levelIndex);
+    const int x0 = qFloor(left) >> levelIndex;
+    const int x1 = qMin(qFloor(right) >> levelIndex, level.width - 1);
+    const int y0 = qFloor(bottom) >> levelIndex;
+    const int y1 = qMin(qFloor(top) >> levelIndex, level.height - 1);
+    float farthest = 0.0f;
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x)
+            farthest = qMax(farthest, level.depth.at(y * level.width + x));
+    }
+    return nearest > farthest;
+}
+
+void OcclusionCullingJob::run()
+{
+    DepthReadback::Frame frame;
+    QVector<Entry> entries;
+    QVector<View> views;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (!m_hasInput)
+            return;
+        frame = m_frame;
+        entries.swap(m_entries);
+        views = m_views;
+        m_hasInput = false;
+    }
+
+    // Hidden from one eye may still be visible to the other, spheres are culled only when hidden from both
+    QVector<bool> occluded;
+    occluded.fill(!frame.size.isEmpty() && !views.isEmpty(), entries.size());
+    if (!frame.size.isEmpty()) {
+        for (const View &view : qAsConst(views)) {
+            const QVector<Level> pyramid = buildPyramid(reproject(frame, view));
+            for (int i = 0; i < entries.size(); ++i) {
+                if (occluded.at(i))
+                    occluded[i] = isOccluded(entries.at(i), pyramid, view);
+            }
+        }
+    }
+
+    QMutexLocker lock(&m_mutex);
+    // Dropped if new input arrived meanwhile, it is evaluated next
+    if (m_hasInput)
+        return;
+    m_occluded.swap(occluded);
+    m_hasOcclusion = true;
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
@@ -0,0 +1,96 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#ifndef QT3DVIRTUALREALITY_OCCLUSIONCULLINGJOB_P_H
+#define QT3DVIRTUALREALITY_OCCLUSIONCULLINGJOB_P_H
+
+#include "../depthreadback_p.h"
+
+#include <Qt3DCore/qaspectjob.h>
+#include <QMatrix4x4>
+#include <QMutex>
+#include <QVector>
+#include <QVector3D>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The OcclusionCullingJob class tests the bounding spheres of QOcclusionVolume components against
+ * the depth of an earlier frame, in parallel to the other aspect jobs.
+ * The depth is reprojected into the current view of each eye and reduced to a pyramid of the farthest depth per texel.
+ * Each sphere is compared with the few texels of the level its extent covers, it is occluded when hidden from every eye.
+ * The depth is drawn from between the eyes, what only one eye sees behind an occluder is a gap of its reprojection.
+ * Gaps of the reprojection and everything outside the depth occlude nothing, so the test errs towards visible.
+ */
+class OcclusionCullingJob : public Qt3DCore::QAspectJob
+{
+public:
+    struct Entry {
+        QVector3D center; // World space bounding sphere
+        float radius;
+    };
+    struct View {
+        QMatrix4x4 viewMatrix; // Current view of an eye
+        QMatrix4x4 projection;
+        bool reverseDepth; // Depth of the frame ranges 0..1 with near at 1
+    };
+    // Farthest linear depth per texel, infinite where nothing occludes
+    struct Level {
+        QVector<float> depth;
+        int width;
+        int height;
+    };
+
+    OcclusionCullingJob();
+
+    /*!
+     * \brief setInput replaces the input not yet evaluated. Can be called from any thread.
+     */
+    void setInput(const DepthReadback::Frame &frame, const QVector<Entry> &entries, const QVector<View> &views);
+    /*!
+     * \brief takeOcclusion of the last input, one per entry. Can be called from any thread.
+     * \return false if the last input has not been evaluated yet.
+     */
+    bool takeOcclusion(QVector<bool> &occluded);
+
+    /*!
+     * \brief reproject the window depth of \a frame to linear depth along the view axis of \a view.
+     * Texels are moved one by one, the nearest one wins.
+     */
+    static Level reproject(const DepthReadback::Frame &frame, const View &view);
+    /*!
+     * \brief buildPyramid halves \a base down to a single texel, keeping the farthest depth.
+     */
+    static QVector<Level> buildPyramid(const Level &base);
+    static bool isOccluded(const Entry &entry, const QVector<Level> &pyramid, const View &view);
+
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    QMutex m_mutex;
+    DepthReadback::Frame m_frame;
+    QVector<Entry> m_entries;
+    QVector<View> m_views;
+    bool m_hasInput;
+    QVector<bool> m_occluded;
+    bool m_hasOcclusion;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_OCCLUSIONCULLINGJOB_P_H
@@ -0,0 +1,322 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "qcompositorlayer.h"
+#include "qtrackedobjectmaterial.h"
+#include "compositorlayertextureimage_p.h"
+
+#include <Qt3DCore/qtransform.h>
+#include <Qt3DRender/qattribute.h>
+#include <Qt3DRender/qbuffer.h>
+#include <Qt3DRender/qgeometry.h>
+#include <Qt3DRender/qgeometryrenderer.h>
+#include <Qt3DRender/qtexture.h>
+#include <QAtomicInt>
+
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DRender;
+
+namespace Qt3DVirtualReality {
+
+namespace {
+
+// vec3 pos, vec2 tex
+const int VertexSize = 3 + 2;
+const int CylinderSegments = 32;
+
+QAtomicInt nextLayerId;
+
+} // anonymous
+
+/*!
+ * \qmltype CompositorLayer
+ * \instantiates Qt3DVirtualReality::QCompositorLayer
+ * \inqmlmodule vr
+ * \brief A panel with rarely changing content, drawn by the compositor at display resolution.
+ *
+ * \code
+ * CompositorLayer {
+ *     shape: CompositorLayer.Cylinder
+ *     position: Qt.vector3d(0, 1.5, 0)
+ *     size: Qt.size(1.2, 0.6)
+ *     radius: 1.5
+ *     offset: vrCam.offset
+ * }
+ * \endcode
+ *
+ * Assign a new image whenever the content changed, e.g. the result of Item::grabToImage.
+ * Without compositor support it is drawn with the scene (see composited).
+ */
+
+QCompositorLayer::QCompositorLayer(Qt3DCore::QNode *parent)
+    : QEntity(parent)
+    , m_geometryRenderer(new QGeometryRenderer)
+    , m_vertexBuffer(new Qt3DRender::QBuffer(Qt3DRender::QBuffer::VertexBuffer))
+    , m_positionAttribute(new QAttribute)
+    , m_texCoordAttribute(new QAttribute)
+    , m_texture(new QTexture2D(this))
+    , m_textureImage(new CompositorLayerTextureImage(m_texture))
+    , m_transform(new Qt3DCore::QTransform)
+    , m_material(new QTrackedObjectMaterial(this))
+    , m_shape(Quad)
+    , m_size(1.0, 1.0)
+    , m_radius(1.0f)
+    , m_sourceCacheKey(0)
+    , m_composited(false)
+    , m_layerId(nextLayerId.fetchAndAddRelaxed(1))
+    , m_revision(0)
+{
+    QGeometry *geometry = new QGeometry(m_geometryRenderer);
+    m_vertexBuffer->setParent(geometry);
+
+    const quint32 stride = VertexSize * sizeof(float);
+    m_positionAttribute->setName(QAttribute::defaultPositionAttributeName());
+    m_positionAttribute->setVertexBaseType(QAttribute::Float);
+    m_positionAttribute->setVertexSize(3);
+    m_positionAttribute->setAttributeType(QAttribute::VertexAttribute);
+    m_positionAttribute->setBuffer(m_vertexBuffer);
+    m_positionAttribute->setByteStride(stride);
+
+    m_texCoordAttribute->setName(QAttribute::defaultTextureCoordinateAttributeName());
+    m_texCoordAttribute->setVertexBaseType(QAttribute::Float);
+    m_texCoordAttribute->setVertexSize(2);
+    m_texCoordAttribute->setAttributeType(QAttribute::VertexAttribute);
+    m_texCoordAttribute->setBuffer(m_vertexBuffer);
+    m_texCoordAttribute->setByteStride(stride);
+    m_texCoordAttribute->setByteOffset(3 * sizeof(float));
+
+    geometry->addAttribute(m_positionAttribute);
+    geometry->addAttribute(m_texCoordAttribute);
+    m_geometryRenderer->setGeometry(geometry);
+    m_geometryRenderer->setPrimitiveType(QGeometryRenderer::Triangles);
+    // Nothing to draw without an image
+    m_geometryRenderer->setEnabled(false);
+
+    m_texture->setFormat(QAbstractTexture::RGBA8_UNorm);
+    m_texture->setGenerateMipMaps(true);
+    m_texture->setMinificationFilter(QAbstractTexture::LinearMipMapLinear);
+    m_texture->setMagnificationFilter(QAbstractTexture::Linear);
+    m_texture->addTextureImage(m_textureImage);
+    m_material->setDiffuse(m_texture);
+
+    rebuildGeometry();
+
+    addComponent(m_geometryRenderer);
+    addComponent(m_transform);
+    addComponent(m_material);
+}
+
+QCompositorLayer::~QCompositorLayer()
+{
+}
+
+QCompositorLayer::Shape QCompositorLayer::shape() const
+{
+    return m_shape;
+}
+
+QVector3D QCompositorLayer::position() const
+{
+    return m_position;
+}
+
+QQuaternion QCompositorLayer::orientation() const
+{
+    return m_orientation;
+}
+
+QSizeF QCompositorLayer::size() const
+{
+    return m_size;
+}
+
+float QCompositorLayer::radius() const
+{
+    return m_radius;
+}
+
+QImage QCompositorLayer::image() const
+{
+    return m_image;
+}
+
+QVector3D QCompositorLayer::offset() const
+{
+    return m_offset;
+}
+
+/*!
+ * \property QCompositorLayer::composited
+ *
+ * True if the compositor draws the layer. False if it is drawn into the eye textures with the scene.
+ */
+bool QCompositorLayer::composited() const
+{
+    return m_composited;
+}
+
+int QCompositorLayer::layerId() const
+{
+    return m_layerId;
+}
+
+int QCompositorLayer::revision() const
+{
+    return m_revision;
+}
+
+void QCompositorLayer::setComposited(bool composited)
+{
+    if (m_composited == composited)
+        return;
+
+    m_composited = composited;
+    updateEnabled();
+    Q_EMIT compositedChanged(composited);
+}
+
+void QCompositorLayer::setShape(QCompositorLayer::Shape shape)
+{
+    if (m_shape == shape)
+        return;
+
+    m_shape = shape;
+    rebuildGeometry();
+    Q_EMIT shapeChanged(shape);
+}
+
+void QCompositorLayer::setPosition(QVector3D position)
+{
+    if (m_position == position)
+        return;
+
+    m_position = position;
+    updateTransform();
+    Q_EMIT positionChanged(position);
+}
+
+void QCompositorLayer::setOrientation(QQuaternion orientation)
+{
+    if (m_orientation == orientation)
+        return;
+
+    m_orientation = orientation;
+    updateTransform();
+    Q_EMIT orientationChanged(orientation);
+}
+
+void QCompositorLayer::setSize(QSizeF size)
+{
+    if (m_size == size)
+        return;
+
+    m_size = size;
+    rebuildGeometry();
+    Q_EMIT sizeChanged(size);
+}
+
+void QCompositorLayer::setRadius(float radius)
+{
+    if (qFuzzyCompare(m_radius, radius))
+        return;
+
+    m_radius = radius;
+    if (m_shape == Cylinder)
+        rebuildGeometry();
+    Q_EMIT radiusChanged(radius);
+}
+
+void QCompositorLayer::setImage(const QImage &image)
+{
+    if (image.cacheKey() == m_sourceCacheKey)
+        return;
+
+    m_sourceCacheKey = image.cacheKey();
+    // Backends and the fallback texture upload tightly packed rgba8
+    m_image = image.convertToFormat(QImage::Format_RGBA8888);
+    ++m_revision;
+    m_textureImage->setImage(m_image);
+    updateEnabled();
+    Q_EMIT imageChanged();
+}
+
+void QCompositorLayer::setOffset(QVector3D offset)
+{
+    if (m_offset == offset)
+        return;
+
+    m_offset = offset;
+    updateTransform();
+    Q_EMIT offsetChanged(offset);
+}
+
+void QCompositorLayer::rebuildGeometry()
+{
+    const bool cylinder = m_shape == Cylinder && m_radius > 0.0f;
+    const int segments = cylinder ? CylinderSegments : 1;
+    const float width = m_size.width();
+    const float height = m_size.height();
+    const float angle = cylinder ? qMin(width / m_radius, 2.0f * float(M_PI)) : 0.0f;
+
+    QByteArray vertexData;
+    vertexData.resize(segments * 6 * VertexSize * sizeof(float));
+    float *dst = reinterpret_cast<float*>(vertexData.data());
+    auto emitVertex = [&](float u, float v) {
+        if (cylinder) {
+            const float a = (u - 0.5f) * angle;
+            *dst++ = m_radius * std::sin(a);
+            *dst++ = (0.5f - v) * height;
+            *dst++ = -m_radius * std::cos(a);
+        } else {
+            *dst++ = (u - 0.5f) * width;
+            *dst++ = (0.5f - v) * height;
+            *dst++ = 0.0f;
+        }
+        // Top row of the image first, v = 0 is the top
+        *dst++ = u;
+        *dst++ = v;
+    };
+    for (int i = 0; i < segments; ++i) {
+        const float u0 = float(i) / segments;
+        const float u1 = float(i + 1) / segments;
+        emitVertex(u0, 0.0f);
+        emitVertex(u0, 1.0f);
+        emitVertex(u1, 1.0f);
+        emitVertex(u0, 0.0f);
+        emitVertex(u1, 1.0f);
+        emitVertex(u1, 0.0f);
+    }
+    m_positionAttribute->setCount(segments * 6);
+    m_texCoordAttribute->setCount(segments * 6);
+    m_vertexBuffer->setData(vertexData);
+}
+
+void QCompositorLayer::updateTransform()
+{
+    m_transform->setTranslation(m_offset + m_position);
+    m_transform->setRotation(m_orientation);
+}
+
+void QCompositorLayer::updateEnabled()
+{
+    m_geometryRenderer->setEnabled(!m_composited && !m_image.isNull());
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
@@ -0,0 +1,153 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QCOMPOSITORLAYER_H
+#define QCOMPOSITORLAYER_H
+
+#include <qt3dvr_global.h>
+#include <Qt3DCore/QEntity>
+#include <QImage>
+#include <QQuaternion>
+#include <QSizeF>
+#include <QVector3D>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DCore {
+class QTransform;
+}
+
+namespace Qt3DRender {
+class QAttribute;
+class QBuffer;
+class QGeometryRenderer;
+class QTexture2D;
+}
+
+namespace Qt3DVirtualReality {
+
+class QTrackedObjectMaterial;
+class CompositorLayerTextureImage;
+
+/*!
+ * \brief The QCompositorLayer class is a flat or curved panel, e.g. for a menu or hud, with content that rarely changes.
+ * If the backend supports it (QHeadMountedDisplay::compositorLayersSupported), the panel is submitted to the compositor
+ * as an additional layer. It is then sampled at the resolution of the display and costs nothing per frame,
+ * the image is only uploaded when it changed. Otherwise the entity draws itself into the eye textures with the scene.
+ * Position and orientation are in tracking space, like the tracked objects.
+ */
+class QT3DVR_EXPORT QCompositorLayer : public Qt3DCore::QEntity
+{
+    Q_OBJECT
+    Q_PROPERTY(Shape shape READ shape WRITE setShape NOTIFY shapeChanged)
+    Q_PROPERTY(QVector3D position READ position WRITE setPosition NOTIFY positionChanged)
+    Q_PROPERTY(QQuaternion orientation READ orientation WRITE setOrientation NOTIFY orientationChanged)
+    Q_PROPERTY(QSizeF size READ size WRITE setSize NOTIFY sizeChanged)
+    Q_PROPERTY(float radius READ radius WRITE setRadius NOTIFY radiusChanged)
+    Q_PROPERTY(QImage image READ image WRITE setImage NOTIFY imageChanged)
+    Q_PROPERTY(QVector3D offset READ offset WRITE setOffset NOTIFY offsetChanged)
+    Q_PROPERTY(bool composited READ composited NOTIFY compositedChanged)
+public:
+    /*!
+     * \brief The Shape enum
+     * Quad: centered at position, facing +z.
+     * Cylinder: a section of a cylinder with its axis through position, seen from the inside.
+     * The arc is centered on -z, the width is the arc length.
+     */
+    enum Shape {
+        Quad,
+        Cylinder
+    };
+    Q_ENUM(Shape)
+
+    explicit QCompositorLayer(Qt3DCore::QNode *parent = nullptr);
+    ~QCompositorLayer();
+
+    Shape shape() const;
+    QVector3D position() const;
+    QQuaternion orientation() const;
+    QSizeF size() const;
+    float radius() const;
+    QImage image() const;
+    QVector3D offset() const;
+    bool composited() const;
+
+    /*!
+     * \brief layerId is unique for the lifetime of the application.
+     */
+    int layerId() const;
+    /*!
+     * \brief revision changes with every new image.
+     */
+    int revision() const;
+    /*!
+     * \brief setComposited is called by QHeadMountedDisplay. Disables drawing into the eye textures.
+     */
+    void setComposited(bool composited);
+
+public Q_SLOTS:
+    void setShape(Shape shape);
+    void setPosition(QVector3D position);
+    void setOrientation(QQuaternion orientation);
+    void setSize(QSizeF size);
+    void setRadius(float radius);
+    /*!
+     * \brief setImage marks the layer dirty. Converted to rgba8 once.
+     */
+    void setImage(const QImage &image);
+    void setOffset(QVector3D offset);
+
+Q_SIGNALS:
+    void shapeChanged(Shape shape);
+    void positionChanged(QVector3D position);
+    void orientationChanged(QQuaternion orientation);
+    void sizeChanged(QSizeF size);
+    void radiusChanged(float radius);
+    void imageChanged();
+    void offsetChanged(QVector3D offset);
+    void compositedChanged(bool composited);
+
+private:
+    void rebuildGeometry();
+    void updateTransform();
+    void updateEnabled();
+
+    Qt3DRender::QGeometryRenderer *m_geometryRenderer;
+    Qt3DRender::QBuffer *m_vertexBuffer;
+    Qt3DRender::QAttribute *m_positionAttribute;
+    Qt3DRender::QAttribute *m_texCoordAttribute;
+    Qt3DRender::QTexture2D *m_texture;
+    CompositorLayerTextureImage *m_textureImage;
+    Qt3DCore::QTransform *m_transform;
+    QTrackedObjectMaterial *m_material;
+
+    Shape m_shape;
+    QVector3D m_position;
+    QQuaternion m_orientation;
+    QSizeF m_size;
+    float m_radius;
+    QImage m_image;
+    qint64 m_sourceCacheKey;
+    QVector3D m_offset;
+    bool m_composited;
+    int m_layerId;
+    int m_revision;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QCOMPOSITORLAYER_H
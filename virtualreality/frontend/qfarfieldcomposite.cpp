@@ -0,0 +1,145 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+
+
+#include "qfarfieldcomposite.h"
+#include "materialtechnique_p.h"
+
+#include <Qt3DRender/qabstracttexture.h>
+#include <Qt3DRender/qattribute.h>
+#include <Qt3DRender/qbuffer.h>
+#include <Qt3DRender/qeffect.h>
+#include <Qt3DRender/qgeometry.h>
+#include <Qt3DRender/qgeometryrenderer.h>
+#include <Qt3DRender/qmaterial.h>
+#include <Qt3DRender/qparameter.h>
+#include <Qt3DRender/qtechnique.h>
+#include <QUrl>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DRender;
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \qmltype FarFieldComposite
+ * \instantiates Qt3DVirtualReality::QFarFieldComposite
+ * \inqmlmodule vr
+ * \brief Draws the far field texture of the hybrid mono branch of StereoFrameGraph into both eyes.
+ *
+ * Only drawn with HeadMountedDisplay.MultiPassHybridMono. The mappings come from VrCamera.
+ *
+ * \code
+ * FarFieldComposite {
+ *     farField: stereoFrameGraph.farFieldTexture
+ *     leftMapping: vrCam.leftFarFieldMapping
+ *     rightMapping: vrCam.rightFarFieldMapping
+ * }
+ * \endcode
+ */
+
+QFarFieldComposite::QFarFieldComposite(Qt3DCore::QNode *parent)
+    : QEntity(parent)
+    , m_farFieldParameter(new QParameter(QStringLiteral("farField"), QVariant()))
+    , m_leftMappingParameter(new QParameter(QStringLiteral("leftMapping"), QMatrix4x4()))
+    , m_rightMappingParameter(new QParameter(QStringLiteral("rightMapping"), QMatrix4x4()))
+{
+    // Two triangles covering the whole side by side target
+    static const float quad[] = { 0.0f, 0.0f,  1.0f, 0.0f,  1.0f, 1.0f,
+                                  0.0f, 0.0f,  1.0f, 1.0f,  0.0f, 1.0f };
+    QGeometryRenderer *geometryRenderer = new QGeometryRenderer;
+    QGeometry *geometry = new QGeometry(geometryRenderer);
+    Qt3DRender::QBuffer *vertexBuffer = new Qt3DRender::QBuffer(Qt3DRender::QBuffer::VertexBuffer, geometry);
+    vertexBuffer->setData(QByteArray(reinterpret_cast<const char*>(quad), sizeof(quad)));
+
+    QAttribute *positionAttribute = new QAttribute;
+    positionAttribute->setName(QAttribute::defaultPositionAttributeName());
+    positionAttribute->setVertexBaseType(QAttribute::Float);
+    positionAttribute->setVertexSize(2);
+    positionAttribute->setAttributeType(QAttribute::VertexAttribute);
+    positionAttribute->setBuffer(vertexBuffer);
+    positionAttribute->setByteStride(2 * sizeof(float));
+    positionAttribute->setCount(6);
+    geometry->addAttribute(positionAttribute);
+
+    geometryRenderer->setGeometry(geometry);
+    geometryRenderer->setPrimitiveType(QGeometryRenderer::Triangles);
+
+    // The fullscreen vertex shader of the foveated composite also places the quad behind the near field
+    QEffect *effect = new QEffect;
+    effect->addTechnique(createTechnique(RenderingStyle::farFieldComposite(),
+                                         QUrl(QStringLiteral("qrc:/shaders/foveatedcomposite.vert")),
+                                         QUrl(QStringLiteral("qrc:/shaders/farfieldcomposite.frag"))));
+    QMaterial *material = new QMaterial;
+    material->setEffect(effect);
+    material->addParameter(m_farFieldParameter);
+    material->addParameter(m_leftMappingParameter);
+    material->addParameter(m_rightMappingParameter);
+
+    addComponent(geometryRenderer);
+    addComponent(material);
+}
+
+QFarFieldComposite::~QFarFieldComposite()
+{
+}
+
+QAbstractTexture *QFarFieldComposite::farField() const
+{
+    return m_farFieldParameter->value().value<QAbstractTexture*>();
+}
+
+QMatrix4x4 QFarFieldComposite::leftMapping() const
+{
+    return m_leftMappingParameter->value().value<QMatrix4x4>();
+}
+
+QMatrix4x4 QFarFieldComposite::rightMapping() const
+{
+    return m_rightMappingParameter->value().value<QMatrix4x4>();
+}
+
+void QFarFieldComposite::setFarField(QAbstractTexture *farField)
+{
+    if (this->farField() == farField)
+        return;
+
+    m_farFieldParameter->setValue(QVariant::fromValue(farField));
+    Q_EMIT farFieldChanged(farField);
+}
+
+void QFarFieldComposite::setLeftMapping(const QMatrix4x4 &leftMapping)
+{
+    if (this->leftMapping() == leftMapping)
+        return;
+
+    m_leftMappingParameter->setValue(leftMapping);
+    Q_EMIT leftMappingChanged(leftMapping);
+}
+
+void QFarFieldComposite::setRightMapping(const QMatrix4x4 &rightMapping)
+{
+    if (this->rightMapping() == rightMapping)
+        return;
+
+    m_rightMappingParameter->setValue(rightMapping);
+    Q_EMIT rightMappingChanged(rightMapping);
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
@@ -0,0 +1,78 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+
+
+#ifndef QFARFIELDCOMPOSITE_H
+#define QFARFIELDCOMPOSITE_H
+
+#include <qt3dvr_global.h>
+#include <Qt3DCore/QEntity>
+#include <QMatrix4x4>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+class QAbstractTexture;
+class QParameter;
+}
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The QFarFieldComposite class draws the shared far field of hybrid mono rendering into both eyes.
+ * The far field is drawn once by a camera between the eyes. Beyond farFieldDistance the disparity is below
+ * a pixel, so each eye samples it as if it was at infinity. The near field is drawn per eye on top.
+ * Uses the "farFieldComposite" rendering style of StereoFrameGraph.
+ */
+class QT3DVR_EXPORT QFarFieldComposite : public Qt3DCore::QEntity
+{
+    Q_OBJECT
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * farField READ farField WRITE setFarField NOTIFY farFieldChanged)
+    Q_PROPERTY(QMatrix4x4 leftMapping READ leftMapping WRITE setLeftMapping NOTIFY leftMappingChanged)
+    Q_PROPERTY(QMatrix4x4 rightMapping READ rightMapping WRITE setRightMapping NOTIFY rightMappingChanged)
+public:
+    explicit QFarFieldComposite(Qt3DCore::QNode *parent = nullptr);
+    ~QFarFieldComposite();
+
+    Qt3DRender::QAbstractTexture *farField() const;
+    /*!
+     * \brief leftMapping from normalized coordinates of the left eye to the far field texture,
+     * see QVirtualrealityCamera::leftFarFieldMapping.
+     */
+    QMatrix4x4 leftMapping() const;
+    QMatrix4x4 rightMapping() const;
+
+public Q_SLOTS:
+    void setFarField(Qt3DRender::QAbstractTexture *farField);
+    void setLeftMapping(const QMatrix4x4 &leftMapping);
+    void setRightMapping(const QMatrix4x4 &rightMapping);
+
+Q_SIGNALS:
+    void farFieldChanged(Qt3DRender::QAbstractTexture *farField);
+    void leftMappingChanged(const QMatrix4x4 &leftMapping);
+    void rightMappingChanged(const QMatrix4x4 &rightMapping);
+
+private:
+    Qt3DRender::QParameter *m_farFieldParameter;
+    Qt3DRender::QParameter *m_leftMappingParameter;
+    Qt3DRender::QParameter *m_rightMappingParameter;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QFARFIELDCOMPOSITE_H
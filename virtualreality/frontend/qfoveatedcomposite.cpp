@@ -0,0 +1,205 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+
+#include "qfoveatedcomposite.h"
+#include "materialtechnique_p.h"
+
+#include <Qt3DRender/qabstracttexture.h>
+#include <Qt3DRender/qattribute.h>
+#include <Qt3DRender/qbuffer.h>
+#include <Qt3DRender/qeffect.h>
+#include <Qt3DRender/qgeometry.h>
+#include <Qt3DRender/qgeometryrenderer.h>
+#include <Qt3DRender/qmaterial.h>
+#include <Qt3DRender/qparameter.h>
+#include <Qt3DRender/qtechnique.h>
+#include <QUrl>
+#include <QVector4D>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DRender;
+
+namespace Qt3DVirtualReality {
+
+namespace {
+
+QVector4D rectToVector(const QRectF &rect)
+{
+    return QVector4D(rect.x(), rect.y(), rect.width(), rect.height());
+}
+
+} // anonymous
+
+/*!
+ * \qmltype FoveatedComposite
+ * \instantiates Qt3DVirtualReality::QFoveatedComposite
+ * \inqmlmodule vr
+ * \brief Composites the offscreen eye regions of the foveated branch of StereoFrameGraph.
+ *
+ * Only drawn with HeadMountedDisplay.MultiPassFoveated. The rects are those of the
+ * foveation profile of the backend, see HeadMountedDisplay.leftFoveaRect.
+ *
+ * \code
+ * FoveatedComposite {
+ *     leftPeriphery: stereoFrameGraph.leftPeripheryTexture
+ *     leftCenter: stereoFrameGraph.leftCenterTexture
+ *     leftCenterRect: _hmd.leftFoveaRect
+ *     ...
+ * }
+ * \endcode
+ */
+
+QFoveatedComposite::QFoveatedComposite(Qt3DCore::QNode *parent)
+    : QEntity(parent)
+    , m_leftPeripheryParameter(new QParameter(QStringLiteral("leftPeriphery"), QVariant()))
+    , m_rightPeripheryParameter(new QParameter(QStringLiteral("rightPeriphery"), QVariant()))
+    , m_leftCenterParameter(new QParameter(QStringLiteral("leftCenter"), QVariant()))
+    , m_rightCenterParameter(new QParameter(QStringLiteral("rightCenter"), QVariant()))
+    , m_leftCenterRectParameter(new QParameter(QStringLiteral("leftCenterRect"), QVector4D()))
+    , m_rightCenterRectParameter(new QParameter(QStringLiteral("rightCenterRect"), QVector4D()))
+{
+    // Two triangles covering the whole side by side target
+    static const float quad[] = { 0.0f, 0.0f,  1.0f, 0.0f,  1.0f, 1.0f,
+                                  0.0f, 0.0f,  1.0f, 1.0f,  0.0f, 1.0f };
+    QGeometryRenderer *geometryRenderer = new QGeometryRenderer;
+    QGeometry *geometry = new QGeometry(geometryRenderer);
+    Qt3DRender::QBuffer *vertexBuffer = new Qt3DRender::QBuffer(Qt3DRender::QBuffer::VertexBuffer, geometry);
+    vertexBuffer->setData(QByteArray(reinterpret_cast<const char*>(quad), sizeof(quad)));
+
+    QAttribute *positionAttribute = new QAttribute;
+    positionAttribute->setName(QAttribute::defaultPositionAttributeName());
+    positionAttribute->setVertexBaseType(QAttribute::Float);
+    positionAttribute->setVertexSize(2);
+    positionAttribute->setAttributeType(QAttribute::VertexAttribute);
+    positionAttribute->setBuffer(vertexBuffer);
+    positionAttribute->setByteStride(2 * sizeof(float));
+    positionAttribute->setCount(6);
+    geometry->addAttribute(positionAttribute);
+
+    geometryRenderer->setGeometry(geometry);
+    geometryRenderer->setPrimitiveType(QGeometryRenderer::Triangles);
+
+    QEffect *effect = new QEffect;
+    effect->addTechnique(createTechnique(RenderingStyle::foveatedComposite(),
+                                         QUrl(QStringLiteral("qrc:/shaders/foveatedcomposite.vert")),
+                                         QUrl(QStringLiteral("qrc:/shaders/foveatedcomposite.frag"))));
+    QMaterial *material = new QMaterial;
+    material->setEffect(effect);
+    material->addParameter(m_leftPeripheryParameter);
+    material->addParameter(m_rightPeripheryParameter);
+    material->addParameter(m_leftCenterParameter);
+    material->addParameter(m_rightCenterParameter);
+    material->addParameter(m_leftCenterRectParameter);
+    material->addParameter(m_rightCenterRectParameter);
+
+    addComponent(geometryRenderer);
+    addComponent(material);
+}
+
+QFoveatedComposite::~QFoveatedComposite()
+{
+}
+
+QAbstractTexture *QFoveatedComposite::leftPeriphery() const
+{
+    return m_leftPeripheryParameter->value().value<QAbstractTexture*>();
+}
+
+QAbstractTexture *QFoveatedComposite::rightPeriphery() const
+{
+    return m_rightPeripheryParameter->value().value<QAbstractTexture*>();
+}
+
+QAbstractTexture *QFoveatedComposite::leftCenter() const
+{
+    return m_leftCenterParameter->value().value<QAbstractTexture*>();
+}
+
+QAbstractTexture *QFoveatedComposite::rightCenter() const
+{
+    return m_rightCenterParameter->value().value<QAbstractTexture*>();
+}
+
+QRectF QFoveatedComposite::leftCenterRect() const
+{
+    return m_leftCenterRect;
+}
+
+QRectF QFoveatedComposite::rightCenterRect() const
+{
+    return m_rightCenterRect;
+}
+
+void QFoveatedComposite::setLeftPeriphery(QAbstractTexture *leftPeriphery)
+{
+    if (this->leftPeriphery() == leftPeriphery)
+        return;
+
+    m_leftPeripheryParameter->setValue(QVariant::fromValue(leftPeriphery));
+    Q_EMIT leftPeripheryChanged(leftPeriphery);
+}
+
+void QFoveatedComposite::setRightPeriphery(QAbstractTexture *rightPeriphery)
+{
+    if (this->rightPeriphery() == rightPeriphery)
+        return;
+
+    m_rightPeripheryParameter->setValue(QVariant::fromValue(rightPeriphery));
+    Q_EMIT rightPeripheryChanged(rightPeriphery);
+}
+
+void QFoveatedComposite::setLeftCenter(QAbstractTexture *leftCenter)
+{
+    if (this->leftCenter() == leftCenter)
+        return;
+
+    m_leftCenterParameter->setValue(QVariant::fromValue(leftCenter));
+    Q_EMIT leftCenterChanged(leftCenter);
+}
+
+void QFoveatedComposite::setRightCenter(QAbstractTexture *rightCenter)
+{
+    if (this->rightCenter() == rightCenter)
+        return;
+
+    m_rightCenterParameter->setValue(QVariant::fromValue(rightCenter));
+    Q_EMIT rightCenterChanged(rightCenter);
+}
+
+void QFoveatedComposite::setLeftCenterRect(const QRectF &leftCenterRect)
+{
+    if (m_leftCenterRect == leftCenterRect)
+        return;
+
+    m_leftCenterRect = leftCenterRect;
+    m_leftCenterRectParameter->setValue(rectToVector(leftCenterRect));
+    Q_EMIT leftCenterRectChanged(leftCenterRect);
+}
+
+void QFoveatedComposite::setRightCenterRect(const QRectF &rightCenterRect)
+{
+    if (m_rightCenterRect == rightCenterRect)
+        return;
+
+    m_rightCenterRect = rightCenterRect;
+    m_rightCenterRectParameter->setValue(rectToVector(rightCenterRect));
+    Q_EMIT rightCenterRectChanged(rightCenterRect);
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
@@ -0,0 +1,89 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+
+#ifndef QFOVEATEDCOMPOSITE_H
+#define QFOVEATEDCOMPOSITE_H
+
+#include <qt3dvr_global.h>
+#include <Qt3DCore/QEntity>
+#include <QRectF>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+class QAbstractTexture;
+class QParameter;
+}
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The QFoveatedComposite class assembles both eyes of fixed foveated rendering in the render target.
+ * Each eye is upscaled from its reduced resolution periphery texture, the full resolution center texture
+ * is drawn on top with a soft edge. Uses the "foveatedComposite" rendering style of StereoFrameGraph.
+ */
+class QT3DVR_EXPORT QFoveatedComposite : public Qt3DCore::QEntity
+{
+    Q_OBJECT
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * leftPeriphery READ leftPeriphery WRITE setLeftPeriphery NOTIFY leftPeripheryChanged)
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * rightPeriphery READ rightPeriphery WRITE setRightPeriphery NOTIFY rightPeripheryChanged)
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * leftCenter READ leftCenter WRITE setLeftCenter NOTIFY leftCenterChanged)
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * rightCenter READ rightCenter WRITE setRightCenter NOTIFY rightCenterChanged)
+    Q_PROPERTY(QRectF leftCenterRect READ leftCenterRect WRITE setLeftCenterRect NOTIFY leftCenterRectChanged)
+    Q_PROPERTY(QRectF rightCenterRect READ rightCenterRect WRITE setRightCenterRect NOTIFY rightCenterRectChanged)
+public:
+    explicit QFoveatedComposite(Qt3DCore::QNode *parent = nullptr);
+    ~QFoveatedComposite();
+
+    Qt3DRender::QAbstractTexture *leftPeriphery() const;
+    Qt3DRender::QAbstractTexture *rightPeriphery() const;
+    Qt3DRender::QAbstractTexture *leftCenter() const;
+    Qt3DRender::QAbstractTexture *rightCenter() const;
+    QRectF leftCenterRect() const;
+    QRectF rightCenterRect() const;
+
+public Q_SLOTS:
+    void setLeftPeriphery(Qt3DRender::QAbstractTexture *leftPeriphery);
+    void setRightPeriphery(Qt3DRender::QAbstractTexture *rightPeriphery);
+    void setLeftCenter(Qt3DRender::QAbstractTexture *leftCenter);
+    void setRightCenter(Qt3DRender::QAbstractTexture *rightCenter);
+    void setLeftCenterRect(const QRectF &leftCenterRect);
+    void setRightCenterRect(const QRectF &rightCenterRect);
+
+Q_SIGNALS:
+    void leftPeripheryChanged(Qt3DRender::QAbstractTexture *leftPeriphery);
+    void rightPeripheryChanged(Qt3DRender::QAbstractTexture *rightPeriphery);
+    void leftCenterChanged(Qt3DRender::QAbstractTexture *leftCenter);
+    void rightCenterChanged(Qt3DRender::QAbstractTexture *rightCenter);
+    void leftCenterRectChanged(const QRectF &leftCenterRect);
+    void rightCenterRectChanged(const QRectF &rightCenterRect);
+
+private:
+    Qt3DRender::QParameter *m_leftPeripheryParameter;
+    Qt3DRender::QParameter *m_rightPeripheryParameter;
+    Qt3DRender::QParameter *m_leftCenterParameter;
+    Qt3DRender::QParameter *m_rightCenterParameter;
+    Qt3DRender::QParameter *m_leftCenterRectParameter;
+    Qt3DRender::QParameter *m_rightCenterRectParameter;
+    QRectF m_leftCenterRect;
+    QRectF m_rightCenterRect;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QFOVEATEDCOMPOSITE_H
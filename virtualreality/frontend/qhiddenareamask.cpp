@@ -0,0 +1,117 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "qhiddenareamask.h"
+#include "materialtechnique_p.h"
+
+#include <Qt3DRender/qattribute.h>
+#include <Qt3DRender/qbuffer.h>
+#include <Qt3DRender/qeffect.h>
+#include <Qt3DRender/qgeometry.h>
+#include <Qt3DRender/qgeometryrenderer.h>
+#include <Qt3DRender/qmaterial.h>
+#include <Qt3DRender/qtechnique.h>
+#include <qvirtualrealityapibackend.h>
+#include <QUrl>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DRender;
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \qmltype HiddenAreaMask
+ * \instantiates Qt3DVirtualReality::QHiddenAreaMask
+ * \inqmlmodule vr
+ * \brief Skips shading of pixels that are not visible through the lenses.
+ *
+ * Put it anywhere into the scene, StereoFrameGraph draws it before everything else.
+ * Typically 15-20% of the render target are masked.
+ */
+
+QHiddenAreaMask::QHiddenAreaMask(Qt3DCore::QNode *parent)
+    : QEntity(parent)
+    , m_geometryRenderer(new QGeometryRenderer)
+    , m_vertexBuffer(new Qt3DRender::QBuffer(Qt3DRender::QBuffer::VertexBuffer))
+    , m_positionAttribute(new QAttribute)
+    , m_apibackend(nullptr)
+{
+    QGeometry *geometry = new QGeometry(m_geometryRenderer);
+    m_vertexBuffer->setParent(geometry);
+
+    m_positionAttribute->setName(QAttribute::defaultPositionAttributeName());
+    m_positionAttribute->setVertexBaseType(QAttribute::Float);
+    m_positionAttribute->setVertexSize(2);
+    m_positionAttribute->setAttributeType(QAttribute::VertexAttribute);
+    m_positionAttribute->setBuffer(m_vertexBuffer);
+    m_positionAttribute->setByteStride(2 * sizeof(float));
+    geometry->addAttribute(m_positionAttribute);
+
+    m_geometryRenderer->setGeometry(geometry);
+    m_geometryRenderer->setPrimitiveType(QGeometryRenderer::Triangles);
+    m_geometryRenderer->setEnabled(false);
+
+    QEffect *effect = new QEffect;
+    effect->addTechnique(createTechnique(RenderingStyle::hiddenArea(),
+                                         QUrl(QStringLiteral("qrc:/shaders/hiddenarea.vert")),
+                                         QUrl(QStringLiteral("qrc:/shaders/hiddenarea.frag"))));
+    effect->addTechnique(createTechnique(RenderingStyle::hiddenAreaLayered(),
+                                         QUrl(QStringLiteral("qrc:/shaders/hiddenarea.vert")),
+                                         QUrl(QStringLiteral("qrc:/shaders/hiddenarea.frag")),
+                                         QUrl(QStringLiteral("qrc:/shaders/hiddenarea_layered.geom"))));
+    QMaterial *material = new QMaterial;
+    material->setEffect(effect);
+
+    addComponent(m_geometryRenderer);
+    addComponent(material);
+}
+
+QHiddenAreaMask::~QHiddenAreaMask()
+{
+}
+
+void QHiddenAreaMask::setVrApiBackendTmp(QVirtualRealityApiBackend *apibackend)
+{
+    if (m_apibackend == apibackend)
+        return;
+    m_apibackend = apibackend;
+    if (!m_apibackend)
+        return;
+
+    QVector<QVector2D> left;
+    QVector<QVector2D> right;
+    m_apibackend->getHiddenAreaMeshes(left, right);
+
+    // Both eyes side by side in one draw
+    QByteArray vertexData;
+    vertexData.resize((left.size() + right.size()) * 2 * sizeof(float));
+    float *dst = reinterpret_cast<float*>(vertexData.data());
+    for (const QVector2D &vertex : qAsConst(left)) {
+        *dst++ = 0.5f * vertex.x();
+        *dst++ = vertex.y();
+    }
+    for (const QVector2D &vertex : qAsConst(right)) {
+        *dst++ = 0.5f + 0.5f * vertex.x();
+        *dst++ = vertex.y();
+    }
+    m_positionAttribute->setCount(left.size() + right.size());
+    m_vertexBuffer->setData(vertexData);
+    m_geometryRenderer->setEnabled(!vertexData.isEmpty());
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
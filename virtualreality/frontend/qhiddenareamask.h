@@ -0,0 +1,63 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QHIDDENAREAMASK_H
+#define QHIDDENAREAMASK_H
+
+#include <qt3dvr_global.h>
+#include <Qt3DCore/QEntity>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+class QAttribute;
+class QBuffer;
+class QGeometryRenderer;
+}
+
+namespace Qt3DVirtualReality {
+
+class QVirtualRealityApiBackend;
+
+/*!
+ * \brief The QHiddenAreaMask class masks the parts of both eyes that can not be seen through the lenses.
+ * The hidden area meshes of the backend are drawn to the near plane before the scene, so the gpu
+ * rejects all scene fragments there with the early depth test. Uses the "hiddenArea" rendering style
+ * of StereoFrameGraph.
+ */
+class QT3DVR_EXPORT QHiddenAreaMask : public Qt3DCore::QEntity
+{
+    Q_OBJECT
+public:
+    explicit QHiddenAreaMask(Qt3DCore::QNode *parent = nullptr);
+    ~QHiddenAreaMask();
+
+    /*!
+     * \brief setVrApiBackendTmp fetches the meshes of the backend once.
+     */
+    void setVrApiBackendTmp(QVirtualRealityApiBackend *apibackend); //TO DO: temp
+
+private:
+    Qt3DRender::QGeometryRenderer *m_geometryRenderer;
+    Qt3DRender::QBuffer *m_vertexBuffer;
+    Qt3DRender::QAttribute *m_positionAttribute;
+    QVirtualRealityApiBackend *m_apibackend;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QHIDDENAREAMASK_H
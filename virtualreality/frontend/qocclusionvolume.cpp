@@ -0,0 +1,104 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#include "qocclusionvolume.h"
+
+#include <Qt3DCore/QEntity>
+#include <Qt3DRender/QGeometryRenderer>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \qmltype OcclusionVolume
+ * \instantiates Qt3DVirtualReality::QOcclusionVolume
+ * \inqmlmodule vr
+ * \brief Skips drawing the entity while it is hidden behind other geometry.
+ *
+ * \code
+ * Entity {
+ *     OcclusionVolume {
+ *         id: occlusion
+ *         radius: 0.55
+ *     }
+ *     components: [ occlusion, mesh, ... ]
+ * }
+ * \endcode
+ */
+
+QOcclusionVolume::QOcclusionVolume(Qt3DCore::QNode *parent)
+    : QComponent(parent)
+    , m_radius(1.0f)
+    , m_occluded(false)
+{
+}
+
+QOcclusionVolume::~QOcclusionVolume()
+{
+}
+
+QVector3D QOcclusionVolume::center() const
+{
+    return m_center;
+}
+
+float QOcclusionVolume::radius() const
+{
+    return m_radius;
+}
+
+bool QOcclusionVolume::isOccluded() const
+{
+    return m_occluded;
+}
+
+void QOcclusionVolume::setOccluded(bool occluded)
+{
+    if (m_occluded == occluded)
+        return;
+
+    m_occluded = occluded;
+    const QVector<Qt3DCore::QEntity*> entities = this->entities();
+    for (Qt3DCore::QEntity *entity : entities) {
+        const Qt3DCore::QComponentVector components = entity->components();
+        for (Qt3DCore::QComponent *component : components) {
+            if (Qt3DRender::QGeometryRenderer *renderer = qobject_cast<Qt3DRender::QGeometryRenderer*>(component))
+                renderer->setEnabled(!occluded);
+        }
+    }
+    Q_EMIT occludedChanged(occluded);
+}
+
+void QOcclusionVolume::setCenter(const QVector3D &center)
+{
+    if (m_center == center)
+        return;
+
+    m_center = center;
+    Q_EMIT centerChanged(center);
+}
+
+void QOcclusionVolume::setRadius(float radius)
+{
+    if (m_radius == radius)
+        return;
+
+    m_radius = radius;
+    Q_EMIT radiusChanged(radius);
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
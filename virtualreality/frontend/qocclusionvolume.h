@@ -0,0 +1,73 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#ifndef QOCCLUSIONVOLUME_H
+#define QOCCLUSIONVOLUME_H
+
+#include <qt3dvr_global.h>
+#include <Qt3DCore/QComponent>
+#include <QVector3D>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The QOcclusionVolume class lets the head mounted display skip drawing its entity while it is hidden
+ * behind other geometry, see HeadMountedDisplay.occlusionCulling. The bounding sphere is tested against the depth
+ * of an earlier frame by an aspect job, occluded changes are applied one frame later.
+ * While occluded, the geometry renderers of the entity are disabled for both eyes.
+ */
+class QT3DVR_EXPORT QOcclusionVolume : public Qt3DCore::QComponent
+{
+    Q_OBJECT
+    Q_PROPERTY(QVector3D center READ center WRITE setCenter NOTIFY centerChanged)
+    Q_PROPERTY(float radius READ radius WRITE setRadius NOTIFY radiusChanged)
+    Q_PROPERTY(bool occluded READ isOccluded NOTIFY occludedChanged)
+public:
+    explicit QOcclusionVolume(Qt3DCore::QNode *parent = nullptr);
+    ~QOcclusionVolume();
+
+    /*!
+     * \brief center of the bounding sphere in coordinates of the entity. It must enclose the whole entity.
+     */
+    QVector3D center() const;
+    float radius() const;
+    bool isOccluded() const;
+
+    /*!
+     * \brief setOccluded enables or disables the geometry renderers of the entities. Set by the head mounted display.
+     */
+    void setOccluded(bool occluded);
+
+public Q_SLOTS:
+    void setCenter(const QVector3D &center);
+    void setRadius(float radius);
+
+Q_SIGNALS:
+    void centerChanged(const QVector3D &center);
+    void radiusChanged(float radius);
+    void occludedChanged(bool occluded);
+
+private:
+    QVector3D m_center;
+    float m_radius;
+    bool m_occluded;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QOCCLUSIONVOLUME_H
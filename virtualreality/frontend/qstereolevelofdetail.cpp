@@ -0,0 +1,131 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+
+
+#include "qstereolevelofdetail.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \qmltype StereoLevelOfDetail
+ * \instantiates Qt3DVirtualReality::QStereoLevelOfDetail
+ * \inqmlmodule vr
+ * \brief Picks a level of detail from the size of the entity in the eyes.
+ *
+ * \code
+ * Entity {
+ *     StereoLevelOfDetail {
+ *         id: lod
+ *         radius: 0.55
+ *         thresholds: [ 300, 100 ]
+ *     }
+ *     TorusMesh {
+ *         id: mesh
+ *         rings: [ 100, 40, 16 ][ lod.currentIndex ]
+ *     }
+ *     components: [ lod, mesh, ... ]
+ * }
+ * \endcode
+ */
+
+QStereoLevelOfDetail::QStereoLevelOfDetail(Qt3DCore::QNode *parent)
+    : QComponent(parent)
+    , m_radius(1.0f)
+    , m_hysteresis(0.1f)
+    , m_currentIndex(0)
+{
+}
+
+QStereoLevelOfDetail::~QStereoLevelOfDetail()
+{
+}
+
+QVector<qreal> QStereoLevelOfDetail::thresholds() const
+{
+    return m_thresholds;
+}
+
+QVector3D QStereoLevelOfDetail::center() const
+{
+    return m_center;
+}
+
+float QStereoLevelOfDetail::radius() const
+{
+    return m_radius;
+}
+
+float QStereoLevelOfDetail::hysteresis() const
+{
+    return m_hysteresis;
+}
+
+int QStereoLevelOfDetail::currentIndex() const
+{
+    return m_currentIndex;
+}
+
+void QStereoLevelOfDetail::setThresholds(const QVector<qreal> &thresholds)
+{
+    if (m_thresholds == thresholds)
+        return;
+
+    m_thresholds = thresholds;
+    Q_EMIT thresholdsChanged(thresholds);
+}
+
+void QStereoLevelOfDetail::setCenter(const QVector3D &center)
+{
+    if (m_center == center)
+        return;
+
+    m_center = center;
+    Q_EMIT centerChanged(center);
+}
+
+void QStereoLevelOfDetail::setRadius(float radius)
+{
+    if (m_radius == radius)
+        return;
+
+    m_radius = radius;
+    Q_EMIT radiusChanged(radius);
+}
+
+void QStereoLevelOfDetail::setHysteresis(float hysteresis)
+{
+    hysteresis = qBound(0.0f, hysteresis, 0.5f);
+    if (m_hysteresis == hysteresis)
+        return;
+
+    m_hysteresis = hysteresis;
+    Q_EMIT hysteresisChanged(hysteresis);
+}
+
+void QStereoLevelOfDetail::setCurrentIndex(int currentIndex)
+{
+    if (m_currentIndex == currentIndex)
+        return;
+
+    m_currentIndex = currentIndex;
+    Q_EMIT currentIndexChanged(currentIndex);
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
@@ -0,0 +1,90 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+
+
+#ifndef QSTEREOLEVELOFDETAIL_H
+#define QSTEREOLEVELOFDETAIL_H
+
+#include <qt3dvr_global.h>
+#include <Qt3DCore/QComponent>
+#include <QVector>
+#include <QVector3D>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The QStereoLevelOfDetail class selects a level of detail for its entity from the size the entity
+ * appears with in the eyes of the head mounted display. The levels are evaluated by an aspect job in
+ * parallel to rendering, currentIndex changes are applied one frame later.
+ * Bind currentIndex to pick a geometry or to lower the tessellation of a procedural mesh.
+ */
+class QT3DVR_EXPORT QStereoLevelOfDetail : public Qt3DCore::QComponent
+{
+    Q_OBJECT
+    Q_PROPERTY(QVector<qreal> thresholds READ thresholds WRITE setThresholds NOTIFY thresholdsChanged)
+    Q_PROPERTY(QVector3D center READ center WRITE setCenter NOTIFY centerChanged)
+    Q_PROPERTY(float radius READ radius WRITE setRadius NOTIFY radiusChanged)
+    Q_PROPERTY(float hysteresis READ hysteresis WRITE setHysteresis NOTIFY hysteresisChanged)
+    Q_PROPERTY(int currentIndex READ currentIndex WRITE setCurrentIndex NOTIFY currentIndexChanged)
+public:
+    explicit QStereoLevelOfDetail(Qt3DCore::QNode *parent = nullptr);
+    ~QStereoLevelOfDetail();
+
+    /*!
+     * \brief thresholds are the smallest projected diameters in eye pixels of each level, finest level first.
+     * There is one more level than thresholds, used below the last one.
+     */
+    QVector<qreal> thresholds() const;
+    /*!
+     * \brief center of the bounding sphere in coordinates of the entity.
+     */
+    QVector3D center() const;
+    float radius() const;
+    /*!
+     * \brief hysteresis moves the thresholds away from the current level by this fraction. Default 0.1.
+     */
+    float hysteresis() const;
+    int currentIndex() const;
+
+public Q_SLOTS:
+    void setThresholds(const QVector<qreal> &thresholds);
+    void setCenter(const QVector3D &center);
+    void setRadius(float radius);
+    void setHysteresis(float hysteresis);
+    void setCurrentIndex(int currentIndex);
+
+Q_SIGNALS:
+    void thresholdsChanged(const QVector<qreal> &thresholds);
+    void centerChanged(const QVector3D &center);
+    void radiusChanged(float radius);
+    void hysteresisChanged(float hysteresis);
+    void currentIndexChanged(int currentIndex);
+
+private:
+    QVector<qreal> m_thresholds;
+    QVector3D m_center;
+    float m_radius;
+    float m_hysteresis;
+    int m_currentIndex;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QSTEREOLEVELOFDETAIL_H
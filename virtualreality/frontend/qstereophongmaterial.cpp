@@ -0,0 +1,130 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "qstereophongmaterial.h"
+#include "materialtechnique_p.h"
+
+#include <Qt3DRender/qeffect.h>
+#include <Qt3DRender/qparameter.h>
+#include <Qt3DRender/qtechnique.h>
+#include <QUrl>
+#include <QVector3D>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DRender;
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \qmltype StereoPhongMaterial
+ * \instantiates Qt3DVirtualReality::QStereoPhongMaterial
+ * \inqmlmodule vr
+ * \brief Phong material usable with every stereo mode of StereoFrameGraph.
+ *
+ * \code
+ * StereoPhongMaterial {
+ *     diffuse: "red"
+ *     specular: "white"
+ *     shininess: 20.0
+ * }
+ * \endcode
+ */
+
+QStereoPhongMaterial::QStereoPhongMaterial(Qt3DCore::QNode *parent)
+    : QMaterial(parent)
+    , m_ambientParameter(new QParameter(QStringLiteral("ambient"), QColor::fromRgbF(0.05f, 0.05f, 0.05f, 1.0f)))
+    , m_diffuseParameter(new QParameter(QStringLiteral("diffuse"), QColor::fromRgbF(0.7f, 0.7f, 0.7f, 1.0f)))
+    , m_specularParameter(new QParameter(QStringLiteral("specular"), QColor::fromRgbF(0.01f, 0.01f, 0.01f, 1.0f)))
+    , m_shininessParameter(new QParameter(QStringLiteral("shininess"), 150.0f))
+{
+    const QUrl fragmentShaderSource(QStringLiteral("qrc:/shaders/phong.frag"));
+    QEffect *effect = new QEffect;
+    effect->addTechnique(createTechnique(RenderingStyle::forward(), QUrl(QStringLiteral("qrc:/shaders/phong.vert")), fragmentShaderSource));
+    effect->addTechnique(createTechnique(RenderingStyle::stereoInstanced(), QUrl(QStringLiteral("qrc:/shaders/phong_stereo.vert")), fragmentShaderSource));
+    effect->addTechnique(createTechnique(RenderingStyle::stereoLayered(), QUrl(QStringLiteral("qrc:/shaders/phong_layered.vert")), fragmentShaderSource,
+                                         QUrl(QStringLiteral("qrc:/shaders/phong_layered.geom"))));
+    setEffect(effect);
+
+    addParameter(m_ambientParameter);
+    addParameter(m_diffuseParameter);
+    addParameter(m_specularParameter);
+    addParameter(m_shininessParameter);
+    addParameter(new QParameter(QStringLiteral("lightDirection"), QVector3D(-0.3f, -1.0f, -0.5f).normalized()));
+}
+
+QStereoPhongMaterial::~QStereoPhongMaterial()
+{
+}
+
+QColor QStereoPhongMaterial::ambient() const
+{
+    return m_ambientParameter->value().value<QColor>();
+}
+
+QColor QStereoPhongMaterial::diffuse() const
+{
+    return m_diffuseParameter->value().value<QColor>();
+}
+
+QColor QStereoPhongMaterial::specular() const
+{
+    return m_specularParameter->value().value<QColor>();
+}
+
+float QStereoPhongMaterial::shininess() const
+{
+    return m_shininessParameter->value().toFloat();
+}
+
+void QStereoPhongMaterial::setAmbient(const QColor &ambient)
+{
+    if (this->ambient() == ambient)
+        return;
+
+    m_ambientParameter->setValue(ambient);
+    Q_EMIT ambientChanged(ambient);
+}
+
+void QStereoPhongMaterial::setDiffuse(const QColor &diffuse)
+{
+    if (this->diffuse() == diffuse)
+        return;
+
+    m_diffuseParameter->setValue(diffuse);
+    Q_EMIT diffuseChanged(diffuse);
+}
+
+void QStereoPhongMaterial::setSpecular(const QColor &specular)
+{
+    if (this->specular() == specular)
+        return;
+
+    m_specularParameter->setValue(specular);
+    Q_EMIT specularChanged(specular);
+}
+
+void QStereoPhongMaterial::setShininess(float shininess)
+{
+    if (qFuzzyCompare(this->shininess(), shininess))
+        return;
+
+    m_shininessParameter->setValue(shininess);
+    Q_EMIT shininessChanged(shininess);
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
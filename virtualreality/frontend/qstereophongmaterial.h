@@ -0,0 +1,75 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QSTEREOPHONGMATERIAL_H
+#define QSTEREOPHONGMATERIAL_H
+
+#include <qt3dvr_global.h>
+#include <Qt3DRender/qmaterial.h>
+#include <QColor>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+class QParameter;
+}
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The QStereoPhongMaterial class is a phong material with a single directional light
+ * that can also be drawn in single pass instanced stereo (QHeadMountedDisplay::SinglePassInstanced).
+ * Properties follow Qt3DExtras::QPhongMaterial.
+ */
+class QT3DVR_EXPORT QStereoPhongMaterial : public Qt3DRender::QMaterial
+{
+    Q_OBJECT
+    Q_PROPERTY(QColor ambient READ ambient WRITE setAmbient NOTIFY ambientChanged)
+    Q_PROPERTY(QColor diffuse READ diffuse WRITE setDiffuse NOTIFY diffuseChanged)
+    Q_PROPERTY(QColor specular READ specular WRITE setSpecular NOTIFY specularChanged)
+    Q_PROPERTY(float shininess READ shininess WRITE setShininess NOTIFY shininessChanged)
+public:
+    explicit QStereoPhongMaterial(Qt3DCore::QNode *parent = nullptr);
+    ~QStereoPhongMaterial();
+
+    QColor ambient() const;
+    QColor diffuse() const;
+    QColor specular() const;
+    float shininess() const;
+
+public Q_SLOTS:
+    void setAmbient(const QColor &ambient);
+    void setDiffuse(const QColor &diffuse);
+    void setSpecular(const QColor &specular);
+    void setShininess(float shininess);
+
+Q_SIGNALS:
+    void ambientChanged(const QColor &ambient);
+    void diffuseChanged(const QColor &diffuse);
+    void specularChanged(const QColor &specular);
+    void shininessChanged(float shininess);
+
+private:
+    Qt3DRender::QParameter *m_ambientParameter;
+    Qt3DRender::QParameter *m_diffuseParameter;
+    Qt3DRender::QParameter *m_specularParameter;
+    Qt3DRender::QParameter *m_shininessParameter;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QSTEREOPHONGMATERIAL_H
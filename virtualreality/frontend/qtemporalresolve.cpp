@@ -0,0 +1,265 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+
+#include "qtemporalresolve.h"
+#include "materialtechnique_p.h"
+
+#include <Qt3DRender/qabstracttexture.h>
+#include <Qt3DRender/qattribute.h>
+#include <Qt3DRender/qbuffer.h>
+#include <Qt3DRender/qeffect.h>
+#include <Qt3DRender/qgeometry.h>
+#include <Qt3DRender/qgeometryrenderer.h>
+#include <Qt3DRender/qmaterial.h>
+#include <Qt3DRender/qparameter.h>
+#include <Qt3DRender/qtechnique.h>
+#include <QUrl>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DRender;
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \qmltype TemporalResolve
+ * \instantiates Qt3DVirtualReality::QTemporalResolve
+ * \inqmlmodule vr
+ * \brief Accumulates the jittered eye textures of the temporal branch of StereoFrameGraph.
+ *
+ * Only drawn with HeadMountedDisplay.MultiPassTemporal. Jitter and reprojection come from VrCamera,
+ * which also selects which of the two history targets is written.
+ *
+ * \code
+ * TemporalResolve {
+ *     leftCurrent: stereoFrameGraph.leftTemporalTexture
+ *     leftDepth: stereoFrameGraph.leftTemporalDepthTexture
+ *     history: stereoFrameGraph.previousHistoryTexture
+ *     resolved: stereoFrameGraph.currentHistoryTexture
+ *     leftReprojection: vrCam.leftReprojection
+ *     jitter: vrCam.projectionJitter
+ *     ...
+ * }
+ * \endcode
+ */
+
+QTemporalResolve::QTemporalResolve(Qt3DCore::QNode *parent)
+    : QEntity(parent)
+    , m_leftCurrentParameter(new QParameter(QStringLiteral("leftCurrent"), QVariant()))
+    , m_rightCurrentParameter(new QParameter(QStringLiteral("rightCurrent"), QVariant()))
+    , m_leftDepthParameter(new QParameter(QStringLiteral("leftDepth"), QVariant()))
+    , m_rightDepthParameter(new QParameter(QStringLiteral("rightDepth"), QVariant()))
+    , m_historyParameter(new QParameter(QStringLiteral("history"), QVariant()))
+    , m_resolvedParameter(new QParameter(QStringLiteral("resolved"), QVariant()))
+    , m_leftReprojectionParameter(new QParameter(QStringLiteral("leftReprojection"), QMatrix4x4()))
+    , m_rightReprojectionParameter(new QParameter(QStringLiteral("rightReprojection"), QMatrix4x4()))
+    , m_jitterParameter(new QParameter(QStringLiteral("jitter"), QVector2D()))
+    , m_feedbackParameter(new QParameter(QStringLiteral("feedback"), 0.9f))
+{
+    // Two triangles covering the whole side by side target
+    static const float quad[] = { 0.0f, 0.0f,  1.0f, 0.0f,  1.0f, 1.0f,
+                                  0.0f, 0.0f,  1.0f, 1.0f,  0.0f, 1.0f };
+    QGeometryRenderer *geometryRenderer = new QGeometryRenderer;
+    QGeometry *geometry = new QGeometry(geometryRenderer);
+    Qt3DRender::QBuffer *vertexBuffer = new Qt3DRender::QBuffer(Qt3DRender::QBuffer::VertexBuffer, geometry);
+    vertexBuffer->setData(QByteArray(reinterpret_cast<const char*>(quad), sizeof(quad)));
+
+    QAttribute *positionAttribute = new QAttribute;
+    positionAttribute->setName(QAttribute::defaultPositionAttributeName());
+    positionAttribute->setVertexBaseType(QAttribute::Float);
+    positionAttribute->setVertexSize(2);
+    positionAttribute->setAttributeType(QAttribute::VertexAttribute);
+    positionAttribute->setBuffer(vertexBuffer);
+    positionAttribute->setByteStride(2 * sizeof(float));
+    positionAttribute->setCount(6);
+    geometry->addAttribute(positionAttribute);
+
+    geometryRenderer->setGeometry(geometry);
+    geometryRenderer->setPrimitiveType(QGeometryRenderer::Triangles);
+
+    // The fullscreen vertex shader of the foveated composite fits both passes
+    QEffect *effect = new QEffect;
+    effect->addTechnique(createTechnique(RenderingStyle::temporalResolve(),
+                                         QUrl(QStringLiteral("qrc:/shaders/foveatedcomposite.vert")),
+                                         QUrl(QStringLiteral("qrc:/shaders/temporalresolve.frag"))));
+    effect->addTechnique(createTechnique(RenderingStyle::temporalPresent(),
+                                         QUrl(QStringLiteral("qrc:/shaders/foveatedcomposite.vert")),
+                                         QUrl(QStringLiteral("qrc:/shaders/temporalpresent.frag"))));
+    QMaterial *material = new QMaterial;
+    material->setEffect(effect);
+    material->addParameter(m_leftCurrentParameter);
+    material->addParameter(m_rightCurrentParameter);
+    material->addParameter(m_leftDepthParameter);
+    material->addParameter(m_rightDepthParameter);
+    material->addParameter(m_historyParameter);
+    material->addParameter(m_resolvedParameter);
+    material->addParameter(m_leftReprojectionParameter);
+    material->addParameter(m_rightReprojectionParameter);
+    material->addParameter(m_jitterParameter);
+    material->addParameter(m_feedbackParameter);
+
+    addComponent(geometryRenderer);
+    addComponent(material);
+}
+
+QTemporalResolve::~QTemporalResolve()
+{
+}
+
+QAbstractTexture *QTemporalResolve::leftCurrent() const
+{
+    return m_leftCurrentParameter->value().value<QAbstractTexture*>();
+}
+
+QAbstractTexture *QTemporalResolve::rightCurrent() const
+{
+    return m_rightCurrentParameter->value().value<QAbstractTexture*>();
+}
+
+QAbstractTexture *QTemporalResolve::leftDepth() const
+{
+    return m_leftDepthParameter->value().value<QAbstractTexture*>();
+}
+
+QAbstractTexture *QTemporalResolve::rightDepth() const
+{
+    return m_rightDepthParameter->value().value<QAbstractTexture*>();
+}
+
+QAbstractTexture *QTemporalResolve::history() const
+{
+    return m_historyParameter->value().value<QAbstractTexture*>();
+}
+
+QAbstractTexture *QTemporalResolve::resolved() const
+{
+    return m_resolvedParameter->value().value<QAbstractTexture*>();
+}
+
+QMatrix4x4 QTemporalResolve::leftReprojection() const
+{
+    return m_leftReprojectionParameter->value().value<QMatrix4x4>();
+}
+
+QMatrix4x4 QTemporalResolve::rightReprojection() const
+{
+    return m_rightReprojectionParameter->value().value<QMatrix4x4>();
+}
+
+QVector2D QTemporalResolve::jitter() const
+{
+    return m_jitterParameter->value().value<QVector2D>();
+}
+
+float QTemporalResolve::feedback() const
+{
+    return m_feedbackParameter->value().toFloat();
+}
+
+void QTemporalResolve::setLeftCurrent(QAbstractTexture *leftCurrent)
+{
+    if (this->leftCurrent() == leftCurrent)
+        return;
+
+    m_leftCurrentParameter->setValue(QVariant::fromValue(leftCurrent));
+    Q_EMIT leftCurrentChanged(leftCurrent);
+}
+
+void QTemporalResolve::setRightCurrent(QAbstractTexture *rightCurrent)
+{
+    if (this->rightCurrent() == rightCurrent)
+        return;
+
+    m_rightCurrentParameter->setValue(QVariant::fromValue(rightCurrent));
+    Q_EMIT rightCurrentChanged(rightCurrent);
+}
+
+void QTemporalResolve::setLeftDepth(QAbstractTexture *leftDepth)
+{
+    if (this->leftDepth() == leftDepth)
+        return;
+
+    m_leftDepthParameter->setValue(QVariant::fromValue(leftDepth));
+    Q_EMIT leftDepthChanged(leftDepth);
+}
+
+void QTemporalResolve::setRightDepth(QAbstractTexture *rightDepth)
+{
+    if (this->rightDepth() == rightDepth)
+        return;
+
+    m_rightDepthParameter->setValue(QVariant::fromValue(rightDepth));
+    Q_EMIT rightDepthChanged(rightDepth);
+}
+
+void QTemporalResolve::setHistory(QAbstractTexture *history)
+{
+    if (this->history() == history)
+        return;
+
+    m_historyParameter->setValue(QVariant::fromValue(history));
+    Q_EMIT historyChanged(history);
+}
+
+void QTemporalResolve::setResolved(QAbstractTexture *resolved)
+{
+    if (this->resolved() == resolved)
+        return;
+
+    m_resolvedParameter->setValue(QVariant::fromValue(resolved));
+    Q_EMIT resolvedChanged(resolved);
+}
+
+void QTemporalResolve::setLeftReprojection(const QMatrix4x4 &leftReprojection)
+{
+    if (this->leftReprojection() == leftReprojection)
+        return;
+
+    m_leftReprojectionParameter->setValue(leftReprojection);
+    Q_EMIT leftReprojectionChanged(leftReprojection);
+}
+
+void QTemporalResolve::setRightReprojection(const QMatrix4x4 &rightReprojection)
+{
+    if (this->rightReprojection() == rightReprojection)
+        return;
+
+    m_rightReprojectionParameter->setValue(rightReprojection);
+    Q_EMIT rightReprojectionChanged(rightReprojection);
+}
+
+void QTemporalResolve::setJitter(const QVector2D &jitter)
+{
+    if (this->jitter() == jitter)
+        return;
+
+    m_jitterParameter->setValue(jitter);
+    Q_EMIT jitterChanged(jitter);
+}
+
+void QTemporalResolve::setFeedback(float feedback)
+{
+    feedback = qBound(0.0f, feedback, 0.98f);
+    if (qFuzzyCompare(this->feedback(), feedback))
+        return;
+
+    m_feedbackParameter->setValue(feedback);
+    Q_EMIT feedbackChanged(feedback);
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
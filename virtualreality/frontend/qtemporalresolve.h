@@ -0,0 +1,119 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+
+#ifndef QTEMPORALRESOLVE_H
+#define QTEMPORALRESOLVE_H
+
+#include <qt3dvr_global.h>
+#include <Qt3DCore/QEntity>
+#include <QMatrix4x4>
+#include <QVector2D>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+class QAbstractTexture;
+class QParameter;
+}
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The QTemporalResolve class reconstructs both eyes of temporal upsampling at the resolution of the render target.
+ * The jittered, reduced resolution eye textures of the current frame are blended with the history, the result of
+ * the previous frame. The history is reprojected with the depth of the eye and clamped to the colors around the
+ * pixel, so that disoccluded areas do not ghost. Uses the "temporalResolve" rendering style of StereoFrameGraph
+ * to write the new history and "temporalPresent" to copy it into the target.
+ */
+class QT3DVR_EXPORT QTemporalResolve : public Qt3DCore::QEntity
+{
+    Q_OBJECT
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * leftCurrent READ leftCurrent WRITE setLeftCurrent NOTIFY leftCurrentChanged)
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * rightCurrent READ rightCurrent WRITE setRightCurrent NOTIFY rightCurrentChanged)
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * leftDepth READ leftDepth WRITE setLeftDepth NOTIFY leftDepthChanged)
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * rightDepth READ rightDepth WRITE setRightDepth NOTIFY rightDepthChanged)
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * history READ history WRITE setHistory NOTIFY historyChanged)
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * resolved READ resolved WRITE setResolved NOTIFY resolvedChanged)
+    Q_PROPERTY(QMatrix4x4 leftReprojection READ leftReprojection WRITE setLeftReprojection NOTIFY leftReprojectionChanged)
+    Q_PROPERTY(QMatrix4x4 rightReprojection READ rightReprojection WRITE setRightReprojection NOTIFY rightReprojectionChanged)
+    Q_PROPERTY(QVector2D jitter READ jitter WRITE setJitter NOTIFY jitterChanged)
+    Q_PROPERTY(float feedback READ feedback WRITE setFeedback NOTIFY feedbackChanged)
+public:
+    explicit QTemporalResolve(Qt3DCore::QNode *parent = nullptr);
+    ~QTemporalResolve();
+
+    Qt3DRender::QAbstractTexture *leftCurrent() const;
+    Qt3DRender::QAbstractTexture *rightCurrent() const;
+    Qt3DRender::QAbstractTexture *leftDepth() const;
+    Qt3DRender::QAbstractTexture *rightDepth() const;
+    /*!
+     * \brief history is the side by side result of the previous frame, read by "temporalResolve".
+     */
+    Qt3DRender::QAbstractTexture *history() const;
+    /*!
+     * \brief resolved is the side by side result of this frame, copied into the target by "temporalPresent".
+     */
+    Qt3DRender::QAbstractTexture *resolved() const;
+    QMatrix4x4 leftReprojection() const;
+    QMatrix4x4 rightReprojection() const;
+    QVector2D jitter() const;
+    /*!
+     * \brief feedback is the weight of the history, higher is smoother but slower to react. Default 0.9.
+     */
+    float feedback() const;
+
+public Q_SLOTS:
+    void setLeftCurrent(Qt3DRender::QAbstractTexture *leftCurrent);
+    void setRightCurrent(Qt3DRender::QAbstractTexture *rightCurrent);
+    void setLeftDepth(Qt3DRender::QAbstractTexture *leftDepth);
+    void setRightDepth(Qt3DRender::QAbstractTexture *rightDepth);
+    void setHistory(Qt3DRender::QAbstractTexture *history);
+    void setResolved(Qt3DRender::QAbstractTexture *resolved);
+    void setLeftReprojection(const QMatrix4x4 &leftReprojection);
+    void setRightReprojection(const QMatrix4x4 &rightReprojection);
+    void setJitter(const QVector2D &jitter);
+    void setFeedback(float feedback);
+
+Q_SIGNALS:
+    void leftCurrentChanged(Qt3DRender::QAbstractTexture *leftCurrent);
+    void rightCurrentChanged(Qt3DRender::QAbstractTexture *rightCurrent);
+    void leftDepthChanged(Qt3DRender::QAbstractTexture *leftDepth);
+    void rightDepthChanged(Qt3DRender::QAbstractTexture *rightDepth);
+    void historyChanged(Qt3DRender::QAbstractTexture *history);
+    void resolvedChanged(Qt3DRender::QAbstractTexture *resolved);
+    void leftReprojectionChanged(const QMatrix4x4 &leftReprojection);
+    void rightReprojectionChanged(const QMatrix4x4 &rightReprojection);
+    void jitterChanged(const QVector2D &jitter);
+    void feedbackChanged(float feedback);
+
+private:
+    Qt3DRender::QParameter *m_leftCurrentParameter;
+    Qt3DRender::QParameter *m_rightCurrentParameter;
+    Qt3DRender::QParameter *m_leftDepthParameter;
+    Qt3DRender::QParameter *m_rightDepthParameter;
+    Qt3DRender::QParameter *m_historyParameter;
+    Qt3DRender::QParameter *m_resolvedParameter;
+    Qt3DRender::QParameter *m_leftReprojectionParameter;
+    Qt3DRender::QParameter *m_rightReprojectionParameter;
+    Qt3DRender::QParameter *m_jitterParameter;
+    Qt3DRender::QParameter *m_feedbackParameter;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QTEMPORALRESOLVE_H
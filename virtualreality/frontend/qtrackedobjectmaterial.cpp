@@ -0,0 +1,99 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#include "qtrackedobjectmaterial.h"
+#include "materialtechnique_p.h"
+
+#include <Qt3DRender/qabstracttexture.h>
+#include <Qt3DRender/qeffect.h>
+#include <Qt3DRender/qparameter.h>
+#include <Qt3DRender/qtechnique.h>
+#include <QUrl>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DRender;
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \qmltype TrackedObjectMaterial
+ * \instantiates Qt3DVirtualReality::QTrackedObjectMaterial
+ * \inqmlmodule vr
+ * \brief Unlit textured material for tracked objects.
+ *
+ * \code
+ * components: [
+ *     TrackedObjectMesh { id: trackedMesh; trackedObjectId: 1 },
+ *     TrackedObjectMaterial { diffuse: trackedMesh.diffuseTexture }
+ * ]
+ * \endcode
+ */
+
+QTrackedObjectMaterial::QTrackedObjectMaterial(Qt3DCore::QNode *parent)
+    : QMaterial(parent)
+    , m_diffuseParameter(new QParameter(QStringLiteral("diffuseTexture"), QVariant()))
+{
+    init(QUrl(QStringLiteral("qrc:/shaders/trackedobject.vert")),
+         QUrl(QStringLiteral("qrc:/shaders/trackedobject_stereo.vert")),
+         QUrl(QStringLiteral("qrc:/shaders/trackedobject_layered.vert")));
+}
+
+QTrackedObjectMaterial::QTrackedObjectMaterial(const QUrl &vertexShaderSource, const QUrl &stereoVertexShaderSource,
+                                               const QUrl &layeredVertexShaderSource, Qt3DCore::QNode *parent)
+    : QMaterial(parent)
+    , m_diffuseParameter(new QParameter(QStringLiteral("diffuseTexture"), QVariant()))
+{
+    init(vertexShaderSource, stereoVertexShaderSource, layeredVertexShaderSource);
+}
+
+void QTrackedObjectMaterial::init(const QUrl &vertexShaderSource, const QUrl &stereoVertexShaderSource, const QUrl &layeredVertexShaderSource)
+{
+    const QUrl fragmentShaderSource(QStringLiteral("qrc:/shaders/trackedobject.frag"));
+    QEffect *effect = new QEffect;
+    effect->addTechnique(createTechnique(RenderingStyle::forward(), vertexShaderSource, fragmentShaderSource));
+    effect->addTechnique(createTechnique(RenderingStyle::stereoInstanced(), stereoVertexShaderSource, fragmentShaderSource));
+    effect->addTechnique(createTechnique(RenderingStyle::stereoLayered(), layeredVertexShaderSource, fragmentShaderSource,
+                                         QUrl(QStringLiteral("qrc:/shaders/trackedobject_layered.geom"))));
+    setEffect(effect);
+
+    addParameter(m_diffuseParameter);
+}
+
+QTrackedObjectMaterial::~QTrackedObjectMaterial()
+{
+}
+
+/*!
+ * \property QTrackedObjectMaterial::diffuse
+ *
+ * Holds the texture sampled by the material.
+ */
+QAbstractTexture *QTrackedObjectMaterial::diffuse() const
+{
+    return m_diffuseParameter->value().value<QAbstractTexture *>();
+}
+
+void QTrackedObjectMaterial::setDiffuse(QAbstractTexture *diffuse)
+{
+    if (this->diffuse() == diffuse)
+        return;
+
+    m_diffuseParameter->setValue(QVariant::fromValue(diffuse));
+    Q_EMIT diffuseChanged(diffuse);
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
@@ -0,0 +1,66 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#ifndef QTRACKEDOBJECTMATERIAL_H
+#define QTRACKEDOBJECTMATERIAL_H
+
+#include <qt3dvr_global.h>
+#include <Qt3DRender/qmaterial.h>
+
+QT_BEGIN_NAMESPACE
+
+class QUrl;
+
+namespace Qt3DRender {
+class QAbstractTexture;
+class QParameter;
+}
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The QTrackedObjectMaterial class is a lightweight unlit material for tracked objects.
+ * It only samples the diffuse texture, usually QVirtualRealityMesh::diffuseTexture.
+ */
+class QT3DVR_EXPORT QTrackedObjectMaterial : public Qt3DRender::QMaterial
+{
+    Q_OBJECT
+    Q_PROPERTY(Qt3DRender::QAbstractTexture *diffuse READ diffuse WRITE setDiffuse NOTIFY diffuseChanged)
+public:
+    explicit QTrackedObjectMaterial(Qt3DCore::QNode *parent = nullptr);
+    ~QTrackedObjectMaterial();
+
+    Qt3DRender::QAbstractTexture *diffuse() const;
+
+public Q_SLOTS:
+    void setDiffuse(Qt3DRender::QAbstractTexture *diffuse);
+
+Q_SIGNALS:
+    void diffuseChanged(Qt3DRender::QAbstractTexture *diffuse);
+
+private:
+    // Same material with different vertex stages, used by QTrackedObjectsLayer
+    QTrackedObjectMaterial(const QUrl &vertexShaderSource, const QUrl &stereoVertexShaderSource,
+                           const QUrl &layeredVertexShaderSource, Qt3DCore::QNode *parent);
+    void init(const QUrl &vertexShaderSource, const QUrl &stereoVertexShaderSource, const QUrl &layeredVertexShaderSource);
+    friend class QTrackedObjectsLayer;
+
+    Qt3DRender::QParameter *m_diffuseParameter;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QTRACKEDOBJECTMATERIAL_H
@@ -0,0 +1,269 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#include "qtrackedobjectslayer.h"
+#include "qtrackedobjectmaterial.h"
+#include "../meshoptimizer_p.h"
+
+#include <Qt3DCore/qtransform.h>
+#include <Qt3DRender/qattribute.h>
+#include <Qt3DRender/qbuffer.h>
+#include <Qt3DRender/qgeometry.h>
+#include <Qt3DRender/qgeometryrenderer.h>
+#include <Qt3DRender/qparameter.h>
+#include <Qt3DRender/qtexture.h>
+#include <qvirtualrealityapibackend.h>
+#include <QUrl>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DRender;
+
+namespace Qt3DVirtualReality {
+
+namespace {
+
+// Vertices of the backend: vec3 pos, vec3 normal, vec2 tex
+const int SourceVertexSize = 3 + 3 + 2;
+// Layer vertices additionally store the slot of the tracked object
+const int VertexSize = SourceVertexSize + 1;
+const int MatrixSize = 16 * sizeof(float);
+// Vertices are transformed in the shader. Qt3D computes the bounding volume from the raw positions,
+// a degenerate triangle spanning the tracking space keeps frustum culling conservative.
+const float TrackingSpaceExtent = 10.0f;
+
+} // anonymous
+
+/*!
+ * \qmltype TrackedObjectsLayer
+ * \instantiates Qt3DVirtualReality::QTrackedObjectsLayer
+ * \inqmlmodule vr
+ * \brief Draws all tracked objects (controllers, trackers, base stations) at once.
+ *
+ * \code
+ * TrackedObjectsLayer {
+ *     offset: vrCam.offset
+ * }
+ * \endcode
+ *
+ * Poses are applied in the vertex shader, the entity transform only holds the offset.
+ * The bounding volume covers the whole tracking space.
+ */
+
+QTrackedObjectsLayer::QTrackedObjectsLayer(Qt3DCore::QNode *parent)
+    : QEntity(parent)
+    , m_geometryRenderer(new QGeometryRenderer)
+    , m_vertexBuffer(new Qt3DRender::QBuffer(Qt3DRender::QBuffer::VertexBuffer))
+    , m_indexBuffer(new Qt3DRender::QBuffer(Qt3DRender::QBuffer::IndexBuffer))
+    , m_transformBuffer(new Qt3DRender::QBuffer(Qt3DRender::QBuffer::UniformBuffer))
+    , m_positionAttribute(new QAttribute)
+    , m_normalAttribute(new QAttribute)
+    , m_texCoordAttribute(new QAttribute)
+    , m_slotAttribute(new QAttribute)
+    , m_indexAttribute(new QAttribute)
+    , m_texture(new QTexture2D(this))
+    , m_transform(new Qt3DCore::QTransform)
+    , m_material(new QTrackedObjectMaterial(QUrl(QStringLiteral("qrc:/shaders/trackedobjectslayer.vert")),
+                                            QUrl(QStringLiteral("qrc:/shaders/trackedobjectslayer_stereo.vert")),
+                                            QUrl(QStringLiteral("qrc:/shaders/trackedobjectslayer_layered.vert")), this))
+    , m_apibackend(nullptr)
+    , m_transformData(MaxTrackedObjects * MatrixSize, 0)
+{
+    QGeometry *geometry = new QGeometry(m_geometryRenderer);
+    m_vertexBuffer->setParent(geometry);
+    m_indexBuffer->setParent(geometry);
+    m_transformBuffer->setParent(m_material);
+    m_transformBuffer->setUsage(Qt3DRender::QBuffer::StreamDraw);
+
+    const quint32 stride = VertexSize * sizeof(float);
+    m_positionAttribute->setName(QAttribute::defaultPositionAttributeName());
+    m_positionAttribute->setVertexBaseType(QAttribute::Float);
+    m_positionAttribute->setVertexSize(3);
+    m_positionAttribute->setAttributeType(QAttribute::VertexAttribute);
+    m_positionAttribute->setBuffer(m_vertexBuffer);
+    m_positionAttribute->setByteStride(stride);
+
+    m_normalAttribute->setName(QAttribute::defaultNormalAttributeName());
+    m_normalAttribute->setVertexBaseType(QAttribute::Float);
+    m_normalAttribute->setVertexSize(3);
+    m_normalAttribute->setAttributeType(QAttribute::VertexAttribute);
+    m_normalAttribute->setBuffer(m_vertexBuffer);
+    m_normalAttribute->setByteStride(stride);
+    m_normalAttribute->setByteOffset(3 * sizeof(float));
+
+    m_texCoordAttribute->setName(QAttribute::defaultTextureCoordinateAttributeName());
+    m_texCoordAttribute->setVertexBaseType(QAttribute::Float);
+    m_texCoordAttribute->setVertexSize(2);
+    m_texCoordAttribute->setAttributeType(QAttribute::VertexAttribute);
+    m_texCoordAttribute->setBuffer(m_vertexBuffer);
+    m_texCoordAttribute->setByteStride(stride);
+    m_texCoordAttribute->setByteOffset(6 * sizeof(float));
+
+    m_slotAttribute->setName(QStringLiteral("vertexTrackedObjectSlot"));
+    m_slotAttribute->setVertexBaseType(QAttribute::Float);
+    m_slotAttribute->setVertexSize(1);
+    m_slotAttribute->setAttributeType(QAttribute::VertexAttribute);
+    m_slotAttribute->setBuffer(m_vertexBuffer);
+    m_slotAttribute->setByteStride(stride);
+    m_slotAttribute->setByteOffset(8 * sizeof(float));
+
+    m_indexAttribute->setAttributeType(QAttribute::IndexAttribute);
+    m_indexAttribute->setVertexBaseType(QAttribute::UnsignedShort);
+    m_indexAttribute->setBuffer(m_indexBuffer);
+
+    geometry->addAttribute(m_positionAttribute);
+    geometry->addAttribute(m_normalAttribute);
+    geometry->addAttribute(m_texCoordAttribute);
+    geometry->addAttribute(m_slotAttribute);
+    geometry->addAttribute(m_indexAttribute);
+    m_geometryRenderer->setGeometry(geometry);
+    m_geometryRenderer->setPrimitiveType(QGeometryRenderer::Triangles);
+    // Nothing to draw until the first device shows up
+    m_geometryRenderer->setEnabled(false);
+
+    m_texture->setFormat(QAbstractTexture::RGBA8_UNorm);
+    m_texture->setGenerateMipMaps(true);
+    m_texture->setMinificationFilter(QAbstractTexture::LinearMipMapLinear);
+    m_texture->setMagnificationFilter(QAbstractTexture::Linear);
+    m_material->setDiffuse(m_texture);
+    m_material->addParameter(new QParameter(QStringLiteral("TrackedObjectTransforms"), QVariant::fromValue(m_transformBuffer)));
+
+    addComponent(m_geometryRenderer);
+    addComponent(m_transform);
+    addComponent(m_material);
+}
+
+QTrackedObjectsLayer::~QTrackedObjectsLayer()
+{
+}
+
+QVector3D QTrackedObjectsLayer::offset() const
+{
+    return m_offset;
+}
+
+int QTrackedObjectsLayer::trackedObjectCount() const
+{
+    return m_trackedObjects.size();
+}
+
+Qt3DRender::QAbstractTexture *QTrackedObjectsLayer::diffuseTexture() const
+{
+    return m_texture;
+}
+
+void QTrackedObjectsLayer::setVrApiBackendTmp(QVirtualRealityApiBackend *apibackend)
+{
+    m_apibackend = apibackend;
+    if (m_apibackend) {
+        // All tracked objects share the atlas, QHeadMountedDisplay streams its pixels in
+        const QSize size = m_apibackend->getTrackedObjectTextureSize();
+        m_texture->setSize(size.width(), size.height());
+    }
+}
+
+void QTrackedObjectsLayer::update()
+{
+    if (!m_apibackend)
+        return;
+
+    QList<int> trackedObjects = m_apibackend->currentlyTrackedObjects();
+    if (trackedObjects.size() > MaxTrackedObjects)
+        trackedObjects = trackedObjects.mid(0, MaxTrackedObjects);
+
+    bool changed = trackedObjects != m_trackedObjects;
+    for (int slot = 0; !changed && slot < trackedObjects.size(); ++slot)
+        changed = m_apibackend->getTrackedObjectModelRevision(trackedObjects[slot]) != m_revisions[slot];
+    if (changed) {
+        const bool countChanged = trackedObjects.size() != m_trackedObjects.size();
+        m_trackedObjects = trackedObjects;
+        rebuildGeometry();
+        if (countChanged)
+            Q_EMIT trackedObjectCountChanged(m_trackedObjects.size());
+    }
+
+    // Per frame work: one matrix per device, one buffer update for all of them
+    char *data = m_transformData.data();
+    for (int slot = 0; slot < m_trackedObjects.size(); ++slot) {
+        QMatrix4x4 pose;
+        m_apibackend->getTrackedObject(m_trackedObjects[slot], pose);
+        memcpy(data + slot * MatrixSize, pose.constData(), MatrixSize);
+    }
+    m_transformBuffer->setData(m_transformData);
+}
+
+void QTrackedObjectsLayer::rebuildGeometry()
+{
+    QByteArray vertexData;
+    QVector<int> indices;
+    m_revisions.resize(m_trackedObjects.size());
+    int vertexCount = 0;
+    for (int slot = 0; slot < m_trackedObjects.size(); ++slot) {
+        QVector<float> vertices;
+        QVector<int> modelIndices;
+        // Revision first, a model changing in between is picked up next frame
+        m_revisions[slot] = m_apibackend->getTrackedObjectModelRevision(m_trackedObjects[slot]);
+        m_apibackend->getTrackedObjectModel(m_trackedObjects[slot], vertices, modelIndices);
+
+        const int modelVertexCount = vertices.size() / SourceVertexSize;
+        vertexData.resize((vertexCount + modelVertexCount) * VertexSize * sizeof(float));
+        float *dst = reinterpret_cast<float*>(vertexData.data()) + vertexCount * VertexSize;
+        for (int v = 0; v < modelVertexCount; ++v, dst += VertexSize) {
+            memcpy(dst, vertices.constData() + v * SourceVertexSize, SourceVertexSize * sizeof(float));
+            dst[SourceVertexSize] = slot;
+        }
+        indices.reserve(indices.size() + modelIndices.size());
+        for (int i = 0; i < modelIndices.size(); ++i)
+            indices.append(vertexCount + modelIndices[i]);
+        vertexCount += modelVertexCount;
+    }
+    if (!indices.isEmpty()) {
+        vertexData.resize((vertexCount + 2) * VertexSize * sizeof(float));
+        float *bounds = reinterpret_cast<float*>(vertexData.data()) + vertexCount * VertexSize;
+        memset(bounds, 0, 2 * VertexSize * sizeof(float));
+        for (int i = 0; i < 3; ++i) {
+            bounds[i] = -TrackingSpaceExtent;
+            bounds[VertexSize + i] = TrackingSpaceExtent;
+        }
+        indices << vertexCount << vertexCount << vertexCount + 1;
+        vertexCount += 2;
+    }
+
+    const bool shortIndices = MeshOptimizer::canUseShortIndices(vertexCount);
+    m_positionAttribute->setCount(vertexCount);
+    m_normalAttribute->setCount(vertexCount);
+    m_texCoordAttribute->setCount(vertexCount);
+    m_slotAttribute->setCount(vertexCount);
+    m_indexAttribute->setVertexBaseType(shortIndices ? QAttribute::UnsignedShort : QAttribute::UnsignedInt);
+    m_indexAttribute->setCount(indices.size());
+    m_vertexBuffer->setData(vertexData);
+    m_indexBuffer->setData(MeshOptimizer::packIndices(indices, shortIndices));
+    m_geometryRenderer->setEnabled(!indices.isEmpty());
+}
+
+void QTrackedObjectsLayer::setOffset(QVector3D offset)
+{
+    if (m_offset == offset)
+        return;
+
+    m_offset = offset;
+    m_transform->setTranslation(offset);
+    Q_EMIT offsetChanged(offset);
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
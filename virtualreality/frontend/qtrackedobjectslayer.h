@@ -0,0 +1,108 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#ifndef QTRACKEDOBJECTSLAYER_H
+#define QTRACKEDOBJECTSLAYER_H
+
+#include <qt3dvr_global.h>
+#include <Qt3DCore/QEntity>
+#include <QVector3D>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DCore {
+class QTransform;
+}
+
+namespace Qt3DRender {
+class QAbstractTexture;
+class QAttribute;
+class QBuffer;
+class QGeometryRenderer;
+class QTexture2D;
+}
+
+namespace Qt3DVirtualReality {
+
+class QVirtualRealityApiBackend;
+class QTrackedObjectMaterial;
+
+/*!
+ * \brief The QTrackedObjectsLayer class draws all tracked objects with a single draw call.
+ * The models of all connected devices are merged into one geometry. Every vertex knows the slot of its
+ * device, the vertex shader picks the transform of the slot from a uniform buffer. Per frame only the
+ * transform buffer is refilled from the current poses. The geometry is rebuilt only when devices connect,
+ * disconnect or their model changes.
+ */
+class QT3DVR_EXPORT QTrackedObjectsLayer : public Qt3DCore::QEntity
+{
+    Q_OBJECT
+    Q_PROPERTY(QVector3D offset READ offset WRITE setOffset NOTIFY offsetChanged)
+    Q_PROPERTY(int trackedObjectCount READ trackedObjectCount NOTIFY trackedObjectCountChanged)
+public:
+    enum {
+        MaxTrackedObjects = 64 // Must match the shader
+    };
+
+    explicit QTrackedObjectsLayer(Qt3DCore::QNode *parent = nullptr);
+    ~QTrackedObjectsLayer();
+
+    QVector3D offset() const;
+    int trackedObjectCount() const;
+    /*!
+     * \brief diffuseTexture shared by all tracked objects, the backend streams it in.
+     */
+    Qt3DRender::QAbstractTexture *diffuseTexture() const;
+
+    void setVrApiBackendTmp(QVirtualRealityApiBackend *apibackend); //TO DO: temp
+    /*!
+     * \brief update transforms from the current pose snapshot. Called once per frame.
+     */
+    void update();
+
+public Q_SLOTS:
+    void setOffset(QVector3D offset);
+
+Q_SIGNALS:
+    void offsetChanged(QVector3D offset);
+    void trackedObjectCountChanged(int trackedObjectCount);
+
+private:
+    void rebuildGeometry();
+
+    Qt3DRender::QGeometryRenderer *m_geometryRenderer;
+    Qt3DRender::QBuffer *m_vertexBuffer;
+    Qt3DRender::QBuffer *m_indexBuffer;
+    Qt3DRender::QBuffer *m_transformBuffer;
+    Qt3DRender::QAttribute *m_positionAttribute;
+    Qt3DRender::QAttribute *m_normalAttribute;
+    Qt3DRender::QAttribute *m_texCoordAttribute;
+    Qt3DRender::QAttribute *m_slotAttribute;
+    Qt3DRender::QAttribute *m_indexAttribute;
+    Qt3DRender::QTexture2D *m_texture;
+    Qt3DCore::QTransform *m_transform;
+    QTrackedObjectMaterial *m_material;
+
+    QVirtualRealityApiBackend *m_apibackend;
+    QVector3D m_offset;
+    QList<int> m_trackedObjects; // Index is the slot
+    QVector<int> m_revisions;
+    QByteArray m_transformData;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QTRACKEDOBJECTSLAYER_H
@@ -13,6 +13,7 @@
 //****************************************************************************/
 
 #include "querytrackedobjectsjob_p.h"
+#include "jobtypes_p.h"
 
 #include <Qt3DCore/private/qaspectjob_p.h>
 
@@ -22,14 +23,6 @@ QT_BEGIN_NAMESPACE
 
 namespace Qt3DVirtualReality {
 
-namespace JobTypes {
-
-    enum JobType {
-        QueryTrackedObjects = 16384
-    };
-
-} // JobTypes
-
 QueryTrackedObjectsJob::QueryTrackedObjectsJob()
     : QAspectJob()
     , m_apibackend(nullptr)
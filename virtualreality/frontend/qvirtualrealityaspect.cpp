@@ -15,6 +15,9 @@
 #include "qvirtualrealityaspect.h"
 #include "qvirtualrealityaspect_p.h"
 #include "querytrackedobjectsjob_p.h"
+#include <Qt3DRender/qrenderaspect.h>
+#include <Qt3DRender/private/qrenderaspect_p.h>
+#include <Qt3DRender/private/renderer_p.h>
 
 using namespace Qt3DCore;
 
@@ -25,6 +28,9 @@ QVirtualRealityAspectPrivate::QVirtualRealityAspectPrivate()
     , m_time(0)
     , m_initialized(false)
     , m_queryTrackedObjectsJob(new Qt3DVirtualReality::QueryTrackedObjectsJob)
+    , m_updateLevelOfDetailJob(new Qt3DVirtualReality::UpdateLevelOfDetailJob)
+    , m_occlusionCullingJob(new Qt3DVirtualReality::OcclusionCullingJob)
+    , m_cullingStatisticsJob(new Qt3DVirtualReality::CullingStatisticsJob)
     , m_hmd(nullptr)
     , m_apibackend(nullptr)
 {
@@ -73,11 +79,43 @@ void QVirtualRealityAspect::setVirtualRealityApiBackend(QVirtualRealityApiBacken
     d->m_queryTrackedObjectsJob->setVirtualRealityApiBackend(d->m_apibackend);
 }
 
+void QVirtualRealityAspect::setRenderAspect(Qt3DRender::QRenderAspect *renderAspect)
+{
+    Q_D(QVirtualRealityAspect);
+    Qt3DRender::QRenderAspectPrivate *renderAspectPrivate = static_cast<Qt3DRender::QRenderAspectPrivate*>(Qt3DRender::QRenderAspectPrivate::get(renderAspect));
+    Qt3DRender::Render::Renderer *renderer = static_cast<Qt3DRender::Render::Renderer*>(renderAspectPrivate->m_renderer);
+    d->m_cullingStatisticsJob->setNodeManagers(renderAspectPrivate->m_nodeManagers);
+    // World bounding volumes of the frame
+    d->m_cullingStatisticsJob->addDependency(renderer->updateWorldBoundingVolumeJob());
+}
+
+UpdateLevelOfDetailJob *QVirtualRealityAspect::levelOfDetailJob() const
+{
+    Q_D(const QVirtualRealityAspect);
+    return d->m_updateLevelOfDetailJob.data();
+}
+
+OcclusionCullingJob *QVirtualRealityAspect::occlusionCullingJob() const
+{
+    Q_D(const QVirtualRealityAspect);
+    return d->m_occlusionCullingJob.data();
+}
+
+CullingStatisticsJob *QVirtualRealityAspect::cullingStatisticsJob() const
+{
+    Q_D(const QVirtualRealityAspect);
+    return d->m_cullingStatisticsJob.data();
+}
+
 QVector<Qt3DCore::QAspectJobPtr> QVirtualRealityAspect::jobsToExecute(qint64 time)
 {
     Q_D(QVirtualRealityAspect);
     QVector<Qt3DCore::QAspectJobPtr> jobs;
     jobs.append(d->m_queryTrackedObjectsJob);
+    // Independent of the other jobs, runs in parallel
+    jobs.append(d->m_updateLevelOfDetailJob);
+    jobs.append(d->m_occlusionCullingJob);
+    jobs.append(d->m_cullingStatisticsJob);
     return jobs;
 }
 
@@ -30,6 +30,9 @@ class QVirtualRealityAspectPrivate;
 class QHeadMountedDisplay;
 //class QVirtualRealityApi;
 class QVirtualRealityApiBackend;
+class UpdateLevelOfDetailJob;
+class OcclusionCullingJob;
+class CullingStatisticsJob;
 
 //TO DO: might needs access to RenderAspect. UpdateWorldTransformJob must depend on QueryTrackedObjectsJob
 
@@ -43,6 +46,22 @@ public:
     void setHeadmountedDisplay(QHeadMountedDisplay *hmd);
     //void setVirtualRealityApi(QVirtualRealityApi *api);
     void setVirtualRealityApiBackend(QVirtualRealityApiBackend *apiBackend);
+    /*!
+     * \brief setRenderAspect lets jobs read the backend nodes of \a renderAspect, after its jobs of the frame that they need.
+     */
+    void setRenderAspect(Qt3DRender::QRenderAspect *renderAspect);
+    /*!
+     * \brief levelOfDetailJob evaluates the QStereoLevelOfDetail snapshots of the head mounted display each frame.
+     */
+    UpdateLevelOfDetailJob *levelOfDetailJob() const;
+    /*!
+     * \brief occlusionCullingJob tests the QOcclusionVolume snapshots of the head mounted display against read back depth.
+     */
+    OcclusionCullingJob *occlusionCullingJob() const;
+    /*!
+     * \brief cullingStatisticsJob counts the entities passing the combined stereo frustum, see setRenderAspect.
+     */
+    CullingStatisticsJob *cullingStatisticsJob() const;
 private:
     QVariant executeCommand(const QStringList &args) Q_DECL_OVERRIDE;
     QVector<Qt3DCore::QAspectJobPtr> jobsToExecute(qint64 time) Q_DECL_OVERRIDE;
@@ -19,6 +19,9 @@
 #include <Qt3DCore/private/qabstractaspect_p.h>
 #include <QtCore/qsharedpointer.h>
 #include "querytrackedobjectsjob_p.h"
+#include "updatelevelofdetailjob_p.h"
+#include "occlusioncullingjob_p.h"
+#include "cullingstatisticsjob_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -40,6 +43,9 @@ class QVirtualRealityAspectPrivate : public Qt3DCore::QAbstractAspectPrivate
     qint64 m_time;
     bool m_initialized;
     QSharedPointer<QueryTrackedObjectsJob> m_queryTrackedObjectsJob;
+    QSharedPointer<UpdateLevelOfDetailJob> m_updateLevelOfDetailJob;
+    QSharedPointer<OcclusionCullingJob> m_occlusionCullingJob;
+    QSharedPointer<CullingStatisticsJob> m_cullingStatisticsJob;
 
 
     QHeadMountedDisplay *m_hmd;
@@ -13,16 +13,76 @@
 //****************************************************************************/
 
 #include "qvirtualrealitycamera.h"
+#include "../foveation_p.h"
 #include <Qt3DCore/QTransform>
 #include <QMatrix>
 #include <QVector4D>
+#include <QDebug>
 
 #include <qqml.h>
 
+#include <cstring>
+
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DVirtualReality {
 
+namespace {
+
+// std140: mat4 eyeViewProjection[2]; vec4 eyePosition[2];
+const int StereoMatrixSize = 16 * sizeof(float);
+const int StereoVectorSize = 4 * sizeof(float);
+const int StereoUniformSize = 2 * StereoMatrixSize + 2 * StereoVectorSize;
+
+// Jitter pattern repeats after this many frames
+const int JitterSampleCount = 8;
+
+// Low discrepancy sequence, the jitter covers a pixel evenly within a few frames
+float halton(int index, int base)
+{
+    float result = 0.0f;
+    float fraction = 1.0f / base;
+    for (int i = index; i > 0; i /= base) {
+        result += fraction * (i % base);
+        fraction /= base;
+    }
+    return result;
+}
+
+// OpenGL projection of an eye. Reverse depth maps near to 1 and far to 0, for a depth range of 0..1.
+// A far plane not beyond near is infinitely far away.
+QMatrix4x4 eyeProjection(const QVirtualRealityApiBackend::ProjectionTangents &tangents,
+                         float nearPlane, float farPlane, bool reverseDepth)
+{
+    const float width = tangents.right - tangents.left;
+    const float height = tangents.top - tangents.bottom;
+    const bool infinite = farPlane <= nearPlane;
+    float p22;
+    float p23;
+    if (reverseDepth) {
+        p22 = infinite ? 0.0f : nearPlane / (farPlane - nearPlane);
+        p23 = infinite ? nearPlane : farPlane * nearPlane / (farPlane - nearPlane);
+    } else {
+        p22 = infinite ? -1.0f : -(farPlane + nearPlane) / (farPlane - nearPlane);
+        p23 = infinite ? -2.0f * nearPlane : -2.0f * farPlane * nearPlane / (farPlane - nearPlane);
+    }
+    return QMatrix4x4(2.0f / width, 0.0f, (tangents.right + tangents.left) / width, 0.0f,
+                      0.0f, 2.0f / height, (tangents.top + tangents.bottom) / height, 0.0f,
+                      0.0f, 0.0f, p22, p23,
+                      0.0f, 0.0f, -1.0f, 0.0f);
+}
+
+// Maps normalized coordinates of a view to directions in its space, x and y at distance 1 in front
+QMatrix4x4 coordinatesToDirections(const QVirtualRealityApiBackend::ProjectionTangents &tangents)
+{
+    return QMatrix4x4(tangents.right - tangents.left, 0.0f, tangents.left, 0.0f,
+                      0.0f, tangents.top - tangents.bottom, tangents.bottom, 0.0f,
+                      0.0f, 0.0f, -1.0f, 0.0f,
+                      0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+} // anonymous
+
 QVirtualrealityCamera::QVirtualrealityCamera(QNode *parent)
     :m_leftCamera(new Qt3DCore::QEntity(parent)),
      m_rightCamera(new Qt3DCore::QEntity(parent)), // TODO: Delete?
@@ -30,12 +90,60 @@ QVirtualrealityCamera::QVirtualrealityCamera(QNode *parent)
      m_rightCameraLens(new Qt3DRender::QCameraLens(parent)),//m_rightCamera)),
      m_leftTransform(new Qt3DCore::QTransform(parent)),//m_leftCamera)),
      m_rightTransform(new Qt3DCore::QTransform(parent)),//m_rightCamera)),
-     m_apibackend(nullptr)
+     m_stereoCameraLens(new Qt3DRender::QCameraLens(parent)),
+     m_stereoTransform(new Qt3DCore::QTransform(parent)),
+     m_stereoCamera(new Qt3DCore::QEntity(parent)),
+     m_leftFoveaCameraLens(new Qt3DRender::QCameraLens(parent)),
+     m_rightFoveaCameraLens(new Qt3DRender::QCameraLens(parent)),
+     m_leftFoveaTransform(new Qt3DCore::QTransform(parent)),
+     m_rightFoveaTransform(new Qt3DCore::QTransform(parent)),
+     m_leftFoveaCamera(new Qt3DCore::QEntity(parent)),
+     m_rightFoveaCamera(new Qt3DCore::QEntity(parent)),
+     m_farFieldCameraLens(new Qt3DRender::QCameraLens(parent)),
+     m_farFieldTransform(new Qt3DCore::QTransform(parent)),
+     m_farFieldCamera(new Qt3DCore::QEntity(parent)),
+     m_leftNearFieldCameraLens(new Qt3DRender::QCameraLens(parent)),
+     m_rightNearFieldCameraLens(new Qt3DRender::QCameraLens(parent)),
+     m_leftNearFieldTransform(new Qt3DCore::QTransform(parent)),
+     m_rightNearFieldTransform(new Qt3DCore::QTransform(parent)),
+     m_leftNearFieldCamera(new Qt3DCore::QEntity(parent)),
+     m_rightNearFieldCamera(new Qt3DCore::QEntity(parent)),
+     m_occlusionCameraLens(new Qt3DRender::QCameraLens(parent)),
+     m_occlusionTransform(new Qt3DCore::QTransform(parent)),
+     m_occlusionCamera(new Qt3DCore::QEntity(parent)),
+     m_perEyeCulling(false),
+     m_apibackend(nullptr),
+     m_stereoUniformBuffer(new Qt3DRender::QBuffer(Qt3DRender::QBuffer::UniformBuffer, this)),
+     m_stereoUniformData(StereoUniformSize, 0),
+     m_jitterIndex(0),
+     m_previousViewProjectionValid(false),
+     m_hasTangents(false),
+     m_nearPlane(EyeNearClip),
+     m_farPlane(0.0f),
+     m_reverseDepth(false),
+     m_farFieldDistance(40.0f),
+     m_farFieldMargin(0.0f)
 {
+    m_stereoUniformBuffer->setUsage(Qt3DRender::QBuffer::StreamDraw);
+
     m_leftCamera->addComponent(m_leftCameraLens);
     m_rightCamera->addComponent(m_rightCameraLens);
     m_leftCamera->addComponent(m_leftTransform);
     m_rightCamera->addComponent(m_rightTransform);
+    m_stereoCamera->addComponent(m_stereoCameraLens);
+    m_stereoCamera->addComponent(m_stereoTransform);
+    m_leftFoveaCamera->addComponent(m_leftFoveaCameraLens);
+    m_leftFoveaCamera->addComponent(m_leftFoveaTransform);
+    m_rightFoveaCamera->addComponent(m_rightFoveaCameraLens);
+    m_rightFoveaCamera->addComponent(m_rightFoveaTransform);
+    m_farFieldCamera->addComponent(m_farFieldCameraLens);
+    m_farFieldCamera->addComponent(m_farFieldTransform);
+    m_leftNearFieldCamera->addComponent(m_leftNearFieldCameraLens);
+    m_leftNearFieldCamera->addComponent(m_leftNearFieldTransform);
+    m_rightNearFieldCamera->addComponent(m_rightNearFieldCameraLens);
+    m_rightNearFieldCamera->addComponent(m_rightNearFieldTransform);
+    m_occlusionCamera->addComponent(m_occlusionCameraLens);
+    m_occlusionCamera->addComponent(m_occlusionTransform);
 
 //    m_leftCamera->setAspectRatio(9.0/16.0);
 //    m_rightCamera->setAspectRatio(9.0/16.0);
@@ -62,12 +170,182 @@ Qt3DCore::QEntity *QVirtualrealityCamera::rightCamera()
     return m_rightCamera;
 }
 
-void QVirtualrealityCamera::setProjections(const QMatrix4x4 &leftProjection, const QMatrix4x4 &rightProjection)
+Qt3DCore::QEntity *QVirtualrealityCamera::stereoCamera()
+{
+    return m_stereoCamera;
+}
+
+Qt3DCore::QEntity *QVirtualrealityCamera::leftFoveaCamera()
+{
+    return m_leftFoveaCamera;
+}
+
+Qt3DCore::QEntity *QVirtualrealityCamera::rightFoveaCamera()
+{
+    return m_rightFoveaCamera;
+}
+
+Qt3DCore::QEntity *QVirtualrealityCamera::farFieldCamera()
+{
+    return m_farFieldCamera;
+}
+
+Qt3DCore::QEntity *QVirtualrealityCamera::leftNearFieldCamera()
+{
+    return m_leftNearFieldCamera;
+}
+
+Qt3DCore::QEntity *QVirtualrealityCamera::rightNearFieldCamera()
+{
+    return m_rightNearFieldCamera;
+}
+
+Qt3DCore::QEntity *QVirtualrealityCamera::occlusionCamera()
+{
+    return m_occlusionCamera;
+}
+
+QMatrix4x4 QVirtualrealityCamera::occlusionProjection() const
+{
+    return m_occlusionProjection;
+}
+
+QMatrix4x4 QVirtualrealityCamera::occlusionViewMatrix() const
 {
-    m_leftCameraLens->setProjectionMatrix(leftProjection);
-    m_rightCameraLens->setProjectionMatrix(rightProjection);
+    return m_occlusionTransform->matrix().inverted();
+}
+
+QMatrix4x4 QVirtualrealityCamera::leftViewMatrix() const
+{
+    return m_leftTransform->matrix().inverted();
+}
+
+QMatrix4x4 QVirtualrealityCamera::rightViewMatrix() const
+{
+    return m_rightTransform->matrix().inverted();
+}
+
+void QVirtualrealityCamera::setProjectionTangents(const QVirtualRealityApiBackend::ProjectionTangents &leftEye,
+                                                  const QVirtualRealityApiBackend::ProjectionTangents &rightEye)
+{
+    m_leftTangents = leftEye;
+    m_rightTangents = rightEye;
+    m_hasTangents = true;
+    updateProjections();
+}
+
+void QVirtualrealityCamera::setReverseDepth(bool reverseDepth)
+{
+    if (m_reverseDepth == reverseDepth)
+        return;
+
+    m_reverseDepth = reverseDepth;
+    updateProjections();
+    Q_EMIT reverseDepthChanged(reverseDepth);
+}
+
+QMatrix4x4 QVirtualrealityCamera::leftProjection() const
+{
+    return m_leftProjection;
+}
+
+QMatrix4x4 QVirtualrealityCamera::rightProjection() const
+{
+    return m_rightProjection;
+}
+
+QVector3D QVirtualrealityCamera::centerEyePosition() const
+{
+    return 0.5f * (m_leftTransform->translation() + m_rightTransform->translation());
+}
+
+void QVirtualrealityCamera::updateProjections()
+{
+    if (!m_hasTangents)
+        return;
+
+    m_leftProjection = eyeProjection(m_leftTangents, m_nearPlane, m_farPlane, m_reverseDepth);
+    m_rightProjection = eyeProjection(m_rightTangents, m_nearPlane, m_farPlane, m_reverseDepth);
+    // Jittered lenses are set again by the next update
+    m_leftCameraLens->setProjectionMatrix(m_leftProjection);
+    m_rightCameraLens->setProjectionMatrix(m_rightProjection);
+    m_previousViewProjectionValid = false;
+    m_stereoFrustum.setProjections(m_leftProjection, m_rightProjection, m_nearPlane, m_farPlane);
+    m_stereoCameraLens->setProjectionMatrix(m_stereoFrustum.projection());
+    if (m_leftFoveaRect.isValid() && m_rightFoveaRect.isValid())
+        setFoveaRects(m_leftFoveaRect, m_rightFoveaRect);
+    // Near field ends where the far field begins, or at farPlane if that is closer
+    const float nearFieldFarPlane = m_farPlane > m_nearPlane ? qMin(m_farPlane, m_farFieldDistance) : m_farFieldDistance;
+    m_leftNearFieldCameraLens->setProjectionMatrix(eyeProjection(m_leftTangents, m_nearPlane, nearFieldFarPlane, m_reverseDepth));
+    m_rightNearFieldCameraLens->setProjectionMatrix(eyeProjection(m_rightTangents, m_nearPlane, nearFieldFarPlane, m_reverseDepth));
+    updateFarFieldProjection();
+    // Encloses both eyes without a margin, the edges only the eyes see are not tested and stay visible
+    QVirtualRealityApiBackend::ProjectionTangents occlusionTangents;
+    occlusionTangents.left = qMin(m_leftTangents.left, m_rightTangents.left);
+    occlusionTangents.right = qMax(m_leftTangents.right, m_rightTangents.right);
+    occlusionTangents.bottom = qMin(m_leftTangents.bottom, m_rightTangents.bottom);
+    occlusionTangents.top = qMax(m_leftTangents.top, m_rightTangents.top);
+    m_occlusionProjection = eyeProjection(occlusionTangents, m_nearPlane, m_farPlane, m_reverseDepth);
+    m_occlusionCameraLens->setProjectionMatrix(m_occlusionProjection);
     Q_EMIT leftCameraLensChanged(m_leftCameraLens);
     Q_EMIT rightCameraLensChanged(m_rightCameraLens);
+    Q_EMIT projectionsChanged(m_leftProjection, m_rightProjection);
+}
+
+void QVirtualrealityCamera::updateFarFieldProjection()
+{
+    if (!m_hasTangents)
+        return;
+
+    // Encloses both eyes. Seen from between the eyes, far field content is off by at most half their distance.
+    m_farFieldTangents.left = qMin(m_leftTangents.left, m_rightTangents.left) - m_farFieldMargin;
+    m_farFieldTangents.right = qMax(m_leftTangents.right, m_rightTangents.right) + m_farFieldMargin;
+    m_farFieldTangents.bottom = qMin(m_leftTangents.bottom, m_rightTangents.bottom);
+    m_farFieldTangents.top = qMax(m_leftTangents.top, m_rightTangents.top);
+    const float farPlane = m_farPlane > m_farFieldDistance ? m_farPlane : 0.0f;
+    m_farFieldCameraLens->setProjectionMatrix(eyeProjection(m_farFieldTangents, m_farFieldDistance, farPlane, m_reverseDepth));
+    Q_EMIT farFieldChanged();
+}
+
+void QVirtualrealityCamera::updateFarField(const QMatrix4x4 &leftTransform, const QMatrix4x4 &rightTransform)
+{
+    const QVector4D leftPosition(leftTransform.column(3));
+    const QVector4D rightPosition(rightTransform.column(3));
+    const float margin = 0.5f * (rightPosition - leftPosition).toVector3D().length() / m_farFieldDistance;
+    if (!qFuzzyCompare(margin, m_farFieldMargin)) {
+        m_farFieldMargin = margin;
+        updateFarFieldProjection();
+    }
+
+    // Between the eyes, oriented like the left eye
+    QMatrix4x4 farFieldTransform(leftTransform);
+    farFieldTransform.setColumn(3, 0.5f * (leftPosition + rightPosition));
+    m_farFieldTransform->setMatrix(farFieldTransform);
+
+    // Content at infinity only depends on the rotation of the eyes relative to the far field camera
+    const QMatrix4x4 toFarField = farFieldTransform.inverted();
+    const QMatrix4x4 directionsToCoordinates = coordinatesToDirections(m_farFieldTangents).inverted();
+    const QMatrix4x4 transforms[2] = { leftTransform, rightTransform };
+    const QVirtualRealityApiBackend::ProjectionTangents tangents[2] = { m_leftTangents, m_rightTangents };
+    QMatrix4x4 mappings[2];
+    for (int eye = 0; eye < 2; ++eye) {
+        QMatrix4x4 rotation(toFarField * transforms[eye]);
+        rotation.setColumn(3, QVector4D(0.0f, 0.0f, 0.0f, 1.0f));
+        mappings[eye] = directionsToCoordinates * rotation * coordinatesToDirections(tangents[eye]);
+    }
+    if (qFuzzyCompare(mappings[0], m_leftFarFieldMapping) && qFuzzyCompare(mappings[1], m_rightFarFieldMapping))
+        return;
+    m_leftFarFieldMapping = mappings[0];
+    m_rightFarFieldMapping = mappings[1];
+    Q_EMIT farFieldChanged();
+}
+
+void QVirtualrealityCamera::setFoveaRects(const QRectF &leftCenter, const QRectF &rightCenter)
+{
+    m_leftFoveaRect = leftCenter;
+    m_rightFoveaRect = rightCenter;
+    m_leftFoveaCameraLens->setProjectionMatrix(Foveation::cropProjection(m_leftProjection, leftCenter));
+    m_rightFoveaCameraLens->setProjectionMatrix(Foveation::cropProjection(m_rightProjection, rightCenter));
 }
 
 void QVirtualrealityCamera::update(const QMatrix4x4 &viewLeft, const QMatrix4x4 &viewRight)
@@ -85,6 +363,19 @@ void QVirtualrealityCamera::update(const QMatrix4x4 &viewLeft, const QMatrix4x4
     //QMatrix4x4 viewRight;
     //viewRight.lookAt(rightPos, rightPos + rightOrient.rotatedVector(QVector3D(0.0,0.0,1.0)), rightOrient.rotatedVector(QVector3D(0.0,1.0,0.0)));
     m_rightTransform->setMatrix(r);
+    m_leftFoveaTransform->setMatrix(l);
+    m_rightFoveaTransform->setMatrix(r);
+    m_leftNearFieldTransform->setMatrix(l);
+    m_rightNearFieldTransform->setMatrix(r);
+    updateFarField(l, r);
+    QMatrix4x4 occlusionTransform(l);
+    occlusionTransform.setColumn(3, 0.5f * (l.column(3) + r.column(3)));
+    m_occlusionTransform->setMatrix(occlusionTransform);
+    updateStereoUniformBuffer(l, r);
+    updateTemporalFrame(l, r);
+    if (m_stereoFrustum.update(l, r))
+        m_stereoCameraLens->setProjectionMatrix(m_stereoFrustum.projection());
+    m_stereoTransform->setMatrix(m_stereoFrustum.transform());
 
 
 //    Matrix4f   view = Matrix4f(orientation.Inverted()) * Matrix4f::Translation(-WorldEyePos);
@@ -105,6 +396,66 @@ void QVirtualrealityCamera::update(const QMatrix4x4 &viewLeft, const QMatrix4x4
 //    m_rightTransform->setTranslation(-rightPos);
 }
 
+void QVirtualrealityCamera::updateStereoUniformBuffer(const QMatrix4x4 &leftTransform, const QMatrix4x4 &rightTransform)
+{
+    // Like the camera entities, the eye transforms are eye to world. Views are the inverse.
+    const QMatrix4x4 transforms[2] = { leftTransform, rightTransform };
+    const QMatrix4x4 projections[2] = { m_leftProjection, m_rightProjection };
+    char *data = m_stereoUniformData.data();
+    for (int eye = 0; eye < 2; ++eye) {
+        const QMatrix4x4 viewProjection(projections[eye] * transforms[eye].inverted());
+        const QVector4D position(transforms[eye].column(3));
+        memcpy(data + eye * StereoMatrixSize, viewProjection.constData(), StereoMatrixSize);
+        memcpy(data + 2 * StereoMatrixSize + eye * StereoVectorSize, &position, StereoVectorSize);
+    }
+    m_stereoUniformBuffer->setData(m_stereoUniformData);
+}
+
+void QVirtualrealityCamera::setTemporalJitter(const QSize &eyeSize)
+{
+    if (m_jitterSize == eyeSize)
+        return;
+
+    m_jitterSize = eyeSize;
+    m_previousViewProjectionValid = false;
+    if (eyeSize.isEmpty()) {
+        m_leftCameraLens->setProjectionMatrix(m_leftProjection);
+        m_rightCameraLens->setProjectionMatrix(m_rightProjection);
+        m_projectionJitter = QVector2D();
+        Q_EMIT temporalFrameChanged();
+    }
+}
+
+void QVirtualrealityCamera::updateTemporalFrame(const QMatrix4x4 &leftTransform, const QMatrix4x4 &rightTransform)
+{
+    if (m_jitterSize.isEmpty())
+        return;
+
+    // Offset in pixels, -0.5..0.5. Skip index 0 of the sequence, it is always 0.
+    m_jitterIndex = m_jitterIndex % JitterSampleCount + 1;
+    const QVector2D pixelOffset(halton(m_jitterIndex, 2) - 0.5f, halton(m_jitterIndex, 3) - 0.5f);
+    m_projectionJitter = QVector2D(pixelOffset.x() / m_jitterSize.width(), pixelOffset.y() / m_jitterSize.height());
+    // Normalized device coordinates span 2
+    QMatrix4x4 jitter;
+    jitter.translate(2.0f * m_projectionJitter.x(), 2.0f * m_projectionJitter.y());
+    m_leftCameraLens->setProjectionMatrix(jitter * m_leftProjection);
+    m_rightCameraLens->setProjectionMatrix(jitter * m_rightProjection);
+
+    const QMatrix4x4 viewProjections[2] = { m_leftProjection * leftTransform.inverted(),
+                                            m_rightProjection * rightTransform.inverted() };
+    if (m_previousViewProjectionValid) {
+        m_leftReprojection = m_previousViewProjection[0] * viewProjections[0].inverted();
+        m_rightReprojection = m_previousViewProjection[1] * viewProjections[1].inverted();
+    } else {
+        m_leftReprojection.setToIdentity();
+        m_rightReprojection.setToIdentity();
+    }
+    m_previousViewProjection[0] = viewProjections[0];
+    m_previousViewProjection[1] = viewProjections[1];
+    m_previousViewProjectionValid = true;
+    Q_EMIT temporalFrameChanged();
+}
+
 float QVirtualrealityCamera::disparity() const
 {
     return m_disparity;
@@ -150,6 +501,77 @@ QQuaternion QVirtualrealityCamera::offsetOrientation() const
     return m_offsetOrientation;
 }
 
+bool QVirtualrealityCamera::perEyeCulling() const
+{
+    return m_perEyeCulling;
+}
+
+QVector2D QVirtualrealityCamera::projectionJitter() const
+{
+    return m_projectionJitter;
+}
+
+QMatrix4x4 QVirtualrealityCamera::leftReprojection() const
+{
+    return m_leftReprojection;
+}
+
+QMatrix4x4 QVirtualrealityCamera::rightReprojection() const
+{
+    return m_rightReprojection;
+}
+
+int QVirtualrealityCamera::historyIndex() const
+{
+    return m_jitterIndex % 2;
+}
+
+float QVirtualrealityCamera::nearPlane() const
+{
+    return m_nearPlane;
+}
+
+float QVirtualrealityCamera::farPlane() const
+{
+    return m_farPlane;
+}
+
+bool QVirtualrealityCamera::reverseDepth() const
+{
+    return m_reverseDepth;
+}
+
+float QVirtualrealityCamera::farFieldDistance() const
+{
+    return m_farFieldDistance;
+}
+
+QSizeF QVirtualrealityCamera::farFieldScale() const
+{
+    return QSizeF((m_farFieldTangents.right - m_farFieldTangents.left) / (m_leftTangents.right - m_leftTangents.left),
+                  (m_farFieldTangents.top - m_farFieldTangents.bottom) / (m_leftTangents.top - m_leftTangents.bottom));
+}
+
+QMatrix4x4 QVirtualrealityCamera::leftFarFieldMapping() const
+{
+    return m_leftFarFieldMapping;
+}
+
+QMatrix4x4 QVirtualrealityCamera::rightFarFieldMapping() const
+{
+    return m_rightFarFieldMapping;
+}
+
+int QVirtualrealityCamera::stereoVisibility(const QVector3D &center, float radius) const
+{
+    return m_stereoFrustum.classify(center, radius, m_perEyeCulling);
+}
+
+StereoFrustum QVirtualrealityCamera::stereoFrustum() const
+{
+    return m_stereoFrustum;
+}
+
 QMatrix4x4 QVirtualrealityCamera::trackedObjectMatrixTmp(int trackedObjectId)
 {
     if(!m_apibackend) return QMatrix4x4();
@@ -215,6 +637,53 @@ void QVirtualrealityCamera::setOffsetOrientation(QQuaternion offsetOrientation)
     Q_EMIT offsetOrientationChanged(offsetOrientation);
 }
 
+void QVirtualrealityCamera::setPerEyeCulling(bool perEyeCulling)
+{
+    if (m_perEyeCulling == perEyeCulling)
+        return;
+
+    m_perEyeCulling = perEyeCulling;
+    Q_EMIT perEyeCullingChanged(perEyeCulling);
+}
+
+void QVirtualrealityCamera::setNearPlane(float nearPlane)
+{
+    if (m_nearPlane == nearPlane)
+        return;
+    if (nearPlane <= 0.0f) {
+        qWarning() << "Near plane must be greater than 0, got" << nearPlane;
+        return;
+    }
+
+    m_nearPlane = nearPlane;
+    updateProjections();
+    Q_EMIT nearPlaneChanged(nearPlane);
+}
+
+void QVirtualrealityCamera::setFarPlane(float farPlane)
+{
+    if (m_farPlane == farPlane)
+        return;
+
+    m_farPlane = farPlane;
+    updateProjections();
+    Q_EMIT farPlaneChanged(farPlane);
+}
+
+void QVirtualrealityCamera::setFarFieldDistance(float farFieldDistance)
+{
+    if (m_farFieldDistance == farFieldDistance)
+        return;
+    if (farFieldDistance <= m_nearPlane) {
+        qWarning() << "Far field distance must be beyond the near plane, got" << farFieldDistance;
+        return;
+    }
+
+    m_farFieldDistance = farFieldDistance;
+    updateProjections();
+    Q_EMIT farFieldDistanceChanged(farFieldDistance);
+}
+
 } // namespace Qt3DVirtualReality
 
 QT_END_NAMESPACE
@@ -18,7 +18,12 @@
 #include <Qt3DCore/QEntity>
 #include <Qt3DCore/QTransform>
 #include <Qt3DRender/QCameraLens>
+#include <Qt3DRender/QBuffer>
+#include <QSize>
+#include <QSizeF>
+#include <QVector2D>
 #include <qvirtualrealityapibackend.h> //TO DO: THis include is only for transforms over camera
+#include "stereofrustum_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -31,6 +36,17 @@ class QVirtualrealityCamera : public Qt3DCore::QEntity
     Q_PROPERTY(Qt3DRender::QCameraLens * rightCameraLens READ rightCameraLens NOTIFY rightCameraLensChanged)
     Q_PROPERTY(Qt3DCore::QEntity * leftCamera READ leftCamera NOTIFY leftCameraChanged)
     Q_PROPERTY(Qt3DCore::QEntity * rightCamera READ rightCamera NOTIFY rightCameraChanged)
+    Q_PROPERTY(Qt3DCore::QEntity * stereoCamera READ stereoCamera CONSTANT)
+    Q_PROPERTY(Qt3DCore::QEntity * leftFoveaCamera READ leftFoveaCamera CONSTANT)
+    Q_PROPERTY(Qt3DCore::QEntity * rightFoveaCamera READ rightFoveaCamera CONSTANT)
+    Q_PROPERTY(Qt3DCore::QEntity * farFieldCamera READ farFieldCamera CONSTANT)
+    Q_PROPERTY(Qt3DCore::QEntity * leftNearFieldCamera READ leftNearFieldCamera CONSTANT)
+    Q_PROPERTY(Qt3DCore::QEntity * rightNearFieldCamera READ rightNearFieldCamera CONSTANT)
+    Q_PROPERTY(Qt3DCore::QEntity * occlusionCamera READ occlusionCamera CONSTANT)
+    Q_PROPERTY(float farFieldDistance READ farFieldDistance WRITE setFarFieldDistance NOTIFY farFieldDistanceChanged)
+    Q_PROPERTY(QSizeF farFieldScale READ farFieldScale NOTIFY farFieldChanged)
+    Q_PROPERTY(QMatrix4x4 leftFarFieldMapping READ leftFarFieldMapping NOTIFY farFieldChanged)
+    Q_PROPERTY(QMatrix4x4 rightFarFieldMapping READ rightFarFieldMapping NOTIFY farFieldChanged)
     Q_PROPERTY(float disparity READ disparity NOTIFY disparityChanged)
 //    Q_PROPERTY(QVector3D headPosPredicted READ headPosPredicted NOTIFY headPosPredictedChanged)
 //    Q_PROPERTY(QQuaternion headOrientationPredicted READ headOrientationPredicted NOTIFY headOrientationPredictedChanged)
@@ -40,14 +56,95 @@ class QVirtualrealityCamera : public Qt3DCore::QEntity
     Q_PROPERTY(float playerHeight READ playerHeight NOTIFY playerHeightChanged)
     Q_PROPERTY(QRectF leftNormalizedViewportRect READ leftNormalizedViewportRect WRITE setLeftNormalizedViewportRect NOTIFY leftNormalizedViewportRectChanged)
     Q_PROPERTY(QRectF rightNormalizedViewportRect READ rightNormalizedViewportRect WRITE setRightNormalizedViewportRect NOTIFY rightNormalizedViewportRectChanged)
+    Q_PROPERTY(Qt3DRender::QBuffer * stereoUniformBuffer READ stereoUniformBuffer CONSTANT)
+    Q_PROPERTY(bool perEyeCulling READ perEyeCulling WRITE setPerEyeCulling NOTIFY perEyeCullingChanged)
+    Q_PROPERTY(QVector2D projectionJitter READ projectionJitter NOTIFY temporalFrameChanged)
+    Q_PROPERTY(QMatrix4x4 leftReprojection READ leftReprojection NOTIFY temporalFrameChanged)
+    Q_PROPERTY(QMatrix4x4 rightReprojection READ rightReprojection NOTIFY temporalFrameChanged)
+    Q_PROPERTY(int historyIndex READ historyIndex NOTIFY temporalFrameChanged)
+    Q_PROPERTY(float nearPlane READ nearPlane WRITE setNearPlane NOTIFY nearPlaneChanged)
+    Q_PROPERTY(float farPlane READ farPlane WRITE setFarPlane NOTIFY farPlaneChanged)
+    Q_PROPERTY(bool reverseDepth READ reverseDepth NOTIFY reverseDepthChanged)
 public:
+    enum StereoVisibility {
+        Culled = StereoFrustum::Culled,
+        LeftEye = StereoFrustum::LeftEye,
+        RightEye = StereoFrustum::RightEye,
+        BothEyes = StereoFrustum::BothEyes
+    };
+    Q_ENUM(StereoVisibility)
+
     QVirtualrealityCamera(QNode *parent = nullptr);
 
     Qt3DCore::QEntity * leftCamera();
     Qt3DCore::QEntity * rightCamera();
+    /*!
+     * \brief stereoCamera sees everything either eye sees.
+     * Used by the single pass stereo branch of StereoFrameGraph, so that one RenderView
+     * does culling, parameter gathering and sorting for both eyes.
+     */
+    Qt3DCore::QEntity * stereoCamera();
+    /*!
+     * \brief leftFoveaCamera sees only the full resolution center of the left eye.
+     * Used by the foveated branch of StereoFrameGraph, see setFoveaRects.
+     */
+    Qt3DCore::QEntity * leftFoveaCamera();
+    Qt3DCore::QEntity * rightFoveaCamera();
+    /*!
+     * \brief farFieldCamera is a center eye between both eyes that sees everything beyond farFieldDistance.
+     * Used by the hybrid mono branch of StereoFrameGraph, its texture is shared by both eyes.
+     */
+    Qt3DCore::QEntity * farFieldCamera();
+    /*!
+     * \brief leftNearFieldCamera is the left eye, but sees only up to farFieldDistance.
+     */
+    Qt3DCore::QEntity * leftNearFieldCamera();
+    Qt3DCore::QEntity * rightNearFieldCamera();
+    /*!
+     * \brief occlusionCamera is a center eye between both eyes that sees what either eye sees, from nearPlane to farPlane.
+     * Used by the occlusion branch of StereoFrameGraph, its depth is read back for occlusion culling.
+     */
+    Qt3DCore::QEntity * occlusionCamera();
+    QMatrix4x4 occlusionProjection() const;
+    /*!
+     * \brief occlusionViewMatrix of the last update, transforms the world into the space of occlusionCamera.
+     */
+    QMatrix4x4 occlusionViewMatrix() const;
+    /*!
+     * \brief leftViewMatrix of the last update, transforms the world into the space of the left eye.
+     */
+    QMatrix4x4 leftViewMatrix() const;
+    QMatrix4x4 rightViewMatrix() const;
 
-    void setProjections(const QMatrix4x4& leftProjection, const QMatrix4x4& rightProjection);
+    /*!
+     * \brief setProjectionTangents sets the lens shape of the eyes. Projections are built from these
+     * together with nearPlane, farPlane and reverseDepth, and only rebuilt when one of them changes.
+     */
+    void setProjectionTangents(const QVirtualRealityApiBackend::ProjectionTangents &leftEye,
+                               const QVirtualRealityApiBackend::ProjectionTangents &rightEye);
+    /*!
+     * \brief setReverseDepth maps the near plane to depth 1 and the far plane to 0.
+     * Requires clip control with a depth range of 0..1, set by the head mounted display.
+     */
+    void setReverseDepth(bool reverseDepth);
+    QMatrix4x4 leftProjection() const;
+    QMatrix4x4 rightProjection() const;
+    /*!
+     * \brief centerEyePosition in the world, between both eyes of the last update.
+     */
+    QVector3D centerEyePosition() const;
+    /*!
+     * \brief setFoveaRects crops the projections of the fovea cameras to the centers of a foveation profile.
+     * The crop is kept when projections change.
+     */
+    void setFoveaRects(const QRectF &leftCenter, const QRectF &rightCenter);
     void update(const QMatrix4x4 &viewLeft, const QMatrix4x4 &viewRight);
+    /*!
+     * \brief setTemporalJitter offsets the projections of leftCamera and rightCamera by a different sub-pixel
+     * amount each update, for temporal upsampling with eyes of \a eyeSize pixels. An empty size removes the jitter.
+     * Must be called before update.
+     */
+    void setTemporalJitter(const QSize &eyeSize);
     float disparity() const;
 
 //    QMatrix4x4 headPosPredicted() const;
@@ -58,6 +155,53 @@ public:
     QRectF leftNormalizedViewportRect() const;
     QRectF rightNormalizedViewportRect() const;
     QQuaternion offsetOrientation() const;
+    bool perEyeCulling() const;
+    /*!
+     * \brief projectionJitter of the current frame in normalized eye coordinates.
+     * Things appear moved by this amount in the eye textures.
+     */
+    QVector2D projectionJitter() const;
+    /*!
+     * \brief leftReprojection maps clip coordinates of the current frame to those of the previous frame, without jitter.
+     */
+    QMatrix4x4 leftReprojection() const;
+    QMatrix4x4 rightReprojection() const;
+    /*!
+     * \brief historyIndex alternates between 0 and 1 every temporal frame, selects the history target written to.
+     */
+    int historyIndex() const;
+    float nearPlane() const;
+    /*!
+     * \brief farPlane of the eyes, 0 for an infinite projection.
+     */
+    float farPlane() const;
+    bool reverseDepth() const;
+    /*!
+     * \brief farFieldDistance splits near and far field, where the disparity of the eyes is below a pixel. Default 40.
+     */
+    float farFieldDistance() const;
+    /*!
+     * \brief farFieldScale is the extent of the far field camera relative to the left eye,
+     * its texture needs this size relative to an eye for the same pixel density.
+     */
+    QSizeF farFieldScale() const;
+    /*!
+     * \brief leftFarFieldMapping maps normalized coordinates of the left eye to those of the far field camera,
+     * for content at infinity. A homography in the upper 3x3, apply to (x, y, 1) and divide by z.
+     */
+    QMatrix4x4 leftFarFieldMapping() const;
+    QMatrix4x4 rightFarFieldMapping() const;
+
+    /*!
+     * \brief stereoVisibility culls a world space bounding sphere against the frustum of stereoCamera,
+     * which is tested once for both eyes. With perEyeCulling, spheres at the lateral edges are refined per eye.
+     * \return StereoVisibility flags
+     */
+    Q_INVOKABLE int stereoVisibility(const QVector3D &center, float radius) const;
+    /*!
+     * \brief stereoFrustum of the last update, culls for stereoCamera.
+     */
+    StereoFrustum stereoFrustum() const;
 
     // Transforms should be handled by special "VrTransform" Class, which has two backend nodes (one in renderaspect and one in vr aspect).
     // Then it should always uptade before rendering. For the moment, this will create a minimium viable product.
@@ -75,12 +219,27 @@ public:
         return m_rightCameraLens;
     }
 
+    /*!
+     * \brief stereoUniformBuffer holds the matrices of both eyes for single pass stereo rendering.
+     * std140 layout, see shaders/phong_stereo.vert:
+     * uniform StereoEyes { mat4 eyeViewProjection[2]; vec4 eyePosition[2]; };
+     * Index 0 is the left eye. Updated together with the eye transforms.
+     */
+    Qt3DRender::QBuffer * stereoUniformBuffer() const
+    {
+        return m_stereoUniformBuffer;
+    }
+
 public Q_SLOTS:
 
     void setOffset(QVector3D offset);
     void setLeftNormalizedViewportRect(QRectF leftNormalizedViewportRect);
     void setRightNormalizedViewportRect(QRectF rightNormalizedViewportRect);
     void setOffsetOrientation(QQuaternion offsetOrientation);
+    void setPerEyeCulling(bool perEyeCulling);
+    void setNearPlane(float nearPlane);
+    void setFarPlane(float farPlane);
+    void setFarFieldDistance(float farFieldDistance);
 
 Q_SIGNALS:
 
@@ -97,14 +256,51 @@ Q_SIGNALS:
     void offsetOrientationChanged(QQuaternion offsetOrientation);
     void leftCameraLensChanged(Qt3DRender::QCameraLens * leftCameraLens);
     void rightCameraLensChanged(Qt3DRender::QCameraLens * rightCameraLens);
+    void perEyeCullingChanged(bool perEyeCulling);
+    void temporalFrameChanged();
+    void nearPlaneChanged(float nearPlane);
+    void farPlaneChanged(float farPlane);
+    void reverseDepthChanged(bool reverseDepth);
+    void projectionsChanged(const QMatrix4x4 &leftProjection, const QMatrix4x4 &rightProjection);
+    void farFieldDistanceChanged(float farFieldDistance);
+    void farFieldChanged();
 
 private:
+    void updateStereoUniformBuffer(const QMatrix4x4 &leftTransform, const QMatrix4x4 &rightTransform);
+    void updateTemporalFrame(const QMatrix4x4 &leftTransform, const QMatrix4x4 &rightTransform);
+    void updateProjections();
+    void updateFarFieldProjection();
+    void updateFarField(const QMatrix4x4 &leftTransform, const QMatrix4x4 &rightTransform);
+
     Qt3DRender::QCameraLens *m_leftCameraLens;
     Qt3DRender::QCameraLens *m_rightCameraLens;
     Qt3DCore::QTransform *m_leftTransform;
     Qt3DCore::QTransform *m_rightTransform;
     Qt3DCore::QEntity *m_leftCamera;
     Qt3DCore::QEntity *m_rightCamera;
+    Qt3DRender::QCameraLens *m_stereoCameraLens;
+    Qt3DCore::QTransform *m_stereoTransform;
+    Qt3DCore::QEntity *m_stereoCamera;
+    Qt3DRender::QCameraLens *m_leftFoveaCameraLens;
+    Qt3DRender::QCameraLens *m_rightFoveaCameraLens;
+    Qt3DCore::QTransform *m_leftFoveaTransform;
+    Qt3DCore::QTransform *m_rightFoveaTransform;
+    Qt3DCore::QEntity *m_leftFoveaCamera;
+    Qt3DCore::QEntity *m_rightFoveaCamera;
+    Qt3DRender::QCameraLens *m_farFieldCameraLens;
+    Qt3DCore::QTransform *m_farFieldTransform;
+    Qt3DCore::QEntity *m_farFieldCamera;
+    Qt3DRender::QCameraLens *m_leftNearFieldCameraLens;
+    Qt3DRender::QCameraLens *m_rightNearFieldCameraLens;
+    Qt3DCore::QTransform *m_leftNearFieldTransform;
+    Qt3DCore::QTransform *m_rightNearFieldTransform;
+    Qt3DCore::QEntity *m_leftNearFieldCamera;
+    Qt3DCore::QEntity *m_rightNearFieldCamera;
+    Qt3DRender::QCameraLens *m_occlusionCameraLens;
+    Qt3DCore::QTransform *m_occlusionTransform;
+    Qt3DCore::QEntity *m_occlusionCamera;
+    StereoFrustum m_stereoFrustum;
+    bool m_perEyeCulling;
     float m_disparity;
 //    QVector3D m_headPosPredicted;
 //    QQuaternion m_headOrientationPredicted;
@@ -115,6 +311,31 @@ private:
     QRectF m_rightNormalizedViewportRect;
     QQuaternion m_offsetOrientation;
     QVirtualRealityApiBackend *m_apibackend; //TO DO: tmp
+    Qt3DRender::QBuffer *m_stereoUniformBuffer;
+    QMatrix4x4 m_leftProjection;
+    QMatrix4x4 m_rightProjection;
+    QByteArray m_stereoUniformData;
+    QSize m_jitterSize;
+    int m_jitterIndex;
+    QVector2D m_projectionJitter;
+    QMatrix4x4 m_leftReprojection;
+    QMatrix4x4 m_rightReprojection;
+    QMatrix4x4 m_previousViewProjection[2];
+    bool m_previousViewProjectionValid;
+    QVirtualRealityApiBackend::ProjectionTangents m_leftTangents;
+    QVirtualRealityApiBackend::ProjectionTangents m_rightTangents;
+    bool m_hasTangents;
+    float m_nearPlane;
+    float m_farPlane;
+    bool m_reverseDepth;
+    QRectF m_leftFoveaRect;
+    QRectF m_rightFoveaRect;
+    float m_farFieldDistance;
+    float m_farFieldMargin; // Half the distance of the eyes, in tangents at farFieldDistance
+    QVirtualRealityApiBackend::ProjectionTangents m_farFieldTangents;
+    QMatrix4x4 m_leftFarFieldMapping;
+    QMatrix4x4 m_rightFarFieldMapping;
+    QMatrix4x4 m_occlusionProjection;
 
 };
 
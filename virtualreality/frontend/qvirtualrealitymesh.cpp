@@ -20,6 +20,8 @@
 #include <qmath.h>
 #include <QVector3D>
 #include "qvirtualrealitygeometry.h"
+#include <Qt3DRender/qtexture.h>
+#include <qvirtualrealityapibackend.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -55,11 +57,18 @@ namespace Qt3DVirtualReality {
 
 QVirtualRealityMesh::QVirtualRealityMesh(QNode *parent)
     : QGeometryRenderer(parent)
+    , m_diffuseTexture(new Qt3DRender::QTexture2D(this))
+    , m_apibackend(nullptr)
 {
     QVirtualRealityGeometry *geometry = new QVirtualRealityGeometry(this);
     QObject::connect(geometry, &QVirtualRealityGeometry::trackedObjectIndexChanged, this, &QVirtualRealityMesh::trackedObjectIdChanged);
 
     QGeometryRenderer::setGeometry(geometry);
+
+    m_diffuseTexture->setFormat(Qt3DRender::QAbstractTexture::RGBA8_UNorm);
+    m_diffuseTexture->setGenerateMipMaps(true);
+    m_diffuseTexture->setMinificationFilter(Qt3DRender::QAbstractTexture::LinearMipMapLinear);
+    m_diffuseTexture->setMagnificationFilter(Qt3DRender::QAbstractTexture::Linear);
 }
 
 /*! \internal */
@@ -72,9 +81,25 @@ int QVirtualRealityMesh::trackedObjectId() const
     return static_cast<QVirtualRealityGeometry *>(geometry())->trackedObjectIndex();
 }
 
+/*!
+ * \property QVirtualRealityMesh::diffuseTexture
+ *
+ * Holds the texture of the tracked object as provided by the vr sdk. It stays empty until the
+ * texture has been loaded. Qt3D only allocates it, QHeadMountedDisplay streams the pixels in.
+ */
+Qt3DRender::QAbstractTexture *QVirtualRealityMesh::diffuseTexture() const
+{
+    return m_diffuseTexture;
+}
+
 void QVirtualRealityMesh::setVrApiBackendTmp(QVirtualRealityApiBackend *apibackend)
 {
+    m_apibackend = apibackend;
     static_cast<QVirtualRealityGeometry *>(geometry())->setVrApiBackendTmp(apibackend);
+    if (m_apibackend) {
+        const QSize size = m_apibackend->getTrackedObjectTextureSize();
+        m_diffuseTexture->setSize(size.width(), size.height());
+    }
 }
 
 void QVirtualRealityMesh::setTrackedObjectId(int trackedObjectId)
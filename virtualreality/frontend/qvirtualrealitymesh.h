@@ -20,6 +20,11 @@
 
 QT_BEGIN_NAMESPACE
 
+namespace Qt3DRender {
+class QAbstractTexture;
+class QTexture2D;
+}
+
 namespace Qt3DVirtualReality {
 
 class QVirtualRealityApiBackend; //TO DO: temp
@@ -28,11 +33,13 @@ class QT3DVR_EXPORT QVirtualRealityMesh : public Qt3DRender::QGeometryRenderer
 {
     Q_OBJECT
     Q_PROPERTY(int trackedObjectId READ trackedObjectId WRITE setTrackedObjectId NOTIFY trackedObjectIdChanged)
+    Q_PROPERTY(Qt3DRender::QAbstractTexture *diffuseTexture READ diffuseTexture CONSTANT)
 public:
     explicit QVirtualRealityMesh(Qt3DCore::QNode *parent = nullptr);
     ~QVirtualRealityMesh();
 
     int trackedObjectId() const;
+    Qt3DRender::QAbstractTexture *diffuseTexture() const;
 
     void setVrApiBackendTmp(QVirtualRealityApiBackend *apibackend); //TO DO: temp
 
@@ -57,6 +64,8 @@ private:
     void setGeometry(Qt3DRender::QGeometry *geometry);
     void setPrimitiveType(PrimitiveType primitiveType);
     int m_trackedObjectId;
+    Qt3DRender::QTexture2D *m_diffuseTexture;
+    QVirtualRealityApiBackend *m_apibackend; //TO DO: temp
 };
 
 } // namespace Qt3DVirtualReality
@@ -0,0 +1,170 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "stereofrustum_p.h"
+
+#include <QVector4D>
+#include <QtMath>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+namespace {
+
+// Culling distance of an infinite projection, relative to the near plane
+const float InfiniteFarRatio = 100000.0f;
+
+} // anonymous
+
+StereoFrustum::StereoFrustum()
+    : m_nearPlane(0.1f)
+    , m_farPlane(1000.0f)
+    , m_halfIpd(-1.0f)
+    , m_apexOffset(0.0f)
+{
+    // 90 degrees until the projections are known
+    m_left.left = m_right.left = m_left.bottom = m_right.bottom = -1.0f;
+    m_left.right = m_right.right = m_left.top = m_right.top = 1.0f;
+}
+
+StereoFrustum::Tangents StereoFrustum::tangents(const QMatrix4x4 &projection)
+{
+    // For an OpenGL frustum x_ndc = P(0,0) * x/-z - P(0,2), same for y
+    Tangents result;
+    result.left = (projection(0, 2) - 1.0f) / projection(0, 0);
+    result.right = (projection(0, 2) + 1.0f) / projection(0, 0);
+    result.bottom = (projection(1, 2) - 1.0f) / projection(1, 1);
+    result.top = (projection(1, 2) + 1.0f) / projection(1, 1);
+    return result;
+}
+
+void StereoFrustum::setProjections(const QMatrix4x4 &leftProjection, const QMatrix4x4 &rightProjection, float nearPlane, float farPlane)
+{
+    m_left = tangents(leftProjection);
+    m_right = tangents(rightProjection);
+    m_nearPlane = nearPlane;
+    // Qt3D normalizes the planes of the stereo camera, an infinite projection has no far plane
+    m_farPlane = farPlane > nearPlane ? farPlane : nearPlane * InfiniteFarRatio;
+    // Planes are extracted from OpenGL projections, independent of the depth mapping of the eyes
+    m_leftProjection = cullingProjection(m_left);
+    m_rightProjection = cullingProjection(m_right);
+    updateProjection();
+}
+
+QMatrix4x4 StereoFrustum::cullingProjection(const Tangents &tangents) const
+{
+    QMatrix4x4 projection;
+    projection.frustum(tangents.left * m_nearPlane, tangents.right * m_nearPlane,
+                       tangents.bottom * m_nearPlane, tangents.top * m_nearPlane, m_nearPlane, m_farPlane);
+    return projection;
+}
+
+bool StereoFrustum::update(const QMatrix4x4 &leftTransform, const QMatrix4x4 &rightTransform)
+{
+    const QVector3D leftPosition(leftTransform.column(3).toVector3D());
+    const QVector3D rightPosition(rightTransform.column(3).toVector3D());
+    const float halfIpd = 0.5f * (rightPosition - leftPosition).length();
+    const bool changed = !qFuzzyCompare(halfIpd, m_halfIpd);
+    if (changed) {
+        m_halfIpd = halfIpd;
+        updateProjection();
+    }
+
+    // Center between the eyes, pulled back along the view axis
+    m_transform = leftTransform;
+    m_transform.setColumn(3, QVector4D(0.5f * (leftPosition + rightPosition), 1.0f));
+    m_transform.translate(0.0f, 0.0f, m_apexOffset);
+
+    extractPlanes(m_projection * m_transform.inverted(), m_planes);
+    extractPlanes(m_leftProjection * leftTransform.inverted(), m_leftPlanes);
+    extractPlanes(m_rightProjection * rightTransform.inverted(), m_rightPlanes);
+    return changed;
+}
+
+int StereoFrustum::classify(const QVector3D &center, float radius, bool refinePerEye) const
+{
+    if (isOutside(m_planes, center, radius))
+        return Culled;
+    if (!refinePerEye)
+        return BothEyes;
+
+    // Inside the lateral planes of both eyes: seen by both. Top, bottom, near and far of the eyes
+    // differ by a tiny vertical lens offset at most, counting those as both stays conservative.
+    const QVector4D position(center, 1.0f);
+    if (QVector4D::dotProduct(m_leftPlanes[LeftPlane], position) >= radius
+            && QVector4D::dotProduct(m_leftPlanes[RightPlane], position) >= radius
+            && QVector4D::dotProduct(m_rightPlanes[LeftPlane], position) >= radius
+            && QVector4D::dotProduct(m_rightPlanes[RightPlane], position) >= radius)
+        return BothEyes;
+
+    // Straddles an outer plane of an eye
+    int visibility = Culled;
+    if (!isOutside(m_leftPlanes, center, radius))
+        visibility |= LeftEye;
+    if (!isOutside(m_rightPlanes, center, radius))
+        visibility |= RightEye;
+    return visibility;
+}
+
+void StereoFrustum::extractPlanes(const QMatrix4x4 &viewProjection, QVector4D *planes)
+{
+    // Gribb/Hartmann
+    const QVector4D x(viewProjection.row(0));
+    const QVector4D y(viewProjection.row(1));
+    const QVector4D z(viewProjection.row(2));
+    const QVector4D w(viewProjection.row(3));
+    planes[LeftPlane] = w + x;
+    planes[RightPlane] = w - x;
+    planes[BottomPlane] = w + y;
+    planes[TopPlane] = w - y;
+    planes[NearPlane] = w + z;
+    planes[FarPlane] = w - z;
+    for (int i = 0; i < PlaneCount; ++i)
+        planes[i] /= planes[i].toVector3D().length();
+}
+
+bool StereoFrustum::isOutside(const QVector4D *planes, const QVector3D &center, float radius)
+{
+    const QVector4D position(center, 1.0f);
+    for (int i = 0; i < PlaneCount; ++i) {
+        if (QVector4D::dotProduct(planes[i], position) < -radius)
+            return true;
+    }
+    return false;
+}
+
+void StereoFrustum::updateProjection()
+{
+    const float left = qMin(m_left.left, m_right.left);
+    const float right = qMax(m_left.right, m_right.right);
+    const float bottom = qMin(m_left.bottom, m_right.bottom);
+    const float top = qMax(m_left.top, m_right.top);
+
+    // The outer plane of the combined frustum must not cut into the frustum of the outer eye:
+    // left * (d + apexOffset) <= -halfIpd + left * d for every depth d, same for the right side.
+    const float narrowest = qMin(-left, right);
+    m_apexOffset = narrowest > 0.0f ? qMax(0.0f, m_halfIpd) / narrowest : 0.0f;
+
+    // Near and far stay at the same depth as the planes of the eyes
+    const float nearPlane = m_nearPlane + m_apexOffset;
+    const float farPlane = m_farPlane + m_apexOffset;
+    m_projection.setToIdentity();
+    m_projection.frustum(left * nearPlane, right * nearPlane, bottom * nearPlane, top * nearPlane, nearPlane, farPlane);
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
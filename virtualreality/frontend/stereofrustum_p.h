@@ -0,0 +1,103 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_STEREOFRUSTUM_P_H
+#define QT3DVIRTUALREALITY_STEREOFRUSTUM_P_H
+
+#include <QMatrix4x4>
+#include <QVector4D>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The StereoFrustum class computes one frustum that encloses the frustums of both eyes.
+ * Eyes are expected to share their orientation and to be offset along their x axis (ipd).
+ * Tangents are taken from the asymmetric projections of the sdk. The apex of the combined
+ * frustum is moved behind the eyes until its outer planes enclose both eye frustums.
+ */
+class StereoFrustum
+{
+public:
+    enum Visibility {
+        Culled = 0,
+        LeftEye = 0x1,
+        RightEye = 0x2,
+        BothEyes = LeftEye | RightEye
+    };
+
+    StereoFrustum();
+
+    /*!
+     * \brief setProjections of the eyes. Only their lateral planes are used, near and far come separately,
+     * the projections may map depth reversed or to an infinite far plane.
+     * \param farPlane 0 for an infinite far plane, culling then uses a very distant one.
+     */
+    void setProjections(const QMatrix4x4 &leftProjection, const QMatrix4x4 &rightProjection, float nearPlane, float farPlane);
+    /*!
+     * \brief update with the eye to world transforms of this frame.
+     * \return true if the combined projection changed (e.g. the ipd was adjusted)
+     */
+    bool update(const QMatrix4x4 &leftTransform, const QMatrix4x4 &rightTransform);
+
+    //! Eye to world transform of the combined apex
+    QMatrix4x4 transform() const { return m_transform; }
+    QMatrix4x4 projection() const { return m_projection; }
+
+    /*!
+     * \brief classify a world space bounding sphere.
+     * Tests the combined frustum only. With \a refinePerEye, spheres straddling a left or right plane
+     * of an eye are additionally tested against the full eye frustums, everything else is seen by both eyes.
+     * \return Visibility flags
+     */
+    int classify(const QVector3D &center, float radius, bool refinePerEye) const;
+
+private:
+    struct Tangents {
+        float left;
+        float right;
+        float bottom;
+        float top;
+    };
+    static Tangents tangents(const QMatrix4x4 &projection);
+    QMatrix4x4 cullingProjection(const Tangents &tangents) const;
+    void updateProjection();
+    static void extractPlanes(const QMatrix4x4 &viewProjection, QVector4D *planes);
+    static bool isOutside(const QVector4D *planes, const QVector3D &center, float radius);
+
+    Tangents m_left;
+    Tangents m_right;
+    float m_nearPlane;
+    float m_farPlane;
+    float m_halfIpd;
+    float m_apexOffset;
+    QMatrix4x4 m_transform;
+    QMatrix4x4 m_projection;
+    QMatrix4x4 m_leftProjection;
+    QMatrix4x4 m_rightProjection;
+
+    enum Plane { LeftPlane, RightPlane, BottomPlane, TopPlane, NearPlane, FarPlane, PlaneCount };
+    // World space, xyz normal pointing inwards, w distance
+    QVector4D m_planes[PlaneCount];
+    QVector4D m_leftPlanes[PlaneCount];
+    QVector4D m_rightPlanes[PlaneCount];
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_STEREOFRUSTUM_P_H
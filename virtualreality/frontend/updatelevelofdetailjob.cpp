@@ -0,0 +1,101 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "updatelevelofdetailjob_p.h"
+#include "jobtypes_p.h"
+
+#include <Qt3DCore/private/qaspectjob_p.h>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+UpdateLevelOfDetailJob::UpdateLevelOfDetailJob()
+    : QAspectJob()
+    , m_hasInput(false)
+    , m_hasLevels(false)
+{
+    m_view.pixelsPerTangent = 0.0f;
+    SET_JOB_RUN_STAT_TYPE(this, JobTypes::UpdateLevelOfDetail, 0);
+}
+
+void UpdateLevelOfDetailJob::setInput(const QVector<Entry> &entries, const View &view)
+{
+    QMutexLocker lock(&m_mutex);
+    m_entries = entries;
+    m_view = view;
+    m_hasInput = true;
+    m_hasLevels = false;
+}
+
+bool UpdateLevelOfDetailJob::takeLevels(QVector<int> &levels)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_hasLevels)
+        return false;
+    levels.swap(m_levels);
+    m_levels.clear();
+    m_hasLevels = false;
+    return true;
+}
+
+int UpdateLevelOfDetailJob::selectLevel(float projectedSize, const QVector<qreal> &thresholds, float hysteresis, int currentIndex)
+{
+    // Level i is used down to thresholds[i], the last level below all of them
+    for (int i = 0; i < thresholds.size(); ++i) {
+        // Finer levels than the current one need a larger size to be picked, coarser ones a smaller size to be left
+        const float threshold = thresholds.at(i) * (i < currentIndex ? 1.0f + hysteresis : 1.0f - hysteresis);
+        if (projectedSize >= threshold)
+            return i;
+    }
+    return thresholds.size();
+}
+
+void UpdateLevelOfDetailJob::run()
+{
+    QVector<Entry> entries;
+    View view;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (!m_hasInput)
+            return;
+        entries.swap(m_entries);
+        view = m_view;
+        m_hasInput = false;
+    }
+
+    QVector<int> levels;
+    levels.reserve(entries.size());
+    for (const Entry &entry : qAsConst(entries)) {
+        // Diameter in pixels in the center of the eye, the viewer inside the sphere sees it at full size
+        const float distance = (entry.center - view.position).length();
+        const float projectedSize = distance > entry.radius ? 2.0f * entry.radius / distance * view.pixelsPerTangent
+                                                            : std::numeric_limits<float>::max();
+        levels.append(selectLevel(projectedSize, entry.thresholds, entry.hysteresis, entry.currentIndex));
+    }
+
+    QMutexLocker lock(&m_mutex);
+    // Dropped if new input arrived meanwhile, it is evaluated next
+    if (m_hasInput)
+        return;
+    m_levels.swap(levels);
+    m_hasLevels = true;
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
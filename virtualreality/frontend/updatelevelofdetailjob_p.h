@@ -0,0 +1,82 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_UPDATELEVELOFDETAILJOB_P_H
+#define QT3DVIRTUALREALITY_UPDATELEVELOFDETAILJOB_P_H
+
+#include <Qt3DCore/qaspectjob.h>
+#include <QMutex>
+#include <QVector>
+#include <QVector3D>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The UpdateLevelOfDetailJob class selects the levels of QStereoLevelOfDetail components
+ * in parallel to the other aspect jobs.
+ * Its input is a snapshot taken by the head mounted display on the gui thread, which also applies
+ * the levels. They are one frame late, which is not visible for changes of detail.
+ */
+class UpdateLevelOfDetailJob : public Qt3DCore::QAspectJob
+{
+public:
+    struct Entry {
+        QVector3D center; // World space bounding sphere
+        float radius;
+        QVector<qreal> thresholds;
+        float hysteresis;
+        int currentIndex;
+    };
+    struct View {
+        QVector3D position; // Between the eyes
+        float pixelsPerTangent; // Eye pixels per unit of the tangent of the view angle
+    };
+
+    UpdateLevelOfDetailJob();
+
+    /*!
+     * \brief setInput replaces the input not yet evaluated. Can be called from any thread.
+     */
+    void setInput(const QVector<Entry> &entries, const View &view);
+    /*!
+     * \brief takeLevels of the last input, one per entry. Can be called from any thread.
+     * \return false if the last input has not been evaluated yet.
+     */
+    bool takeLevels(QVector<int> &levels);
+
+    /*!
+     * \brief selectLevel with the thresholds in pixels ordered from the finest level down. Thresholds are moved
+     * away from the current level by hysteresis, so that levels do not flicker at a boundary.
+     */
+    static int selectLevel(float projectedSize, const QVector<qreal> &thresholds, float hysteresis, int currentIndex);
+
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    QMutex m_mutex;
+    QVector<Entry> m_entries;
+    View m_view;
+    bool m_hasInput;
+    QVector<int> m_levels;
+    bool m_hasLevels;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_UPDATELEVELOFDETAILJOB_P_H
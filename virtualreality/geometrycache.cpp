@@ -0,0 +1,209 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#include "geometrycache_p.h"
+
+#include <Qt3DCore/qnode.h>
+#include <Qt3DRender/qattribute.h>
+#include <Qt3DRender/qbuffer.h>
+#include <Qt3DRender/qgeometry.h>
+#include <Qt3DRender/qgeometryrenderer.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DRender;
+
+namespace Qt3DVirtualReality {
+
+namespace {
+
+// Data of a buffer whose attributes use a shared buffer
+class EmptyDataFunctor : public QBufferDataGenerator
+{
+public:
+    QByteArray operator ()() Q_DECL_OVERRIDE
+    {
+        return QByteArray();
+    }
+
+    bool operator ==(const QBufferDataGenerator &other) const Q_DECL_OVERRIDE
+    {
+        return functor_cast<EmptyDataFunctor>(&other) != nullptr;
+    }
+
+    QT3D_FUNCTOR(EmptyDataFunctor)
+};
+
+} // anonymous
+
+GeometryCache::GeometryCache()
+    : m_emptyGenerator(QSharedPointer<EmptyDataFunctor>::create())
+{
+}
+
+GeometryCache::~GeometryCache()
+{
+}
+
+void GeometryCache::update(Qt3DCore::QNode *root, const QList<QGeometryRenderer*> &renderers)
+{
+    if (!m_node) {
+        // Kept buffers died with their scene
+        clear();
+        if (!root)
+            return;
+        m_node = new Qt3DCore::QNode(root);
+    }
+
+    // Geometries that set a new generator on their emptied buffer move to the kept buffer of it, before Qt3D
+    // syncs their new attribute counts. The other users of their previous buffer stay.
+    for (auto iter = m_shared.begin(); iter != m_shared.end();) {
+        if (iter->original && iter->buffer && share(iter.value())) {
+            ++iter;
+            continue;
+        }
+        restore(iter.value());
+        release(iter->buffer);
+        iter = m_shared.erase(iter);
+    }
+
+    for (QGeometryRenderer *renderer : renderers) {
+        QGeometry *geometry = renderer->geometry();
+        if (!geometry)
+            continue;
+        // Attributes of one buffer, e.g. interleaved position, normal and texture coordinates, move together
+        QHash<QBuffer*, QVector<QPointer<QAttribute> > > attributesOfBuffer;
+        const QVector<QAttribute*> attributes = geometry->attributes();
+        for (QAttribute *attribute : attributes) {
+            if (attribute->buffer() && attribute->buffer()->parent() != m_node)
+                attributesOfBuffer[attribute->buffer()].append(attribute);
+        }
+        for (auto iter = attributesOfBuffer.cbegin(); iter != attributesOfBuffer.cend(); ++iter) {
+            QBuffer *original = iter.key();
+            // Emptied already, e.g. for the attributes of another geometry
+            auto shared = m_shared.find(original);
+            if (shared != m_shared.end()) {
+                for (const QPointer<QAttribute> &attribute : iter.value())
+                    attribute->setBuffer(shared->buffer);
+                shared->attributes += iter.value();
+                continue;
+            }
+            // Only generated data is shared
+            const QBufferDataGeneratorPtr generator = original->dataGenerator();
+            if (!generator || generator == m_emptyGenerator)
+                continue;
+            Shared sharing;
+            sharing.original = original;
+            sharing.generator = generator;
+            sharing.buffer = acquire(original, generator);
+            sharing.attributes = iter.value();
+            for (const QPointer<QAttribute> &attribute : iter.value())
+                attribute->setBuffer(sharing.buffer);
+            original->setDataGenerator(m_emptyGenerator);
+            m_shared.insert(original, sharing);
+        }
+    }
+}
+
+void GeometryCache::clear()
+{
+    for (const Shared &shared : qAsConst(m_shared))
+        restore(shared);
+    m_shared.clear();
+    m_entries.clear();
+    delete m_node;
+}
+
+bool GeometryCache::share(Shared &shared)
+{
+    // Attributes moved to yet another buffer by their geometry keep it
+    shared.attributes.erase(std::remove_if(shared.attributes.begin(), shared.attributes.end(),
+                                           [&shared](const QPointer<QAttribute> &attribute) {
+        return !attribute || attribute->buffer() != shared.buffer;
+    }), shared.attributes.end());
+    if (shared.attributes.isEmpty())
+        return false;
+    const QBufferDataGeneratorPtr generator = shared.original->dataGenerator();
+    if (generator == m_emptyGenerator)
+        return true;
+    // The geometry set plain data
+    if (!generator)
+        return false;
+    // Attributes are re-pointed in the same sync as the new generator and counts, never onto data of the old ones
+    QBuffer *buffer = acquire(shared.original, generator);
+    for (const QPointer<QAttribute> &attribute : qAsConst(shared.attributes))
+        attribute->setBuffer(buffer);
+    release(shared.buffer);
+    shared.buffer = buffer;
+    shared.generator = generator;
+    shared.original->setDataGenerator(m_emptyGenerator);
+    return true;
+}
+
+void GeometryCache::restore(const Shared &shared)
+{
+    if (!shared.original)
+        return;
+    // A geometry that set new data keeps it
+    if (shared.original->dataGenerator() == m_emptyGenerator)
+        shared.original->setDataGenerator(shared.generator);
+    for (const QPointer<QAttribute> &attribute : shared.attributes) {
+        // Attributes moved to yet another buffer by their geometry keep it
+        if (attribute && (!shared.buffer || attribute->buffer() == shared.buffer))
+            attribute->setBuffer(shared.original);
+    }
+}
+
+QBuffer *GeometryCache::acquire(QBuffer *original, const QBufferDataGeneratorPtr &generator)
+{
+    QVector<Entry> &entries = m_entries[generator->id()];
+    for (Entry &entry : entries) {
+        if (entry.buffer && entry.buffer->type() == original->type() && *entry.generator == *generator) {
+            ++entry.users;
+            return entry.buffer;
+        }
+    }
+    // Generated once, for all geometries with an equal generator
+    Entry entry;
+    entry.generator = generator;
+    entry.buffer = new QBuffer(original->type(), m_node);
+    entry.buffer->setUsage(original->usage());
+    entry.buffer->setDataGenerator(generator);
+    entry.users = 1;
+    entries.append(entry);
+    return entry.buffer;
+}
+
+void GeometryCache::release(QBuffer *buffer)
+{
+    if (!buffer)
+        return;
+    // Kept buffers never change their generator
+    QVector<Entry> &entries = m_entries[buffer->dataGenerator()->id()];
+    for (int i = 0; i < entries.size(); ++i) {
+        if (entries.at(i).buffer != buffer)
+            continue;
+        if (--entries[i].users == 0) {
+            delete buffer;
+            entries.remove(i);
+        }
+        return;
+    }
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
@@ -0,0 +1,92 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#ifndef QT3DVIRTUALREALITY_GEOMETRYCACHE_P_H
+#define QT3DVIRTUALREALITY_GEOMETRYCACHE_P_H
+
+#include <Qt3DRender/qbufferdatagenerator.h>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DCore {
+class QNode;
+}
+
+namespace Qt3DRender {
+class QAttribute;
+class QBuffer;
+class QGeometryRenderer;
+}
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The GeometryCache class lets identical procedural meshes share one set of buffers.
+ * Buffers are keyed by their data generator, compared with QBufferDataGenerator::operator==, which every
+ * generator implements over its parameters (e.g. rings and slices of a torus). The cache keeps one buffer per
+ * generator under its own node, no geometry writes to it. Attributes of all equal buffers are pointed to it
+ * and those buffers get an empty generator, so their data is neither generated nor uploaded.
+ * When a geometry sets a new generator on its emptied buffer, only its attributes move to the buffer of the
+ * new generator, which is generated once for all geometries switching to it. Unused buffers are deleted.
+ */
+class GeometryCache
+{
+public:
+    GeometryCache();
+    ~GeometryCache();
+
+    /*!
+     * \brief update shares the buffers of \a renderers, kept under a node below \a root. Call on the gui thread
+     * before each frame and after changing parameters of geometries, before Qt3D syncs the changes.
+     */
+    void update(Qt3DCore::QNode *root, const QList<Qt3DRender::QGeometryRenderer*> &renderers);
+    /*!
+     * \brief clear gives all geometries their own buffers back and deletes the kept ones.
+     */
+    void clear();
+
+private:
+    struct Entry {
+        Qt3DRender::QBufferDataGeneratorPtr generator;
+        QPointer<Qt3DRender::QBuffer> buffer;
+        int users;
+    };
+    // A buffer whose attributes use the kept buffer of its generator
+    struct Shared {
+        QPointer<Qt3DRender::QBuffer> original;
+        Qt3DRender::QBufferDataGeneratorPtr generator; // Of original, before it was emptied
+        QPointer<Qt3DRender::QBuffer> buffer;
+        QVector<QPointer<Qt3DRender::QAttribute> > attributes;
+    };
+
+    bool share(Shared &shared);
+    void restore(const Shared &shared);
+    Qt3DRender::QBuffer *acquire(Qt3DRender::QBuffer *original, const Qt3DRender::QBufferDataGeneratorPtr &generator);
+    void release(Qt3DRender::QBuffer *buffer);
+
+    QPointer<Qt3DCore::QNode> m_node; // Parent of the kept buffers
+    QHash<qintptr, QVector<Entry> > m_entries; // By functor type of the generator
+    QHash<Qt3DRender::QBuffer*, Shared> m_shared; // By original
+    Qt3DRender::QBufferDataGeneratorPtr m_emptyGenerator;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_GEOMETRYCACHE_P_H
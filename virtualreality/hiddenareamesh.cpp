@@ -0,0 +1,96 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "hiddenareamesh_p.h"
+
+#include <QtMath>
+
+#include <algorithm>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+namespace HiddenAreaMesh {
+
+namespace {
+
+// Intersection of the ray center + t * direction with the border of the unit square
+QVector2D toBorder(const QVector2D &center, const QVector2D &direction)
+{
+    float t = std::numeric_limits<float>::max();
+    if (direction.x() > 0.0f)
+        t = qMin(t, (1.0f - center.x()) / direction.x());
+    else if (direction.x() < 0.0f)
+        t = qMin(t, -center.x() / direction.x());
+    if (direction.y() > 0.0f)
+        t = qMin(t, (1.0f - center.y()) / direction.y());
+    else if (direction.y() < 0.0f)
+        t = qMin(t, -center.y() / direction.y());
+    return center + t * direction;
+}
+
+} // anonymous
+
+QVector<QVector2D> synthesize(const QMatrix4x4 &projection, int segments, float coverage)
+{
+    // Optical axis in ndc is (-P(0,2), -P(1,2)), see StereoFrustum::tangents
+    const QVector2D center(0.5f * (1.0f - projection(0, 2)), 0.5f * (1.0f - projection(1, 2)));
+    const QVector2D radius(coverage * qMax(center.x(), 1.0f - center.x()),
+                           coverage * qMax(center.y(), 1.0f - center.y()));
+
+    // Uniform angles plus the viewport corners, so that the border of the ring follows the corners exactly
+    QVector<float> angles;
+    angles.reserve(segments + 5);
+    for (int i = 0; i < segments; ++i)
+        angles.append(2.0f * float(M_PI) * i / segments);
+    for (int corner = 0; corner < 4; ++corner) {
+        const QVector2D direction(QVector2D(corner & 1, corner >> 1) - center);
+        float angle = std::atan2(direction.y() / radius.y(), direction.x() / radius.x());
+        if (angle < 0.0f)
+            angle += 2.0f * float(M_PI);
+        angles.append(angle);
+    }
+    std::sort(angles.begin(), angles.end());
+    angles.append(angles.first() + 2.0f * float(M_PI));
+
+    QVector<QVector2D> triangles;
+    triangles.reserve(angles.size() * 6);
+    QVector2D lastInner;
+    QVector2D lastOuter;
+    for (int i = 0; i < angles.size(); ++i) {
+        const QVector2D direction(radius.x() * qCos(angles[i]), radius.y() * qSin(angles[i]));
+        const QVector2D outer(toBorder(center, direction));
+        // Clamp the ellipse to the viewport, the ring collapses where the lens sees the edge
+        QVector2D inner(center + direction);
+        if ((inner - center).lengthSquared() > (outer - center).lengthSquared())
+            inner = outer;
+        if (i > 0 && (inner != outer || lastInner != lastOuter)) {
+            // Ring segment between ellipse and border, counter clockwise
+            triangles << lastInner << lastOuter << outer;
+            triangles << lastInner << outer << inner;
+        }
+        lastInner = inner;
+        lastOuter = outer;
+    }
+    return triangles;
+}
+
+} // namespace HiddenAreaMesh
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
@@ -0,0 +1,45 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_HIDDENAREAMESH_P_H
+#define QT3DVIRTUALREALITY_HIDDENAREAMESH_P_H
+
+#include <QMatrix4x4>
+#include <QVector>
+#include <QVector2D>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+namespace HiddenAreaMesh {
+
+/*!
+ * \brief synthesize a hidden area mesh for sdks that do not provide one.
+ * Masks everything outside an ellipse around the optical axis of the eye. The ellipse reaches
+ * \a coverage times the distance to the farthest edge, so only the corners are masked.
+ * \param projection of the eye, the optical axis is where the projection is centered
+ * \param segments of the ellipse
+ * \return triangle list in normalized viewport coordinates of the eye, (0, 0) is bottom left
+ */
+QVector<QVector2D> synthesize(const QMatrix4x4 &projection, int segments = 32, float coverage = 1.1f);
+
+} // namespace HiddenAreaMesh
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_HIDDENAREAMESH_P_H
@@ -0,0 +1,211 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#include "meshoptimizer_p.h"
+
+#include <cmath>
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+namespace MeshOptimizer {
+
+namespace {
+
+// Constants as proposed by Tom Forsyth
+const int CacheSize = 32;
+const float CacheDecayPower = 1.5f;
+const float LastTriangleScore = 0.75f;
+const float ValenceBoostScale = 2.0f;
+const float ValenceBoostPower = 0.5f;
+
+float vertexScore(int cachePosition, int remainingTriangles)
+{
+    if (remainingTriangles == 0)
+        return -1.0f; // Vertex is not used by any remaining triangle
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // Vertex was used by the last triangle. Fixed score, so that emitting
+            // triangles in strip order is not preferred over fans.
+            score = LastTriangleScore;
+        } else {
+            const float scaler = 1.0f / (CacheSize - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+        }
+    }
+    // Boost vertices with few remaining triangles, to get rid of lonely vertices quickly.
+    score += ValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ValenceBoostPower);
+    return score;
+}
+
+} // anonymous
+
+void optimizeVertexCache(QVector<int> &indices, int vertexCount)
+{
+    const int triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0)
+        return;
+
+    // Vertex to triangle adjacency. The live triangles of vertex v are
+    // adjacency[offsets[v] .. offsets[v] + remaining[v]).
+    QVector<int> remaining(vertexCount, 0);
+    for (int i = 0; i < triangleCount * 3; ++i)
+        ++remaining[indices[i]];
+
+    QVector<int> offsets(vertexCount, 0);
+    for (int v = 1; v < vertexCount; ++v)
+        offsets[v] = offsets[v - 1] + remaining[v - 1];
+
+    QVector<int> adjacency(triangleCount * 3);
+    QVector<int> fill(offsets);
+    for (int t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k)
+            adjacency[fill[indices[t * 3 + k]]++] = t;
+    }
+
+    QVector<int> cachePosition(vertexCount, -1);
+    QVector<float> score(vertexCount);
+    for (int v = 0; v < vertexCount; ++v)
+        score[v] = vertexScore(-1, remaining[v]);
+
+    QVector<float> triangleScore(triangleCount);
+    QVector<bool> emitted(triangleCount, false);
+    int bestTriangle = -1;
+    float bestScore = -1.0f;
+    for (int t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+        if (triangleScore[t] > bestScore) {
+            bestScore = triangleScore[t];
+            bestTriangle = t;
+        }
+    }
+
+    QVector<int> cache;
+    cache.reserve(CacheSize + 3);
+    QVector<int> newCache;
+    newCache.reserve(CacheSize + 3);
+    QVector<int> output;
+    output.reserve(triangleCount * 3);
+    int nextUnemitted = 0;
+
+    while (output.size() < triangleCount * 3) {
+        if (bestTriangle < 0) {
+            // No candidate left in the cache, fall back to the best remaining triangle.
+            while (emitted[nextUnemitted])
+                ++nextUnemitted;
+            bestTriangle = nextUnemitted;
+            bestScore = triangleScore[bestTriangle];
+            for (int t = nextUnemitted + 1; t < triangleCount; ++t) {
+                if (!emitted[t] && triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        const int *triangle = indices.constData() + bestTriangle * 3;
+        emitted[bestTriangle] = true;
+
+        newCache.clear();
+        for (int k = 0; k < 3; ++k) {
+            const int v = triangle[k];
+            output.append(v);
+            newCache.append(v);
+
+            // Remove the triangle from the live adjacency of the vertex
+            int *begin = adjacency.data() + offsets[v];
+            int *end = begin + remaining[v];
+            for (int *it = begin; it != end; ++it) {
+                if (*it == bestTriangle) {
+                    *it = *(end - 1);
+                    --remaining[v];
+                    break;
+                }
+            }
+        }
+        for (int i = 0; i < cache.size(); ++i) {
+            const int v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                newCache.append(v);
+        }
+        cache.swap(newCache);
+
+        // Update scores of everything in the cache, including vertices that just dropped out of it.
+        for (int i = 0; i < cache.size(); ++i) {
+            const int v = cache[i];
+            cachePosition[v] = i < CacheSize ? i : -1;
+            score[v] = vertexScore(cachePosition[v], remaining[v]);
+        }
+        if (cache.size() > CacheSize)
+            cache.resize(CacheSize);
+
+        bestTriangle = -1;
+        bestScore = -1.0f;
+        for (int i = 0; i < cache.size(); ++i) {
+            const int v = cache[i];
+            const int *adjacent = adjacency.constData() + offsets[v];
+            for (int j = 0; j < remaining[v]; ++j) {
+                const int t = adjacent[j];
+                triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+    }
+    indices = output;
+}
+
+void optimizeVertexFetch(QVector<float> &vertices, QVector<int> &indices, int vertexSize)
+{
+    const int vertexCount = vertices.size() / vertexSize;
+    QVector<int> remap(vertexCount, -1);
+    QVector<float> reordered(vertices.size());
+    int next = 0;
+    for (int i = 0; i < indices.size(); ++i) {
+        const int index = indices[i];
+        if (remap[index] < 0) {
+            remap[index] = next;
+            memcpy(reordered.data() + next * vertexSize, vertices.constData() + index * vertexSize, sizeof(float) * vertexSize);
+            ++next;
+        }
+        indices[i] = remap[index];
+    }
+    reordered.resize(next * vertexSize);
+    vertices = reordered;
+}
+
+QByteArray packIndices(const QVector<int> &indices, bool shortIndices)
+{
+    if (!shortIndices)
+        return QByteArray(reinterpret_cast<const char*>(indices.constData()), sizeof(int) * indices.size());
+
+    QByteArray data;
+    data.resize(sizeof(quint16) * indices.size());
+    quint16 *out = reinterpret_cast<quint16*>(data.data());
+    for (int i = 0; i < indices.size(); ++i)
+        out[i] = static_cast<quint16>(indices[i]);
+    return data;
+}
+
+} // namespace MeshOptimizer
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
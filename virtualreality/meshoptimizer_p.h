@@ -0,0 +1,71 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#ifndef QT3DVIRTUALREALITY_MESHOPTIMIZER_P_H
+#define QT3DVIRTUALREALITY_MESHOPTIMIZER_P_H
+
+#include <QVector>
+#include <QByteArray>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * Helpers to prepare meshes delivered by the vr sdks for rendering.
+ * They are meant to run once at load time, results should be stored in the model cache of the backend.
+ */
+namespace MeshOptimizer {
+
+/*!
+ * \brief optimizeVertexCache reorders triangles to make best use of the post-transform vertex cache.
+ * Uses Tom Forsyth's "Linear-Speed Vertex Cache Optimisation". Vertices are not touched.
+ * \param indices triangle list, reordered in place
+ * \param vertexCount number of vertices referenced by \a indices
+ */
+void optimizeVertexCache(QVector<int> &indices, int vertexCount);
+
+/*!
+ * \brief optimizeVertexFetch reorders vertices in the order they are first referenced by \a indices
+ * and remaps the indices. Unreferenced vertices are dropped.
+ * Should run after optimizeVertexCache.
+ * \param vertices interleaved vertex data
+ * \param indices triangle list
+ * \param vertexSize number of floats per vertex
+ */
+void optimizeVertexFetch(QVector<float> &vertices, QVector<int> &indices, int vertexSize);
+
+/*!
+ * \brief canUseShortIndices
+ * \return true if all indices for \a vertexCount vertices fit into 16 bit.
+ * 0xFFFF is kept free, it is the primitive restart index.
+ */
+inline bool canUseShortIndices(int vertexCount)
+{
+    return vertexCount <= 0xFFFF;
+}
+
+/*!
+ * \brief packIndices converts \a indices to the raw data of an index buffer.
+ * \return 16 bit indices if \a shortIndices is set, otherwise 32 bit indices.
+ */
+QByteArray packIndices(const QVector<int> &indices, bool shortIndices);
+
+} // namespace MeshOptimizer
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_MESHOPTIMIZER_P_H
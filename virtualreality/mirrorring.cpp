@@ -0,0 +1,236 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "mirrorring_p.h"
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions_3_2_Core>
+#include <QDebug>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+MirrorRing::MirrorRing(int length)
+    : m_slots(qMax(2, length))
+    , m_latest(-1)
+    , m_acquired(-1)
+    , m_eye(2)
+    , m_scale(0.5)
+    , m_droppedFrames(0)
+    , m_enabled(0)
+    , m_funcs(nullptr)
+{
+    m_framebuffers[0] = 0;
+    m_framebuffers[1] = 0;
+}
+
+MirrorRing::~MirrorRing()
+{
+    // Gpu resources are freed in destroy(), there is no context here.
+}
+
+void MirrorRing::setConfiguration(int eye, qreal scale)
+{
+    QMutexLocker lock(&m_mutex);
+    m_eye = qBound(0, eye, 3);
+    m_scale = qBound(0.01, scale, 1.0);
+}
+
+void MirrorRing::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled ? 1 : 0);
+}
+
+void MirrorRing::produce(QVirtualRealityApiBackend *apibackend, const QVirtualRealityApiBackend::MirrorTexture *spectator)
+{
+    if (!m_enabled.load())
+        return;
+    if (!m_funcs) {
+        m_funcs = QOpenGLContext::currentContext()->versionFunctions<QOpenGLFunctions_3_2_Core>();
+        if (!m_funcs) {
+            qWarning() << "Could not get OpenGLFunctions 3.2, mirror will stay black";
+            return;
+        }
+        m_funcs->initializeOpenGLFunctions();
+        m_funcs->glGenFramebuffers(2, m_framebuffers);
+    }
+
+    int eye;
+    qreal scale;
+    {
+        QMutexLocker lock(&m_mutex);
+        eye = m_eye;
+        scale = m_scale;
+    }
+    QVirtualRealityApiBackend::MirrorTexture eyes[2];
+    int eyeCount = 1;
+    if (eye == 3) {
+        // The spectator is rendered at a lower rate, the mirror keeps showing its last frame in between
+        if (!spectator)
+            return;
+        eyes[0] = *spectator;
+    } else {
+        const int firstEye = eye == 2 ? 0 : eye;
+        eyeCount = eye == 2 ? 2 : 1;
+        for (int i = 0; i < eyeCount; ++i) {
+            if (!apibackend->getMirrorTexture(firstEye + i, eyes[i]))
+                return;
+        }
+    }
+
+    int target = -1;
+    {
+        QMutexLocker lock(&m_mutex);
+        for (int i = 0; i < m_slots.size(); ++i) {
+            Slot &slot = m_slots[i];
+            if (i == m_latest || slot.reading)
+                continue;
+            if (slot.read != 0) {
+                // Zero timeout: only poll, never wait for the mirror
+                const GLenum result = m_funcs->glClientWaitSync(slot.read, 0, 0);
+                if (result == GL_TIMEOUT_EXPIRED)
+                    continue;
+                m_funcs->glDeleteSync(slot.read);
+                slot.read = 0;
+            }
+            target = i;
+            break;
+        }
+    }
+    if (target < 0) {
+        // The mirror is behind, it keeps showing an older frame
+        m_droppedFrames.ref();
+        return;
+    }
+
+    const QSize eyeSize(qMax(1, qRound(eyes[0].eyeRect.width() * scale)),
+                        qMax(1, qRound(qAbs(eyes[0].eyeRect.height()) * scale)));
+    const QSize size(eyeSize.width() * eyeCount, eyeSize.height());
+
+    // Neither latest nor acquired, the mirror can not see this slot until it is published.
+    Slot &slot = m_slots[target];
+    if (slot.texture == 0 || slot.size != size) {
+        if (slot.texture == 0)
+            m_funcs->glGenTextures(1, &slot.texture);
+        m_funcs->glBindTexture(GL_TEXTURE_2D, slot.texture);
+        m_funcs->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.width(), size.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        m_funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        m_funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        m_funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        m_funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        m_funcs->glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (slot.written != 0) {
+        m_funcs->glDeleteSync(slot.written);
+        slot.written = 0;
+    }
+
+    m_funcs->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffers[1]);
+    m_funcs->glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slot.texture, 0);
+    m_funcs->glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffers[0]);
+    for (int i = 0; i < eyeCount; ++i) {
+        const QVirtualRealityApiBackend::MirrorTexture &source = eyes[i];
+        if (source.layer >= 0)
+            m_funcs->glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, source.textureId, 0, source.layer);
+        else
+            m_funcs->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, source.textureId, 0);
+        // A negative height flips upside down eyes while blitting
+        const QRect &r = source.eyeRect;
+        m_funcs->glBlitFramebuffer(r.x(), r.y(), r.x() + r.width(), r.y() + r.height(),
+                                   i * eyeSize.width(), 0, (i + 1) * eyeSize.width(), eyeSize.height(),
+                                   GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    }
+    m_funcs->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    GLsync written = m_funcs->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // Other contexts can only wait for fences that have been flushed
+    m_funcs->glFlush();
+
+    QMutexLocker lock(&m_mutex);
+    slot.size = size;
+    slot.written = written;
+    m_latest = target;
+}
+
+void MirrorRing::destroy()
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_funcs)
+        return;
+    for (Slot &slot : m_slots) {
+        if (slot.written != 0)
+            m_funcs->glDeleteSync(slot.written);
+        if (slot.read != 0)
+            m_funcs->glDeleteSync(slot.read);
+        if (slot.texture != 0)
+            m_funcs->glDeleteTextures(1, &slot.texture);
+        slot = Slot();
+    }
+    m_funcs->glDeleteFramebuffers(2, m_framebuffers);
+    m_framebuffers[0] = 0;
+    m_framebuffers[1] = 0;
+    m_latest = -1;
+    m_funcs = nullptr;
+}
+
+bool MirrorRing::acquire(QOpenGLFunctions_3_2_Core *funcs, GLuint &texture, QSize &size)
+{
+    GLsync written;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_latest < 0)
+            return false;
+        Slot &slot = m_slots[m_latest];
+        slot.reading = true;
+        m_acquired = m_latest;
+        texture = slot.texture;
+        size = slot.size;
+        written = slot.written;
+    }
+    // The headset does not touch a slot while it is read, the fence stays valid.
+    // Only the gpu of the mirror waits here.
+    funcs->glWaitSync(written, 0, GL_TIMEOUT_IGNORED);
+    return true;
+}
+
+void MirrorRing::release(QOpenGLFunctions_3_2_Core *funcs)
+{
+    GLsync read = funcs->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    funcs->glFlush();
+
+    QMutexLocker lock(&m_mutex);
+    if (m_acquired < 0) {
+        funcs->glDeleteSync(read);
+        return;
+    }
+    Slot &slot = m_slots[m_acquired];
+    // The same frame may be shown several times, only the last read matters
+    if (slot.read != 0)
+        funcs->glDeleteSync(slot.read);
+    slot.read = read;
+    slot.reading = false;
+    m_acquired = -1;
+}
+
+int MirrorRing::droppedFrames() const
+{
+    return m_droppedFrames.load();
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
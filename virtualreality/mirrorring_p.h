@@ -0,0 +1,108 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_MIRRORRING_P_H
+#define QT3DVIRTUALREALITY_MIRRORRING_P_H
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QSize>
+#include <QVector>
+#include <qopengl.h>
+
+#include "qvirtualrealityapibackend.h"
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLFunctions_3_2_Core;
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The MirrorRing class hands the eyes of the headset to a mirror on another context and thread.
+ * After each submit the render thread of the headset copies the mirror texture of the backend, optionally
+ * downscaled, into a free texture of the ring and publishes it with a fence. The mirror thread always picks
+ * the latest copy, its gpu waits for the fence and it returns the texture with a fence of its own.
+ * A texture is only overwritten after that fence signaled. Both sides only poll, the headset never waits
+ * for the mirror. If no texture is free, the copy is skipped and counted as dropped.
+ * Contexts of both sides must share resources.
+ */
+class MirrorRing
+{
+public:
+    explicit MirrorRing(int length = 3);
+    ~MirrorRing();
+
+    /*!
+     * \brief setConfiguration for the copies started from now on. Can be called from any thread.
+     * \param eye 0 is the left eye, 1 the right eye, 2 both side by side, 3 the spectator
+     * \param scale of the copy relative to the eye texture
+     */
+    void setConfiguration(int eye, qreal scale);
+    /*!
+     * \brief setEnabled while a mirror is shown, produce does nothing otherwise. Can be called from any thread.
+     */
+    void setEnabled(bool enabled);
+
+    /*!
+     * \brief produce copies the frame submitted last. Render thread of the headset, after swapToHeadset.
+     * \param spectator texture if the spectator was rendered this frame, nullptr otherwise
+     */
+    void produce(QVirtualRealityApiBackend *apibackend, const QVirtualRealityApiBackend::MirrorTexture *spectator = nullptr);
+    /*!
+     * \brief destroy deletes all textures and fences. Context of the headset must be current,
+     * the mirror must not use the ring anymore.
+     */
+    void destroy();
+
+    /*!
+     * \brief acquire the latest copy on the mirror thread. The gpu of the mirror context waits for the copy.
+     * \return false if nothing has been copied yet
+     */
+    bool acquire(QOpenGLFunctions_3_2_Core *funcs, GLuint &texture, QSize &size);
+    /*!
+     * \brief release the texture acquired last, after all commands reading it have been issued.
+     */
+    void release(QOpenGLFunctions_3_2_Core *funcs);
+
+    int droppedFrames() const;
+
+private:
+    struct Slot {
+        Slot() : texture(0), written(0), read(0), reading(false) {}
+        GLuint texture;
+        QSize size;
+        GLsync written; // Created and deleted by the headset
+        GLsync read; // Created by the mirror, deleted by whoever replaces it
+        bool reading;
+    };
+
+    mutable QMutex m_mutex; // Guards the slots and the configuration, never held while waiting
+    QVector<Slot> m_slots;
+    int m_latest;
+    int m_acquired;
+    int m_eye;
+    qreal m_scale;
+    QAtomicInt m_droppedFrames;
+    QAtomicInt m_enabled;
+    GLuint m_framebuffers[2]; // Read and draw, of the headset context
+    QOpenGLFunctions_3_2_Core *m_funcs;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_MIRRORRING_P_H
@@ -14,7 +14,13 @@
 
 #include "qheadmounteddisplay.h"
 #include <Qt3DQuick/QQmlAspectEngine>
+#include <Qt3DCore/QEntity>
+#include <Qt3DCore/QTransform>
+#include <Qt3DRender/qattribute.h>
+#include <Qt3DRender/qabstracttexture.h>
 #include <Qt3DRender/qcamera.h>
+#include <Qt3DRender/qgeometry.h>
+#include <Qt3DRender/qgeometryrenderer.h>
 #include <Qt3DRender/qrenderaspect.h>
 #include <Qt3DRender/qrendersurfaceselector.h>
 #include <Qt3DRender/private/qrendersurfaceselector_p.h>
@@ -26,6 +32,8 @@
 #include <qqmlincubator.h>
 #include <QGuiApplication>
 #include <QScreen>
+#include <QtMath>
+#include <QSet>
 
 #include <QtGui/qopenglcontext.h>
 #include <QSurface>
@@ -33,8 +41,32 @@
 #include <Qt3DRender/QRenderAspect>
 #include <Qt3DRender/private/qrenderaspect_p.h>
 #include <Qt3DCore/private/qabstractaspectjobmanager_p.h>
+#include <Qt3DRender/private/nodemanagers_p.h>
+#include <Qt3DRender/private/gltexturemanager_p.h>
+#include <Qt3DRender/private/gltexture_p.h>
+#include <Qt3DCore/private/qaspectengine_p.h>
+#include <Qt3DCore/private/qchangearbiter_p.h>
+#include <Qt3DCore/private/qscene_p.h>
 #include "frontend/qvirtualrealitycamera.h"
 #include "frontend/qvirtualrealitymesh.h"
+#include "frontend/qtrackedobjectmaterial.h"
+#include "frontend/qtrackedobjectslayer.h"
+#include "frontend/qstereophongmaterial.h"
+#include "frontend/qhiddenareamask.h"
+#include "frontend/qfoveatedcomposite.h"
+#include "frontend/qtemporalresolve.h"
+#include "frontend/qfarfieldcomposite.h"
+#include "frontend/qstereolevelofdetail.h"
+#include "frontend/updatelevelofdetailjob_p.h"
+#include "frontend/qocclusionvolume.h"
+#include "frontend/occlusioncullingjob_p.h"
+#include "frontend/cullingstatisticsjob_p.h"
+#include "frontend/qcompositorlayer.h"
+#include "mirrorring_p.h"
+#include "framecapture_p.h"
+#include "depthreadback_p.h"
+#include "geometrycache_p.h"
+#include "frametiming_p.h"
 #include <QOpenGLDebugLogger>
 
 QT_BEGIN_NAMESPACE
@@ -68,6 +100,39 @@ private:
     QHeadMountedDisplay *m_hmd;
 };
 
+// Dynamic property marking renderers and attributes whose instancing was doubled for single pass stereo
+const char StereoInstancedProperty[] = "_q_stereoInstanced";
+
+#ifndef GL_ZERO_TO_ONE
+#define GL_ZERO_TO_ONE 0x935F
+#endif
+typedef void (QOPENGLF_APIENTRYP ClipControlFunction)(GLenum origin, GLenum depth);
+
+QMatrix4x4 worldMatrix(Qt3DCore::QEntity *entity)
+{
+    QMatrix4x4 world;
+    for(; entity; entity = entity->parentEntity()) {
+        const Qt3DCore::QComponentVector components = entity->components();
+        for(Qt3DCore::QComponent *component : components) {
+            if(Qt3DCore::QTransform *transform = qobject_cast<Qt3DCore::QTransform*>(component)) {
+                world = transform->matrix() * world;
+                break;
+            }
+        }
+    }
+    return world;
+}
+
+// Sphere in coordinates of entity to the world, the radius grows with the largest scale
+void worldBoundingSphere(Qt3DCore::QEntity *entity, const QVector3D &center, float radius, QVector3D &worldCenter, float &worldRadius)
+{
+    const QMatrix4x4 world = worldMatrix(entity);
+    const float scale = qMax(world.column(0).toVector3D().length(),
+                             qMax(world.column(1).toVector3D().length(), world.column(2).toVector3D().length()));
+    worldCenter = world * center;
+    worldRadius = radius * scale;
+}
+
 } // anonymous
 
 QHeadMountedDisplay::QHeadMountedDisplay(int hmdId, const QHeadMountedDisplayFormat &formathmd, QVirtualRealityApi *api, QVirtualRealityApiBackend *apibackend)
@@ -86,12 +151,49 @@ QHeadMountedDisplay::QHeadMountedDisplay(int hmdId, const QHeadMountedDisplayFor
     , m_context(nullptr)
     , m_surface(new QOffscreenSurface)
     , m_rootItem(nullptr)
+    , m_stereoMode(formathmd.renderTargetLayout() == QHeadMountedDisplayFormat::EyeTextureArray ? SinglePassLayered : MultiPass)
+    , m_format(formathmd)
+    , m_reverseDepth(false)
+    , m_temporalScale(0.7)
+    , m_mirrorRing(nullptr)
+    , m_frameCapture(new FrameCapture)
+    , m_frameTiming(new FrameTiming)
+    , m_frameCount(0)
+    , m_spectatorInterval(0)
+    , m_spectatorSize(1280, 720)
+    , m_spectatorActive(false)
+    , m_reuseIdleFrames(false)
+    , m_idleRotationThreshold(0.2)
+    , m_idleTranslationThreshold(0.002)
+    , m_maxReusedFrames(45)
+    , m_reusedFrames(0)
+    , m_reusedFrameCount(0)
+    , m_posesFed(true)
+    , m_sceneChanges(0)
+    , m_renderedSceneChanges(0)
+    , m_levelOfDetailPending(false)
+    , m_geometrySharing(true)
+    , m_geometryCache(new GeometryCache)
+    , m_occlusionCulling(false)
+    , m_occlusionBufferSize(256, 256)
+    , m_depthReadback(new DepthReadback)
+    , m_occlusionViewProjectionValid(false)
+    , m_renderedOcclusionViewProjectionValid(false)
+    , m_occlusionPending(false)
+    , m_submittedEntities(0)
+    , m_visibleEntities(0)
+    , m_eyeDraws(0)
 {
+    // Everything at full resolution until the backend is initialized
+    m_foveationProfile.leftCenter = QRectF(0.0, 0.0, 1.0, 1.0);
+    m_foveationProfile.rightCenter = QRectF(0.0, 0.0, 1.0, 1.0);
+    m_foveationProfile.peripheryScale = 1.0f;
+
     //Note: m_apibackend is not yet initialized here. Wait for openGLContext creation
 
     QSurfaceFormat format;
     // Qt Quick may need a depth and stencil buffer. Always make sure these are available.
-    format.setDepthBufferSize(16);
+    format.setDepthBufferSize(24);
     format.setStencilBufferSize(8);
     format.setProfile(QSurfaceFormat::CoreProfile);
     format.setOption(QSurfaceFormat::DebugContext);
@@ -118,6 +220,19 @@ QHeadMountedDisplay::QHeadMountedDisplay(int hmdId, const QHeadMountedDisplayFor
     }, Qt::DirectConnection);
     logger->enableMessages();
     logger->startLogging(QOpenGLDebugLogger::SynchronousLogging);
+
+    // Reverse depth only gains precision with a depth range of 0..1, near maps to 1 then
+    if(m_format.reverseDepth()) {
+        if(m_context->format().version() >= qMakePair(4, 5) || m_context->hasExtension(QByteArrayLiteral("GL_ARB_clip_control"))) {
+            ClipControlFunction clipControl = reinterpret_cast<ClipControlFunction>(m_context->getProcAddress("glClipControl"));
+            if(clipControl) {
+                clipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+                m_reverseDepth = true;
+            }
+        }
+        if(!m_reverseDepth)
+            qWarning() << "Reverse depth needs OpenGL 4.5 or GL_ARB_clip_control, using the standard depth mapping";
+    }
     emit surfaceChanged(m_surface);
 
     m_engine.reset(new Qt3DCore::Quick::QQmlAspectEngine);
@@ -128,6 +243,7 @@ QHeadMountedDisplay::QHeadMountedDisplay(int hmdId, const QHeadMountedDisplayFor
     m_virtualRealityAspect->setHeadmountedDisplay(this);
     //m_virtualRealityAspect->setVirtualRealityApi(m_api);
     m_virtualRealityAspect->setVirtualRealityApiBackend(m_apibackend);
+    m_virtualRealityAspect->setRenderAspect(m_renderAspect);
 
     m_engine->aspectEngine()->registerAspect(m_renderAspect);
     m_engine->aspectEngine()->registerAspect(m_inputAspect);
@@ -138,6 +254,18 @@ QHeadMountedDisplay::QHeadMountedDisplay(int hmdId, const QHeadMountedDisplayFor
 
 QHeadMountedDisplay::~QHeadMountedDisplay()
 {
+    m_context->makeCurrent(m_surface);
+    m_frameCapture->destroy();
+    delete m_frameCapture;
+    m_depthReadback->destroy();
+    delete m_depthReadback;
+    delete m_geometryCache;
+    m_frameTiming->destroy();
+    delete m_frameTiming;
+    if(m_mirrorRing) {
+        m_mirrorRing->destroy();
+        delete m_mirrorRing;
+    }
     if(m_surface)
         delete m_surface;
 }
@@ -167,6 +295,17 @@ void QHeadMountedDisplay::setSource(const QUrl &source)
 
         qmlRegisterType<QVirtualrealityCamera>("vr", 2, 0, "VrCamera");
         qmlRegisterType<QVirtualRealityMesh>("vr", 2, 0, "TrackedObjectMesh");
+        qmlRegisterType<QTrackedObjectMaterial>("vr", 2, 0, "TrackedObjectMaterial");
+        qmlRegisterType<QTrackedObjectsLayer>("vr", 2, 0, "TrackedObjectsLayer");
+        qmlRegisterType<QStereoPhongMaterial>("vr", 2, 0, "StereoPhongMaterial");
+        qmlRegisterType<QHiddenAreaMask>("vr", 2, 0, "HiddenAreaMask");
+        qmlRegisterType<QFoveatedComposite>("vr", 2, 0, "FoveatedComposite");
+        qmlRegisterType<QTemporalResolve>("vr", 2, 0, "TemporalResolve");
+        qmlRegisterType<QFarFieldComposite>("vr", 2, 0, "FarFieldComposite");
+        qmlRegisterType<QStereoLevelOfDetail>("vr", 2, 0, "StereoLevelOfDetail");
+        qmlRegisterType<QOcclusionVolume>("vr", 2, 0, "OcclusionVolume");
+        qmlRegisterType<QCompositorLayer>("vr", 2, 0, "CompositorLayer");
+        qmlRegisterUncreatableType<QHeadMountedDisplay>("vr", 2, 0, "HeadMountedDisplay", "Use _hmd");
         m_engine->setSource(m_source);
 
         // Set the QQmlIncubationController on the window
@@ -215,6 +354,69 @@ QOpenGLContext *QHeadMountedDisplay::context()
     return m_context;
 }
 
+QHeadMountedDisplay::StereoMode QHeadMountedDisplay::stereoMode() const
+{
+    return m_stereoMode;
+}
+
+void QHeadMountedDisplay::setStereoMode(QHeadMountedDisplay::StereoMode stereoMode)
+{
+    if (m_stereoMode == stereoMode)
+        return;
+    if ((stereoMode == SinglePassLayered) != eyeTextureArray()) {
+        qWarning() << "Stereo mode" << stereoMode << "does not match the render target layout" << m_format.renderTargetLayout();
+        return;
+    }
+
+    m_stereoMode = stereoMode;
+    Q_EMIT stereoModeChanged(stereoMode);
+}
+
+bool QHeadMountedDisplay::eyeTextureArray() const
+{
+    return m_format.renderTargetLayout() == QHeadMountedDisplayFormat::EyeTextureArray;
+}
+
+bool QHeadMountedDisplay::reverseDepth() const
+{
+    return m_reverseDepth;
+}
+
+QRectF QHeadMountedDisplay::leftFoveaRect() const
+{
+    return m_foveationProfile.leftCenter;
+}
+
+QRectF QHeadMountedDisplay::rightFoveaRect() const
+{
+    return m_foveationProfile.rightCenter;
+}
+
+qreal QHeadMountedDisplay::foveaPeripheryScale() const
+{
+    return m_foveationProfile.peripheryScale;
+}
+
+qreal QHeadMountedDisplay::temporalScale() const
+{
+    return m_temporalScale;
+}
+
+void QHeadMountedDisplay::setTemporalScale(qreal temporalScale)
+{
+    temporalScale = qBound(0.25, temporalScale, 1.0);
+    if (qFuzzyCompare(m_temporalScale, temporalScale))
+        return;
+
+    m_temporalScale = temporalScale;
+    Q_EMIT temporalScaleChanged(temporalScale);
+}
+
+bool QHeadMountedDisplay::compositorLayersSupported() const
+{
+    return m_apibackend->supportsCompositorLayers();
+}
+
 void QHeadMountedDisplay::onSceneCreated(QObject *rootObject)
 {
     Q_ASSERT(rootObject);
@@ -237,10 +439,18 @@ void QHeadMountedDisplay::onSceneCreated(QObject *rootObject)
     if(m_rootItem) {
         QVirtualrealityCamera *vrCamera = m_rootItem->findChild<QVirtualrealityCamera *>();
         if(vrCamera) {
-            QMatrix4x4 projL;
-            QMatrix4x4 projR;
-            m_apibackend->getProjectionMatrices(projL, projR);
-            vrCamera->setProjections(projL, projR);
+            // The compositor reprojects with the depth mapping actually used, near and far may change any time
+            connect(vrCamera, &QVirtualrealityCamera::projectionsChanged, this, [this](const QMatrix4x4 &left, const QMatrix4x4 &right) {
+                m_apibackend->setDepthProjections(left, right, m_reverseDepth);
+            });
+            vrCamera->setReverseDepth(m_reverseDepth);
+            QVirtualRealityApiBackend::ProjectionTangents tangentsL;
+            QVirtualRealityApiBackend::ProjectionTangents tangentsR;
+            m_apibackend->getProjectionTangents(tangentsL, tangentsR);
+            vrCamera->setProjectionTangents(tangentsL, tangentsR);
+            m_foveationProfile = m_apibackend->foveationProfile();
+            vrCamera->setFoveaRects(m_foveationProfile.leftCenter, m_foveationProfile.rightCenter);
+            Q_EMIT foveationProfileChanged();
             vrCamera->setLeftNormalizedViewportRect(QRectF(0.0f, 0.0f, 0.5f, 1.0f));
             vrCamera->setRightNormalizedViewportRect(QRectF(0.5f, 0.0f, 0.5f, 1.0f));
         } else {
@@ -285,28 +495,628 @@ void QHeadMountedDisplay::run() {
     //TODO: QVrSelector. This is the object with all parameters then
     QVirtualrealityCamera *vrCamera(nullptr);
     QList<QVirtualRealityMesh*> vrGeometries;
+    QList<QTrackedObjectsLayer*> trackedObjectsLayers;
+    QList<QHiddenAreaMask*> hiddenAreaMasks;
     if(m_rootItem) {
         vrCamera = m_rootItem->findChild<QVirtualrealityCamera *>();
         vrGeometries = m_rootItem->findChildren<QVirtualRealityMesh*>();
+        trackedObjectsLayers = m_rootItem->findChildren<QTrackedObjectsLayer*>();
+        hiddenAreaMasks = m_rootItem->findChildren<QHiddenAreaMask*>();
+    }
+    // Idle: nothing changed and nobody moved, show the last frame again without running Qt3D
+    const bool idle = m_reuseIdleFrames && posesIdle();
+    if(idle && !m_posesFed && m_reusedFrames < m_maxReusedFrames && !sceneChanged()) {
+        updateCompositorLayers();
+        if(m_apibackend->resubmitFrame()) {
+            ++m_reusedFrames;
+            ++m_reusedFrameCount;
+            // Keeps recordings at a constant frame rate
+            m_frameCapture->capture(m_apibackend);
+            finishFrame();
+            return;
+        }
+    }
+
+    // The spectator is drawn every m_spectatorInterval frames, StereoFrameGraph enables its branch while active
+    const bool spectatorActive = m_spectatorInterval > 0 && m_frameCount % m_spectatorInterval == 0;
+    if(spectatorActive != m_spectatorActive) {
+        m_spectatorActive = spectatorActive;
+        emit spectatorActiveChanged(spectatorActive);
     }
+    updateStereoInstancing();
+    // Before the backend sees new buffers, so that duplicates are never generated
+    updateGeometrySharing();
+    m_frameTiming->begin(m_spectatorActive);
     m_apibackend->bindFrambufferObject(m_hmdId);
     for(QList<QVirtualRealityMesh*>::iterator iter(vrGeometries.begin()); iter != vrGeometries.end(); ++iter) {
         (*iter)->setVrApiBackendTmp(m_apibackend);
     }
+    for(QList<QHiddenAreaMask*>::iterator iter(hiddenAreaMasks.begin()); iter != hiddenAreaMasks.end(); ++iter) {
+        (*iter)->setVrApiBackendTmp(m_apibackend);
+    }
     //static_cast<Qt3DRender::QRenderAspectPrivate*>(Qt3DRender::QRenderAspectPrivate::get(m_renderAspect))->jobManager()->waitForAllJobs();
+    // Changes from here on are rendered by the next frame, including the poses fed below
+    m_renderedSceneChanges = m_sceneChanges.load();
+    // The occlusion depth of this frame is drawn with the camera as it is now, before vrCamera->update()
+    m_renderedOcclusionViewProjection = m_occlusionViewProjection;
+    m_renderedOcclusionViewProjectionValid = m_occlusionViewProjectionValid;
     static_cast<Qt3DRender::QRenderAspectPrivate*>(Qt3DRender::QRenderAspectPrivate::get(m_renderAspect))->renderSynchronous();
-    QMatrix4x4 leftEye;
-    QMatrix4x4 rightEye;
-    m_apibackend->getEyeMatrices(leftEye, rightEye);
-    if(vrCamera != nullptr) {
-        vrCamera->update(leftEye, rightEye);
-        vrCamera->setVrBackendTmp(m_apibackend); // only for transforms
+    // While idle the scene keeps its poses, so it stays unchanged. A refresh after maxReusedFrames catches up.
+    m_posesFed = !idle || m_reusedFrames >= m_maxReusedFrames;
+    m_reusedFrames = 0;
+    if(m_posesFed) {
+        QMatrix4x4 leftEye;
+        QMatrix4x4 rightEye;
+        m_apibackend->getEyeMatrices(leftEye, rightEye);
+        if(vrCamera != nullptr) {
+            // Same size as the temporal regions of StereoFrameGraph
+            const QSize eyeSize(renderTargetSize().width() / 2, renderTargetSize().height());
+            vrCamera->setTemporalJitter(m_stereoMode == MultiPassTemporal ? QSize(qCeil(eyeSize.width() * m_temporalScale),
+                                                                                   qCeil(eyeSize.height() * m_temporalScale))
+                                                                          : QSize());
+            vrCamera->update(leftEye, rightEye);
+            vrCamera->setVrBackendTmp(m_apibackend); // only for transforms
+            updateLevelsOfDetail(vrCamera);
+            updateOcclusionCulling(vrCamera);
+            updateCullingStatistics(vrCamera);
+        }
+        // Poses of this frame go into one transform buffer per layer, drawn next frame with a single draw call
+        for(QList<QTrackedObjectsLayer*>::iterator iter(trackedObjectsLayers.begin()); iter != trackedObjectsLayers.end(); ++iter) {
+            (*iter)->setVrApiBackendTmp(m_apibackend);
+            (*iter)->update();
+        }
+        if(m_reuseIdleFrames)
+            rememberIdlePoses();
     }
+    uploadTrackedObjectTextures(vrGeometries, trackedObjectsLayers);
+    updateCompositorLayers();
+    readOcclusionDepth();
     m_fbo->bindDefault();
     m_apibackend->swapToHeadset();
+    // Copies the submitted eyes for a QMirrorWindow, never waits for it
+    if(m_mirrorRing) {
+        QVirtualRealityApiBackend::MirrorTexture spectator;
+        const bool spectatorRendered = m_spectatorActive && spectatorMirrorTexture(spectator);
+        m_mirrorRing->produce(m_apibackend, spectatorRendered ? &spectator : nullptr);
+    }
+    m_frameCapture->capture(m_apibackend);
+    m_frameTiming->end();
+    finishFrame();
+}
+
+void QHeadMountedDisplay::finishFrame()
+{
+    if(++m_frameCount % qMax(1, qRound(refreshRate())) == 0)
+        emit frameTimingChanged();
     emit requestRun();
 }
 
+bool QHeadMountedDisplay::posesIdle()
+{
+    const QMatrix4x4 headPose(m_apibackend->headPose(m_hmdId));
+    QList<int> trackedObjects(m_apibackend->currentlyTrackedObjects());
+    if(trackedObjects.size() != m_idleTrackedObjectPoses.size())
+        return false;
+    // Rotation angle and translation between two poses, each within the thresholds
+    const qreal cosHalfThreshold = qCos(qDegreesToRadians(m_idleRotationThreshold) * 0.5);
+    auto moved = [this, cosHalfThreshold](const QMatrix4x4 &from, const QMatrix4x4 &to) {
+        if((to.column(3).toVector3D() - from.column(3).toVector3D()).length() > m_idleTranslationThreshold)
+            return true;
+        const QQuaternion a(QQuaternion::fromRotationMatrix(from.toGenericMatrix<3, 3>()));
+        const QQuaternion b(QQuaternion::fromRotationMatrix(to.toGenericMatrix<3, 3>()));
+        return qAbs(QQuaternion::dotProduct(a, b)) < cosHalfThreshold;
+    };
+    if(moved(m_idleHeadPose, headPose))
+        return false;
+    for(int id : qAsConst(trackedObjects)) {
+        QHash<int, QMatrix4x4>::const_iterator idlePose(m_idleTrackedObjectPoses.constFind(id));
+        if(idlePose == m_idleTrackedObjectPoses.constEnd())
+            return false;
+        QMatrix4x4 pose;
+        m_apibackend->getTrackedObject(id, pose);
+        if(moved(*idlePose, pose))
+            return false;
+    }
+    return true;
+}
+
+void QHeadMountedDisplay::rememberIdlePoses()
+{
+    m_idleHeadPose = m_apibackend->headPose(m_hmdId);
+    m_idleTrackedObjectPoses.clear();
+    const QList<int> trackedObjects(m_apibackend->currentlyTrackedObjects());
+    for(int id : trackedObjects) {
+        QMatrix4x4 pose;
+        m_apibackend->getTrackedObject(id, pose);
+        m_idleTrackedObjectPoses.insert(id, pose);
+    }
+}
+
+bool QHeadMountedDisplay::sceneChanged()
+{
+    // Every change of a frontend node passes the arbiter, it only exists once the scene was set
+    if(!m_sceneChangesConnection) {
+        Qt3DCore::QAspectEnginePrivate *engine = Qt3DCore::QAspectEnginePrivate::get(m_engine->aspectEngine());
+        Qt3DCore::QChangeArbiter *arbiter = dynamic_cast<Qt3DCore::QChangeArbiter*>(engine->m_scene->arbiter());
+        if(!arbiter)
+            return true;
+        m_sceneChangesConnection = connect(arbiter, &Qt3DCore::QChangeArbiter::receivedChange,
+                                           this, [this]() { m_sceneChanges.ref(); }, Qt::DirectConnection);
+        return true;
+    }
+    return m_sceneChanges.load() != m_renderedSceneChanges;
+}
+
+void QHeadMountedDisplay::updateGeometrySharing()
+{
+    if(m_geometrySharing && m_rootItem)
+        m_geometryCache->update(qobject_cast<Qt3DCore::QNode*>(m_rootItem), m_rootItem->findChildren<Qt3DRender::QGeometryRenderer*>());
+}
+
+void QHeadMountedDisplay::updateLevelsOfDetail(QVirtualrealityCamera *vrCamera)
+{
+    UpdateLevelOfDetailJob *job = m_virtualRealityAspect->levelOfDetailJob();
+    if(m_levelOfDetailPending) {
+        QVector<int> levels;
+        if(!job->takeLevels(levels))
+            return; // The job has not run since the last snapshot
+        m_levelOfDetailPending = false;
+        for(int i = 0; i < levels.size() && i < m_levelOfDetailComponents.size(); ++i) {
+            if(m_levelOfDetailComponents.at(i))
+                m_levelOfDetailComponents.at(i)->setCurrentIndex(levels.at(i));
+        }
+        // Qt3D may sync the new meshes before the next frame starts
+        updateGeometrySharing();
+    }
+
+    // Snapshot for the next evaluation, the job must not touch frontend nodes
+    m_levelOfDetailComponents.clear();
+    const QList<QStereoLevelOfDetail*> components = m_rootItem->findChildren<QStereoLevelOfDetail*>();
+    if(components.isEmpty())
+        return;
+    QVector<UpdateLevelOfDetailJob::Entry> entries;
+    entries.reserve(components.size());
+    for(QStereoLevelOfDetail *component : components) {
+        const QVector<Qt3DCore::QEntity*> entities = component->entities();
+        if(!component->isEnabled() || entities.isEmpty())
+            continue;
+        UpdateLevelOfDetailJob::Entry entry;
+        worldBoundingSphere(entities.first(), component->center(), component->radius(), entry.center, entry.radius);
+        entry.thresholds = component->thresholds();
+        entry.hysteresis = component->hysteresis();
+        entry.currentIndex = component->currentIndex();
+        entries.append(entry);
+        m_levelOfDetailComponents.append(component);
+    }
+    UpdateLevelOfDetailJob::View view;
+    view.position = vrCamera->centerEyePosition();
+    // Pixel density in the center of the eye, from the vertical scale of its projection
+    view.pixelsPerTangent = 0.5f * renderTargetSize().height() * vrCamera->leftProjection()(1, 1);
+    job->setInput(entries, view);
+    m_levelOfDetailPending = true;
+}
+
+void QHeadMountedDisplay::readOcclusionDepth()
+{
+    // Drawn this frame with the occlusion camera of the last update
+    if(!m_occlusionCulling || !m_renderedOcclusionViewProjectionValid)
+        return;
+    QOpenGLTexture *texture = renderedTexture(m_occlusionDepthTexture);
+    if(!texture)
+        return;
+    m_depthReadback->read(texture->textureId(), QSize(texture->width(), texture->height()), m_renderedOcclusionViewProjection);
+}
+
+void QHeadMountedDisplay::updateOcclusionCulling(QVirtualrealityCamera *vrCamera)
+{
+    if(!m_occlusionCulling)
+        return;
+    // The next frame draws the occlusion depth with this view
+    m_occlusionViewProjection = vrCamera->occlusionProjection() * vrCamera->occlusionViewMatrix();
+    m_occlusionViewProjectionValid = true;
+
+    OcclusionCullingJob *job = m_virtualRealityAspect->occlusionCullingJob();
+    if(m_occlusionPending) {
+        QVector<bool> occluded;
+        if(!job->takeOcclusion(occluded))
+            return; // The job has not run since the last snapshot
+        m_occlusionPending = false;
+        for(int i = 0; i < occluded.size() && i < m_occlusionComponents.size(); ++i) {
+            if(m_occlusionComponents.at(i))
+                m_occlusionComponents.at(i)->setOccluded(occluded.at(i));
+        }
+    }
+
+    // The newest depth is reprojected to the current head pose every frame, also while the next readback is in flight
+    m_depthReadback->update();
+    if(m_depthReadback->frame().size.isEmpty())
+        return;
+
+    // Snapshot for the next evaluation, the job must not touch frontend nodes
+    m_occlusionComponents.clear();
+    const QList<QOcclusionVolume*> components = m_rootItem->findChildren<QOcclusionVolume*>();
+    if(components.isEmpty())
+        return;
+    QVector<OcclusionCullingJob::Entry> entries;
+    entries.reserve(components.size());
+    for(QOcclusionVolume *component : components) {
+        const QVector<Qt3DCore::QEntity*> entities = component->entities();
+        if(!component->isEnabled() || entities.isEmpty()) {
+            component->setOccluded(false);
+            continue;
+        }
+        OcclusionCullingJob::Entry entry;
+        worldBoundingSphere(entities.first(), component->center(), component->radius(), entry.center, entry.radius);
+        entries.append(entry);
+        m_occlusionComponents.append(component);
+    }
+    // The depth is drawn between the eyes, each eye sees a little behind thin occluders
+    QVector<OcclusionCullingJob::View> views(2);
+    views[0].viewMatrix = vrCamera->leftViewMatrix();
+    views[0].projection = vrCamera->leftProjection();
+    views[1].viewMatrix = vrCamera->rightViewMatrix();
+    views[1].projection = vrCamera->rightProjection();
+    for(OcclusionCullingJob::View &view : views)
+        view.reverseDepth = m_reverseDepth;
+    job->setInput(m_depthReadback->frame(), entries, views);
+    m_occlusionPending = true;
+}
+
+void QHeadMountedDisplay::updateCullingStatistics(QVirtualrealityCamera *vrCamera)
+{
+    CullingStatisticsJob *job = m_virtualRealityAspect->cullingStatisticsJob();
+    CullingStatisticsJob::Statistics statistics;
+    if(job->takeStatistics(statistics)) {
+        m_submittedEntities = statistics.submitted;
+        m_visibleEntities = statistics.visible;
+        m_eyeDraws = statistics.eyeDraws;
+    }
+    // Counted with the frustum the next frame is culled with
+    job->setInput(vrCamera->stereoFrustum(), vrCamera->perEyeCulling());
+}
+
+bool QHeadMountedDisplay::startCapture(const QString &path, QHeadMountedDisplay::CaptureFormat format, qreal scale)
+{
+    const CaptureEncoder::Format encoderFormat = format == PngCapture ? CaptureEncoder::Png : CaptureEncoder::Y4m;
+    if(!m_frameCapture->start(path, encoderFormat, scale, qRound(refreshRate())))
+        return false;
+    emit capturingChanged(true);
+    return true;
+}
+
+void QHeadMountedDisplay::stopCapture()
+{
+    if(!m_frameCapture->isActive())
+        return;
+    m_context->makeCurrent(m_surface);
+    m_frameCapture->stop();
+    qDebug() << "Capture stopped," << m_frameCapture->capturedFrames() << "frames written," << m_frameCapture->droppedFrames() << "dropped";
+    emit capturingChanged(false);
+}
+
+bool QHeadMountedDisplay::capturing() const
+{
+    return m_frameCapture->isActive();
+}
+
+int QHeadMountedDisplay::capturedFrames() const
+{
+    return m_frameCapture->capturedFrames();
+}
+
+int QHeadMountedDisplay::droppedCaptureFrames() const
+{
+    return m_frameCapture->droppedFrames();
+}
+
+bool QHeadMountedDisplay::reuseIdleFrames() const
+{
+    return m_reuseIdleFrames;
+}
+
+void QHeadMountedDisplay::setReuseIdleFrames(bool reuseIdleFrames)
+{
+    if (m_reuseIdleFrames == reuseIdleFrames)
+        return;
+    m_reuseIdleFrames = reuseIdleFrames;
+    // Poses are remembered by the next rendered frame
+    m_posesFed = true;
+    m_idleTrackedObjectPoses.clear();
+    Q_EMIT reuseIdleFramesChanged(reuseIdleFrames);
+}
+
+qreal QHeadMountedDisplay::idleRotationThreshold() const
+{
+    return m_idleRotationThreshold;
+}
+
+void QHeadMountedDisplay::setIdleRotationThreshold(qreal idleRotationThreshold)
+{
+    if (qFuzzyCompare(m_idleRotationThreshold, idleRotationThreshold))
+        return;
+    m_idleRotationThreshold = idleRotationThreshold;
+    Q_EMIT idleThresholdChanged();
+}
+
+qreal QHeadMountedDisplay::idleTranslationThreshold() const
+{
+    return m_idleTranslationThreshold;
+}
+
+void QHeadMountedDisplay::setIdleTranslationThreshold(qreal idleTranslationThreshold)
+{
+    if (qFuzzyCompare(m_idleTranslationThreshold, idleTranslationThreshold))
+        return;
+    m_idleTranslationThreshold = idleTranslationThreshold;
+    Q_EMIT idleThresholdChanged();
+}
+
+int QHeadMountedDisplay::maxReusedFrames() const
+{
+    return m_maxReusedFrames;
+}
+
+void QHeadMountedDisplay::setMaxReusedFrames(int maxReusedFrames)
+{
+    maxReusedFrames = qMax(0, maxReusedFrames);
+    if (m_maxReusedFrames == maxReusedFrames)
+        return;
+    m_maxReusedFrames = maxReusedFrames;
+    Q_EMIT maxReusedFramesChanged(maxReusedFrames);
+}
+
+int QHeadMountedDisplay::reusedFrameCount() const
+{
+    return m_reusedFrameCount;
+}
+
+bool QHeadMountedDisplay::geometrySharing() const
+{
+    return m_geometrySharing;
+}
+
+void QHeadMountedDisplay::setGeometrySharing(bool geometrySharing)
+{
+    if (m_geometrySharing == geometrySharing)
+        return;
+    m_geometrySharing = geometrySharing;
+    if (!geometrySharing)
+        m_geometryCache->clear();
+    Q_EMIT geometrySharingChanged(geometrySharing);
+}
+
+bool QHeadMountedDisplay::occlusionCulling() const
+{
+    return m_occlusionCulling;
+}
+
+void QHeadMountedDisplay::setOcclusionCulling(bool occlusionCulling)
+{
+    if (m_occlusionCulling == occlusionCulling)
+        return;
+    m_occlusionCulling = occlusionCulling;
+    if (!occlusionCulling) {
+        // Everything is drawn again, results still pending are dropped
+        for (const QPointer<QOcclusionVolume> &component : qAsConst(m_occlusionComponents)) {
+            if (component)
+                component->setOccluded(false);
+        }
+        m_occlusionComponents.clear();
+        m_occlusionPending = false;
+        m_occlusionViewProjectionValid = false;
+        m_renderedOcclusionViewProjectionValid = false;
+        m_depthReadback->clearFrame();
+    }
+    Q_EMIT occlusionCullingChanged(occlusionCulling);
+}
+
+QSize QHeadMountedDisplay::occlusionBufferSize() const
+{
+    return m_occlusionBufferSize;
+}
+
+void QHeadMountedDisplay::setOcclusionBufferSize(const QSize &occlusionBufferSize)
+{
+    if (m_occlusionBufferSize == occlusionBufferSize)
+        return;
+    m_occlusionBufferSize = occlusionBufferSize;
+    Q_EMIT occlusionBufferSizeChanged(occlusionBufferSize);
+}
+
+Qt3DRender::QAbstractTexture *QHeadMountedDisplay::occlusionDepthTexture() const
+{
+    return m_occlusionDepthTexture.data();
+}
+
+void QHeadMountedDisplay::setOcclusionDepthTexture(Qt3DRender::QAbstractTexture *occlusionDepthTexture)
+{
+    if (m_occlusionDepthTexture == occlusionDepthTexture)
+        return;
+    m_occlusionDepthTexture = occlusionDepthTexture;
+    Q_EMIT occlusionDepthTextureChanged(occlusionDepthTexture);
+}
+
+int QHeadMountedDisplay::spectatorInterval() const
+{
+    return m_spectatorInterval;
+}
+
+void QHeadMountedDisplay::setSpectatorInterval(int spectatorInterval)
+{
+    spectatorInterval = qMax(0, spectatorInterval);
+    if (m_spectatorInterval == spectatorInterval)
+        return;
+    m_spectatorInterval = spectatorInterval;
+    Q_EMIT spectatorIntervalChanged(spectatorInterval);
+}
+
+QSize QHeadMountedDisplay::spectatorSize() const
+{
+    return m_spectatorSize;
+}
+
+void QHeadMountedDisplay::setSpectatorSize(const QSize &spectatorSize)
+{
+    if (m_spectatorSize == spectatorSize)
+        return;
+    m_spectatorSize = spectatorSize;
+    Q_EMIT spectatorSizeChanged(spectatorSize);
+}
+
+bool QHeadMountedDisplay::spectatorActive() const
+{
+    return m_spectatorActive;
+}
+
+Qt3DRender::QAbstractTexture *QHeadMountedDisplay::spectatorTexture() const
+{
+    return m_spectatorTexture.data();
+}
+
+void QHeadMountedDisplay::setSpectatorTexture(Qt3DRender::QAbstractTexture *spectatorTexture)
+{
+    if (m_spectatorTexture == spectatorTexture)
+        return;
+    m_spectatorTexture = spectatorTexture;
+    Q_EMIT spectatorTextureChanged(spectatorTexture);
+}
+
+qreal QHeadMountedDisplay::cpuFrameTime() const
+{
+    return m_frameTiming->cpuTime();
+}
+
+qreal QHeadMountedDisplay::gpuFrameTime() const
+{
+    return m_frameTiming->gpuTime();
+}
+
+qreal QHeadMountedDisplay::spectatorGpuTime() const
+{
+    return m_frameTiming->spectatorGpuTime();
+}
+
+int QHeadMountedDisplay::primitivesDrawn() const
+{
+    return m_frameTiming->primitives();
+}
+
+int QHeadMountedDisplay::submittedEntities() const
+{
+    return m_submittedEntities;
+}
+
+int QHeadMountedDisplay::visibleEntities() const
+{
+    return m_visibleEntities;
+}
+
+int QHeadMountedDisplay::eyeDraws() const
+{
+    return m_eyeDraws;
+}
+
+bool QHeadMountedDisplay::spectatorMirrorTexture(QVirtualRealityApiBackend::MirrorTexture &mirrorTexture)
+{
+    QOpenGLTexture *texture = renderedTexture(m_spectatorTexture);
+    if(!texture)
+        return false;
+    mirrorTexture.textureId = texture->textureId();
+    mirrorTexture.size = QSize(texture->width(), texture->height());
+    mirrorTexture.layer = -1;
+    mirrorTexture.eyeRect = QRect(QPoint(0, 0), mirrorTexture.size);
+    return true;
+}
+
+QOpenGLTexture *QHeadMountedDisplay::renderedTexture(Qt3DRender::QAbstractTexture *texture) const
+{
+    if(!texture)
+        return nullptr;
+    // The texture only exists in the renderer, look up its OpenGL texture
+    Qt3DRender::QRenderAspectPrivate *renderAspect = static_cast<Qt3DRender::QRenderAspectPrivate*>(Qt3DRender::QRenderAspectPrivate::get(m_renderAspect));
+    Qt3DRender::Render::GLTexture *glTexture = renderAspect->m_nodeManagers->glTextureManager()->lookupTexture(texture->id());
+    return glTexture ? glTexture->getOrCreateGLTexture() : nullptr;
+}
+
+MirrorRing *QHeadMountedDisplay::mirrorRing()
+{
+    if(!m_mirrorRing)
+        m_mirrorRing = new MirrorRing;
+    return m_mirrorRing;
+}
+
+void QHeadMountedDisplay::updateStereoInstancing()
+{
+    if(!m_rootItem)
+        return;
+    // Single pass stereo draws every instance once per eye. Per instance attributes advance every second instance.
+    const bool instanced = m_stereoMode == SinglePassInstanced;
+    const QList<Qt3DRender::QGeometryRenderer*> renderers = m_rootItem->findChildren<Qt3DRender::QGeometryRenderer*>();
+    for(Qt3DRender::QGeometryRenderer *renderer : renderers) {
+        if(renderer->property(StereoInstancedProperty).toBool() == instanced)
+            continue;
+        if(qobject_cast<QHiddenAreaMask*>(renderer->parent()) || qobject_cast<QFoveatedComposite*>(renderer->parent())
+           || qobject_cast<QFarFieldComposite*>(renderer->parent()))
+            continue; // Covers both eyes already
+        renderer->setProperty(StereoInstancedProperty, instanced);
+        renderer->setInstanceCount(instanced ? renderer->instanceCount() * 2 : renderer->instanceCount() / 2);
+        if(!renderer->geometry())
+            continue;
+        const QVector<Qt3DRender::QAttribute*> attributes = renderer->geometry()->attributes();
+        for(Qt3DRender::QAttribute *attribute : attributes) {
+            // Geometry may be shared between renderers
+            if(attribute->divisor() == 0 || attribute->property(StereoInstancedProperty).toBool() == instanced)
+                continue;
+            attribute->setProperty(StereoInstancedProperty, instanced);
+            attribute->setDivisor(instanced ? attribute->divisor() * 2 : attribute->divisor() / 2);
+        }
+    }
+}
+
+void QHeadMountedDisplay::uploadTrackedObjectTextures(const QList<QVirtualRealityMesh*> &meshes, const QList<QTrackedObjectsLayer*> &layers)
+{
+    // Qt3D only allocates the textures, the backend streams the model textures into them
+    QList<Qt3DRender::QAbstractTexture*> textures;
+    for(QList<QVirtualRealityMesh*>::const_iterator iter(meshes.begin()); iter != meshes.end(); ++iter)
+        textures.append((*iter)->diffuseTexture());
+    for(QList<QTrackedObjectsLayer*>::const_iterator iter(layers.begin()); iter != layers.end(); ++iter)
+        textures.append((*iter)->diffuseTexture());
+    QSet<QOpenGLTexture*> uploaded; // Equal textures are shared by Qt3D
+    for(QList<Qt3DRender::QAbstractTexture*>::const_iterator iter(textures.begin()); iter != textures.end(); ++iter) {
+        QOpenGLTexture *texture = renderedTexture(*iter);
+        if(texture && !uploaded.contains(texture)) {
+            uploaded.insert(texture);
+            m_apibackend->uploadTrackedObjectTexture(texture);
+        }
+    }
+}
+
+void QHeadMountedDisplay::updateCompositorLayers()
+{
+    if(!m_rootItem)
+        return;
+    const bool supported = m_apibackend->supportsCompositorLayers();
+    const QList<QCompositorLayer*> compositorLayers = m_rootItem->findChildren<QCompositorLayer*>();
+    QVector<QVirtualRealityApiBackend::CompositorLayer> layers;
+    layers.reserve(compositorLayers.size());
+    for(QCompositorLayer *compositorLayer : compositorLayers) {
+        compositorLayer->setComposited(supported);
+        if(!supported || !compositorLayer->isEnabled() || compositorLayer->image().isNull())
+            continue;
+        QVirtualRealityApiBackend::CompositorLayer layer;
+        layer.id = compositorLayer->layerId();
+        layer.position = compositorLayer->position();
+        layer.orientation = compositorLayer->orientation();
+        layer.size = compositorLayer->size();
+        layer.radius = compositorLayer->shape() == QCompositorLayer::Cylinder ? compositorLayer->radius() : 0.0f;
+        layer.image = compositorLayer->image(); // Shared, not copied
+        layer.revision = compositorLayer->revision();
+        layers.append(layer);
+    }
+    if(supported)
+        m_apibackend->setCompositorLayers(layers);
+}
+
 void QHeadMountedDisplay::setWindowSurface(QObject *rootObject)
 {
     //    if(!(m_context = QOpenGLContext::currentContext()))
@@ -16,11 +16,14 @@
 #define QT3DHEADMOUNTEDDISPLAY_H
 
 #include "qvirtualrealityapi.h"
+#include "qvirtualrealityapibackend.h"
 
 #include <frontend/qvirtualrealityaspect.h>
 
 #include <QOffscreenSurface>
 #include <QtCore/qpointer.h>
+#include <QAtomicInt>
+#include <QHash>
 #include <QScopedPointer>
 #include <QUrl>
 #include <QOpenGLFramebufferObject>
@@ -30,6 +33,7 @@
 QT_BEGIN_NAMESPACE
 
 class QQmlIncubationController;
+class QOpenGLTexture;
 
 namespace Qt3DCore {
 class QAbstractAspect;
@@ -41,6 +45,7 @@ class QQmlAspectEngine;
 namespace Qt3DRender {
 class QRenderAspect;
 class QCamera;
+class QAbstractTexture;
 }
 
 namespace Qt3DInput {
@@ -53,14 +58,92 @@ class QLogicAspect;
 
 namespace Qt3DVirtualReality {
 
-class QVirtualRealityApiBackend;
+class MirrorRing;
+class FrameCapture;
+class DepthReadback;
+class GeometryCache;
+class QOcclusionVolume;
+class QStereoLevelOfDetail;
+class QVirtualrealityCamera;
+class QVirtualRealityMesh;
+class QTrackedObjectsLayer;
+class FrameTiming;
 
 class QT3DVR_EXPORT QHeadMountedDisplay : public QObject /*: public QQuickItem*/ {
     Q_OBJECT
     Q_PROPERTY(QObject* surface READ surface NOTIFY surfaceChanged)
     Q_PROPERTY(QSize renderTargetSize READ renderTargetSize NOTIFY renderTargetSizeChanged)
+    Q_PROPERTY(StereoMode stereoMode READ stereoMode WRITE setStereoMode NOTIFY stereoModeChanged)
+    Q_PROPERTY(bool eyeTextureArray READ eyeTextureArray CONSTANT)
+    Q_PROPERTY(bool reverseDepth READ reverseDepth CONSTANT)
+    Q_PROPERTY(QRectF leftFoveaRect READ leftFoveaRect NOTIFY foveationProfileChanged)
+    Q_PROPERTY(QRectF rightFoveaRect READ rightFoveaRect NOTIFY foveationProfileChanged)
+    Q_PROPERTY(qreal foveaPeripheryScale READ foveaPeripheryScale NOTIFY foveationProfileChanged)
+    Q_PROPERTY(qreal temporalScale READ temporalScale WRITE setTemporalScale NOTIFY temporalScaleChanged)
+    Q_PROPERTY(bool compositorLayersSupported READ compositorLayersSupported CONSTANT)
+    Q_PROPERTY(bool capturing READ capturing NOTIFY capturingChanged)
+    Q_PROPERTY(int spectatorInterval READ spectatorInterval WRITE setSpectatorInterval NOTIFY spectatorIntervalChanged)
+    Q_PROPERTY(QSize spectatorSize READ spectatorSize WRITE setSpectatorSize NOTIFY spectatorSizeChanged)
+    Q_PROPERTY(bool spectatorActive READ spectatorActive NOTIFY spectatorActiveChanged)
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * spectatorTexture READ spectatorTexture WRITE setSpectatorTexture NOTIFY spectatorTextureChanged)
+    Q_PROPERTY(qreal cpuFrameTime READ cpuFrameTime NOTIFY frameTimingChanged)
+    Q_PROPERTY(qreal gpuFrameTime READ gpuFrameTime NOTIFY frameTimingChanged)
+    Q_PROPERTY(qreal spectatorGpuTime READ spectatorGpuTime NOTIFY frameTimingChanged)
+    Q_PROPERTY(int primitivesDrawn READ primitivesDrawn NOTIFY frameTimingChanged)
+    Q_PROPERTY(int submittedEntities READ submittedEntities NOTIFY frameTimingChanged)
+    Q_PROPERTY(int visibleEntities READ visibleEntities NOTIFY frameTimingChanged)
+    Q_PROPERTY(int eyeDraws READ eyeDraws NOTIFY frameTimingChanged)
+    Q_PROPERTY(bool reuseIdleFrames READ reuseIdleFrames WRITE setReuseIdleFrames NOTIFY reuseIdleFramesChanged)
+    Q_PROPERTY(qreal idleRotationThreshold READ idleRotationThreshold WRITE setIdleRotationThreshold NOTIFY idleThresholdChanged)
+    Q_PROPERTY(qreal idleTranslationThreshold READ idleTranslationThreshold WRITE setIdleTranslationThreshold NOTIFY idleThresholdChanged)
+    Q_PROPERTY(int maxReusedFrames READ maxReusedFrames WRITE setMaxReusedFrames NOTIFY maxReusedFramesChanged)
+    Q_PROPERTY(int reusedFrameCount READ reusedFrameCount NOTIFY frameTimingChanged)
+    Q_PROPERTY(bool geometrySharing READ geometrySharing WRITE setGeometrySharing NOTIFY geometrySharingChanged)
+    Q_PROPERTY(bool occlusionCulling READ occlusionCulling WRITE setOcclusionCulling NOTIFY occlusionCullingChanged)
+    Q_PROPERTY(QSize occlusionBufferSize READ occlusionBufferSize WRITE setOcclusionBufferSize NOTIFY occlusionBufferSizeChanged)
+    Q_PROPERTY(Qt3DRender::QAbstractTexture * occlusionDepthTexture READ occlusionDepthTexture WRITE setOcclusionDepthTexture NOTIFY occlusionDepthTextureChanged)
 
 public:
+    /*!
+     * \brief The StereoMode enum selects how StereoFrameGraph draws both eyes.
+     * MultiPass: the scene is drawn once per eye ("forward" techniques).
+     * SinglePassInstanced: every draw is issued once with twice the instance count, the vertex shader
+     * selects the eye ("stereoInstanced" techniques, e.g. StereoPhongMaterial). Entities without such
+     * a technique are not drawn in this mode. The spectator and the occlusion depth are drawn with the same
+     * techniques from their own camera, odd instances are dropped there.
+     * MultiPassFoveated: like MultiPass, but each eye is drawn as the whole eye at reduced resolution plus
+     * the center at full resolution, both offscreen. FoveatedComposite upscales them into the target.
+     * Regions come from the foveation profile of the backend (leftFoveaRect, foveaPeripheryScale).
+     * SinglePassLayered: every draw is issued once, the geometry shader emits each triangle into the layer of
+     * both eyes ("stereoLayered" techniques). The only mode for QHeadMountedDisplayFormat::EyeTextureArray,
+     * the other modes need QHeadMountedDisplayFormat::SideBySide.
+     * MultiPassTemporal: like MultiPass, but each eye is drawn offscreen at temporalScale with a sub-pixel jitter
+     * that changes every frame. TemporalResolve accumulates the frames into the target, the history is reprojected
+     * with the depth of the eye and the poses of the previous frame.
+     * MultiPassHybridMono: like MultiPass, but everything beyond VrCamera.farFieldDistance is drawn only once,
+     * offscreen from between the eyes. FarFieldComposite draws it into both eyes, then each eye draws the near field.
+     */
+    enum StereoMode {
+        MultiPass,
+        SinglePassInstanced,
+        MultiPassFoveated,
+        SinglePassLayered,
+        MultiPassTemporal,
+        MultiPassHybridMono
+    };
+    Q_ENUM(StereoMode)
+
+    /*!
+     * \brief The CaptureFormat enum selects how startCapture writes frames.
+     * Y4mCapture: a single uncompressed yuv 4:2:0 stream, cheap to encode, e.g. for ffmpeg.
+     * PngCapture: one png per frame into a directory, lossless but slow, more frames are dropped.
+     */
+    enum CaptureFormat {
+        Y4mCapture,
+        PngCapture
+    };
+    Q_ENUM(CaptureFormat)
+
     QHeadMountedDisplay(int hmdId, const QHeadMountedDisplayFormat &formathmd, QVirtualRealityApi *api, QVirtualRealityApiBackend *apibackend);
     ~QHeadMountedDisplay();
 
@@ -79,18 +162,206 @@ public:
 
     int timeUntilNextFrame();
     QOpenGLContext *context();
+    StereoMode stereoMode() const;
+    void setStereoMode(StereoMode stereoMode);
+    /*!
+     * \brief eyeTextureArray is true if the backend renders into a QHeadMountedDisplayFormat::EyeTextureArray.
+     * renderTargetSize is the size of one eye then.
+     */
+    bool eyeTextureArray() const;
+    /*!
+     * \brief reverseDepth is true if QHeadMountedDisplayFormat::reverseDepth was requested and clip control is available.
+     * Depth then ranges 0..1 with near at 1, the frame graph clears to 0 and tests with greater.
+     */
+    bool reverseDepth() const;
+
+    /*!
+     * \brief leftFoveaRect is the full resolution region of the left eye in normalized eye coordinates.
+     */
+    QRectF leftFoveaRect() const;
+    QRectF rightFoveaRect() const;
+    /*!
+     * \brief foveaPeripheryScale is the resolution of the periphery relative to the eye.
+     */
+    qreal foveaPeripheryScale() const;
+    /*!
+     * \brief temporalScale is the internal resolution of the eyes relative to the render target with MultiPassTemporal.
+     */
+    qreal temporalScale() const;
+    void setTemporalScale(qreal temporalScale);
+    /*!
+     * \brief compositorLayersSupported if QCompositorLayer entities are submitted to the compositor.
+     * Otherwise they are drawn into the eye textures with the scene.
+     */
+    bool compositorLayersSupported() const;
+
+    /*!
+     * \brief startCapture records both eyes side by side, as submitted to the headset.
+     * Frames are read back asynchronously and encoded on a background thread. If the encoder falls behind,
+     * frames are dropped instead of slowing down the headset.
+     * \param path of the y4m file or the png directory
+     * \param scale of the recording relative to the eye textures
+     */
+    Q_INVOKABLE bool startCapture(const QString &path, CaptureFormat format = Y4mCapture, qreal scale = 0.5);
+    /*!
+     * \brief stopCapture writes the frames still in flight and closes the recording.
+     */
+    Q_INVOKABLE void stopCapture();
+    bool capturing() const;
+    /*!
+     * \brief capturedFrames written by the current or last recording.
+     */
+    int capturedFrames() const;
+    /*!
+     * \brief droppedCaptureFrames of the current or last recording.
+     */
+    int droppedCaptureFrames() const;
+
+    /*!
+     * \brief spectatorInterval renders the spectator every n-th frame of the headset, 0 disables it.
+     * With 3 the spectator runs at 30Hz on a 90Hz headset. StereoFrameGraph draws the spectator camera
+     * into its own texture while spectatorActive, a QMirrorWindow with QMirrorWindow::Spectator shows it.
+     */
+    int spectatorInterval() const;
+    void setSpectatorInterval(int spectatorInterval);
+    QSize spectatorSize() const;
+    void setSpectatorSize(const QSize &spectatorSize);
+    /*!
+     * \brief spectatorActive is true during the frames that render the spectator.
+     */
+    bool spectatorActive() const;
+    /*!
+     * \brief spectatorTexture the spectator is drawn into, mirrored after rendering.
+     */
+    Qt3DRender::QAbstractTexture *spectatorTexture() const;
+    void setSpectatorTexture(Qt3DRender::QAbstractTexture *spectatorTexture);
+
+    /*!
+     * \brief cpuFrameTime is the average time in milliseconds the cpu needs for a frame, from rendering to submitting.
+     */
+    qreal cpuFrameTime() const;
+    /*!
+     * \brief gpuFrameTime is the average time in milliseconds the gpu needs for a frame, including the spectator.
+     */
+    qreal gpuFrameTime() const;
+    /*!
+     * \brief spectatorGpuTime is how much longer frames that render the spectator take on the gpu, in milliseconds.
+     */
+    qreal spectatorGpuTime() const;
+    /*!
+     * \brief primitivesDrawn by the gpu in the last measured frame, e.g. triangles of all eyes and passes.
+     */
+    int primitivesDrawn() const;
+    /*!
+     * \brief submittedEntities is the number of enabled entities with an enabled geometry renderer in a recent frame.
+     */
+    int submittedEntities() const;
+    /*!
+     * \brief visibleEntities of submittedEntities pass the frustum of VrCamera.stereoCamera, the rest is culled.
+     */
+    int visibleEntities() const;
+    /*!
+     * \brief eyeDraws of visibleEntities, two per entity unless VrCamera.perEyeCulling finds an eye not seeing it.
+     */
+    int eyeDraws() const;
+
+    /*!
+     * \brief reuseIdleFrames resubmits the last eye textures instead of rendering, while no frontend node changed since the last render
+     * and the head and tracked objects moved less than the idle thresholds. Jobs of Qt3D and rendering are skipped,
+     * the compositor reprojects the frame to the new pose. While idle the scene keeps the poses it was rendered with.
+     * Off by default.
+     */
+    bool reuseIdleFrames() const;
+    void setReuseIdleFrames(bool reuseIdleFrames);
+    /*!
+     * \brief idleRotationThreshold in degrees, relative to the poses of the last rendered frame.
+     */
+    qreal idleRotationThreshold() const;
+    void setIdleRotationThreshold(qreal idleRotationThreshold);
+    /*!
+     * \brief idleTranslationThreshold in meters, relative to the poses of the last rendered frame.
+     */
+    qreal idleTranslationThreshold() const;
+    void setIdleTranslationThreshold(qreal idleTranslationThreshold);
+    /*!
+     * \brief maxReusedFrames in a row, then a frame with the current poses is rendered.
+     */
+    int maxReusedFrames() const;
+    void setMaxReusedFrames(int maxReusedFrames);
+    int reusedFrameCount() const;
+
+    /*!
+     * \brief geometrySharing lets meshes with equal parameters, e.g. many TorusMesh with the same rings and slices,
+     * draw from one set of buffers. Buffers are compared by their data generators before each frame, each distinct
+     * generator fills one buffer kept below the root entity and the meshes' own buffers are emptied. On by default.
+     */
+    bool geometrySharing() const;
+    void setGeometrySharing(bool geometrySharing);
+
+    /*!
+     * \brief occlusionCulling skips drawing entities with a QOcclusionVolume while they are hidden behind other geometry.
+     * StereoFrameGraph draws the depth of the scene from VrCamera.occlusionCamera into occlusionDepthTexture, which is
+     * read back without waiting for the gpu. An aspect job reprojects the newest depth to the current pose of each eye
+     * and tests the bounding spheres against a pyramid of it, entities are culled only while hidden from both eyes.
+     * Results are applied one frame later. Off by default.
+     * Reprojection only follows the camera. Occluders that moved since the depth was drawn may hide visible entities
+     * for a few frames.
+     */
+    bool occlusionCulling() const;
+    void setOcclusionCulling(bool occlusionCulling);
+    /*!
+     * \brief occlusionBufferSize of occlusionDepthTexture in pixels, small enough to be read back and reduced each frame.
+     */
+    QSize occlusionBufferSize() const;
+    void setOcclusionBufferSize(const QSize &occlusionBufferSize);
+    Qt3DRender::QAbstractTexture *occlusionDepthTexture() const;
+    void setOcclusionDepthTexture(Qt3DRender::QAbstractTexture *occlusionDepthTexture);
 signals:
     void requestRun();
     void surfaceChanged(QSurface* surface);
     void renderTargetSizeChanged(QSize renderTargetSize);
     void sceneCreated(QObject *rootObject);
+    void stereoModeChanged(StereoMode stereoMode);
+    void foveationProfileChanged();
+    void temporalScaleChanged(qreal temporalScale);
+    void capturingChanged(bool capturing);
+    void spectatorIntervalChanged(int spectatorInterval);
+    void spectatorSizeChanged(QSize spectatorSize);
+    void spectatorActiveChanged(bool spectatorActive);
+    void spectatorTextureChanged(Qt3DRender::QAbstractTexture *spectatorTexture);
+    // Emitted about once a second
+    void frameTimingChanged();
+    void reuseIdleFramesChanged(bool reuseIdleFrames);
+    void idleThresholdChanged();
+    void maxReusedFramesChanged(int maxReusedFrames);
+    void geometrySharingChanged(bool geometrySharing);
+    void occlusionCullingChanged(bool occlusionCulling);
+    void occlusionBufferSizeChanged(QSize occlusionBufferSize);
+    void occlusionDepthTextureChanged(Qt3DRender::QAbstractTexture *occlusionDepthTexture);
 
 public slots:
     void run();
 
 private:
+    friend class QMirrorWindow;
+    MirrorRing *mirrorRing();
+
     void onSceneCreated(QObject *rootObject);
     void setWindowSurface(QObject *rootObject);
+    void updateStereoInstancing();
+    void updateCompositorLayers();
+    void uploadTrackedObjectTextures(const QList<QVirtualRealityMesh*> &meshes, const QList<QTrackedObjectsLayer*> &layers);
+    bool spectatorMirrorTexture(QVirtualRealityApiBackend::MirrorTexture &mirrorTexture);
+    QOpenGLTexture *renderedTexture(Qt3DRender::QAbstractTexture *texture) const;
+    bool posesIdle();
+    void rememberIdlePoses();
+    bool sceneChanged();
+    void updateGeometrySharing();
+    void updateLevelsOfDetail(QVirtualrealityCamera *vrCamera);
+    void readOcclusionDepth();
+    void updateOcclusionCulling(QVirtualrealityCamera *vrCamera);
+    void updateCullingStatistics(QVirtualrealityCamera *vrCamera);
+    void finishFrame();
 
     QScopedPointer<Qt3DCore::Quick::QQmlAspectEngine> m_engine;
 
@@ -111,6 +382,48 @@ private:
     QOpenGLContext *m_context;
     QOffscreenSurface *m_surface;
     QObject *m_rootItem;
+    StereoMode m_stereoMode;
+    QHeadMountedDisplayFormat m_format;
+    bool m_reverseDepth;
+    QVirtualRealityApiBackend::FoveationProfile m_foveationProfile;
+    qreal m_temporalScale;
+    MirrorRing *m_mirrorRing;
+    FrameCapture *m_frameCapture;
+    FrameTiming *m_frameTiming;
+    int m_frameCount;
+    int m_spectatorInterval;
+    QSize m_spectatorSize;
+    bool m_spectatorActive;
+    QPointer<Qt3DRender::QAbstractTexture> m_spectatorTexture;
+    bool m_reuseIdleFrames;
+    qreal m_idleRotationThreshold;
+    qreal m_idleTranslationThreshold;
+    int m_maxReusedFrames;
+    int m_reusedFrames; // In a row
+    int m_reusedFrameCount;
+    bool m_posesFed; // By the last rendered frame, its changes are only rendered by the next one
+    QAtomicInt m_sceneChanges; // Changes of frontend nodes, counted by the change arbiter
+    int m_renderedSceneChanges; // Of m_sceneChanges, before the last render
+    QMetaObject::Connection m_sceneChangesConnection;
+    QMatrix4x4 m_idleHeadPose;
+    QHash<int, QMatrix4x4> m_idleTrackedObjectPoses;
+    QVector<QPointer<QStereoLevelOfDetail> > m_levelOfDetailComponents; // Order of the snapshot given to the job
+    bool m_levelOfDetailPending;
+    bool m_geometrySharing;
+    GeometryCache *m_geometryCache;
+    bool m_occlusionCulling;
+    QSize m_occlusionBufferSize;
+    QPointer<Qt3DRender::QAbstractTexture> m_occlusionDepthTexture;
+    DepthReadback *m_depthReadback;
+    QMatrix4x4 m_occlusionViewProjection; // Of the occlusion camera, the next frame is rendered with it
+    bool m_occlusionViewProjectionValid;
+    QMatrix4x4 m_renderedOcclusionViewProjection; // The depth read back after this frame was drawn with it
+    bool m_renderedOcclusionViewProjectionValid;
+    QVector<QPointer<QOcclusionVolume> > m_occlusionComponents; // Order of the snapshot given to the job
+    bool m_occlusionPending;
+    int m_submittedEntities;
+    int m_visibleEntities;
+    int m_eyeDraws;
 };
 
 } // Qt3DVirtualReality
@@ -0,0 +1,243 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "qmirrorwindow.h"
+#include "qheadmounteddisplay.h"
+#include "mirrorring_p.h"
+
+#include <QMutex>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions_3_2_Core>
+#include <QThread>
+#include <QTimer>
+#include <QDebug>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+// Lives on the mirror thread, owns the context of the mirror
+class MirrorRenderer : public QObject
+{
+    Q_OBJECT
+public:
+    MirrorRenderer(QWindow *window, QOpenGLContext *context, MirrorRing *ring)
+        : m_window(window)
+        , m_context(context)
+        , m_ring(ring)
+        , m_funcs(nullptr)
+        , m_framebuffer(0)
+        , m_exposed(false)
+        , m_stopped(false)
+    {
+    }
+
+    // Gui thread
+    void setTarget(const QSize &pixelSize, bool exposed)
+    {
+        QMutexLocker lock(&m_mutex);
+        m_targetSize = pixelSize;
+        m_exposed = exposed;
+    }
+
+public slots:
+    void render()
+    {
+        if (m_stopped)
+            return;
+        QSize target;
+        bool exposed;
+        {
+            QMutexLocker lock(&m_mutex);
+            target = m_targetSize;
+            exposed = m_exposed;
+        }
+        // Nothing to present to, check again later instead of spinning
+        if (!exposed || target.isEmpty() || !m_context->makeCurrent(m_window)) {
+            QTimer::singleShot(100, this, &MirrorRenderer::render);
+            return;
+        }
+        if (!m_funcs) {
+            m_funcs = m_context->versionFunctions<QOpenGLFunctions_3_2_Core>();
+            if (!m_funcs) {
+                qWarning() << "Could not get OpenGLFunctions 3.2, mirror will stay black";
+                m_stopped = true;
+                return;
+            }
+            m_funcs->initializeOpenGLFunctions();
+            m_funcs->glGenFramebuffers(1, &m_framebuffer);
+        }
+
+        m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, m_context->defaultFramebufferObject());
+        m_funcs->glViewport(0, 0, target.width(), target.height());
+        m_funcs->glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        m_funcs->glClear(GL_COLOR_BUFFER_BIT);
+
+        GLuint texture;
+        QSize size;
+        if (m_ring->acquire(m_funcs, texture, size)) {
+            // Fit into the window, keeping the aspect ratio of the eyes
+            const qreal scale = qMin(target.width() / qreal(size.width()), target.height() / qreal(size.height()));
+            const QSize fit(qRound(size.width() * scale), qRound(size.height() * scale));
+            const QPoint origin((target.width() - fit.width()) / 2, (target.height() - fit.height()) / 2);
+            m_funcs->glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+            m_funcs->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+            m_funcs->glBlitFramebuffer(0, 0, size.width(), size.height(),
+                                       origin.x(), origin.y(), origin.x() + fit.width(), origin.y() + fit.height(),
+                                       GL_COLOR_BUFFER_BIT, GL_LINEAR);
+            m_funcs->glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+            m_ring->release(m_funcs);
+        }
+        // Blocks this thread until vsync of the desktop, which paces the mirror
+        m_context->swapBuffers(m_window);
+        emit requestRender();
+    }
+
+    void cleanup()
+    {
+        m_stopped = true;
+        if (m_context->makeCurrent(m_window)) {
+            if (m_funcs)
+                m_funcs->glDeleteFramebuffers(1, &m_framebuffer);
+            m_context->doneCurrent();
+        }
+        m_funcs = nullptr;
+        delete m_context;
+        m_context = nullptr;
+    }
+
+signals:
+    void requestRender();
+
+private:
+    QWindow *m_window;
+    QOpenGLContext *m_context;
+    MirrorRing *m_ring;
+    QOpenGLFunctions_3_2_Core *m_funcs;
+    GLuint m_framebuffer;
+    QMutex m_mutex;
+    QSize m_targetSize;
+    bool m_exposed;
+    bool m_stopped;
+};
+
+QMirrorWindow::QMirrorWindow(QHeadMountedDisplay *hmd, QWindow *parent)
+    : QWindow(parent)
+    , m_ring(hmd->mirrorRing())
+    , m_thread(nullptr)
+    , m_renderer(nullptr)
+    , m_eye(BothEyes)
+    , m_scale(0.5)
+{
+    QSurfaceFormat format(hmd->context()->format());
+    // Presenting waits for vsync of the desktop, on the mirror thread only
+    format.setSwapInterval(1);
+    setSurfaceType(QWindow::OpenGLSurface);
+    setFormat(format);
+    create();
+
+    QOpenGLContext *context = new QOpenGLContext;
+    context->setFormat(format);
+    context->setShareContext(hmd->context());
+    if (!context->create() || !context->shareContext()) {
+        qWarning() << "Could not create a context sharing resources with the headset, mirror will stay black";
+        delete context;
+        return;
+    }
+
+    m_thread = new QThread(this);
+    m_renderer = new MirrorRenderer(this, context, m_ring);
+    context->moveToThread(m_thread);
+    m_renderer->moveToThread(m_thread);
+    connect(m_renderer, &MirrorRenderer::requestRender, m_renderer, &MirrorRenderer::render, Qt::QueuedConnection);
+    updateConfiguration();
+    m_ring->setEnabled(true);
+    m_thread->start();
+    QMetaObject::invokeMethod(m_renderer, "render", Qt::QueuedConnection);
+}
+
+QMirrorWindow::~QMirrorWindow()
+{
+    m_ring->setEnabled(false);
+    if (m_renderer) {
+        // The context is current on the mirror thread, it has to be released there
+        QMetaObject::invokeMethod(m_renderer, "cleanup", Qt::BlockingQueuedConnection);
+        m_thread->quit();
+        m_thread->wait();
+        delete m_renderer;
+    }
+}
+
+QMirrorWindow::Eye QMirrorWindow::eye() const
+{
+    return m_eye;
+}
+
+qreal QMirrorWindow::scale() const
+{
+    return m_scale;
+}
+
+int QMirrorWindow::droppedFrames() const
+{
+    return m_ring->droppedFrames();
+}
+
+void QMirrorWindow::setEye(QMirrorWindow::Eye eye)
+{
+    if (m_eye == eye)
+        return;
+    m_eye = eye;
+    updateConfiguration();
+    emit eyeChanged(eye);
+}
+
+void QMirrorWindow::setScale(qreal scale)
+{
+    if (qFuzzyCompare(m_scale, scale))
+        return;
+    m_scale = scale;
+    updateConfiguration();
+    emit scaleChanged(scale);
+}
+
+void QMirrorWindow::exposeEvent(QExposeEvent *event)
+{
+    Q_UNUSED(event);
+    updateTarget();
+}
+
+void QMirrorWindow::resizeEvent(QResizeEvent *event)
+{
+    Q_UNUSED(event);
+    updateTarget();
+}
+
+void QMirrorWindow::updateConfiguration()
+{
+    m_ring->setConfiguration(m_eye, m_scale);
+}
+
+void QMirrorWindow::updateTarget()
+{
+    if (m_renderer)
+        m_renderer->setTarget(size() * devicePixelRatio(), isExposed());
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#include "qmirrorwindow.moc"
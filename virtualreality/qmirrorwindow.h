@@ -0,0 +1,100 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_QMIRRORWINDOW_H
+#define QT3DVIRTUALREALITY_QMIRRORWINDOW_H
+
+#include <qt3dvr_global.h>
+
+#include <QWindow>
+
+QT_BEGIN_NAMESPACE
+
+class QThread;
+
+namespace Qt3DVirtualReality {
+
+class QHeadMountedDisplay;
+class MirrorRing;
+class MirrorRenderer;
+
+/*!
+ * \brief The QMirrorWindow class shows what the headset displays on the desktop.
+ * It draws on its own thread with a context sharing resources with the headset and presents at the
+ * refresh rate of the desktop. Eyes are copied after each submit and handed over with fences,
+ * the headset never waits for the mirror, a slow mirror only skips frames (droppedFrames).
+ * One mirror per headset, it must be destroyed before the QHeadMountedDisplay.
+ */
+class QT3DVR_EXPORT QMirrorWindow : public QWindow
+{
+    Q_OBJECT
+    Q_PROPERTY(Eye eye READ eye WRITE setEye NOTIFY eyeChanged)
+    Q_PROPERTY(qreal scale READ scale WRITE setScale NOTIFY scaleChanged)
+
+public:
+    /*!
+     * \brief The Eye enum selects what the mirror shows.
+     * Spectator: the third person view of QHeadMountedDisplay::spectatorInterval, updated at its rate.
+     */
+    enum Eye {
+        LeftEye,
+        RightEye,
+        BothEyes,
+        Spectator
+    };
+    Q_ENUM(Eye)
+
+    explicit QMirrorWindow(QHeadMountedDisplay *hmd, QWindow *parent = nullptr);
+    ~QMirrorWindow();
+
+    Eye eye() const;
+    /*!
+     * \brief scale of the copied eyes relative to the eye textures. Lower values make copies cheaper
+     * for the headset, the window upscales them.
+     */
+    qreal scale() const;
+    /*!
+     * \brief droppedFrames submitted to the headset while the mirror was still reading all copies.
+     */
+    int droppedFrames() const;
+
+public slots:
+    void setEye(Eye eye);
+    void setScale(qreal scale);
+
+signals:
+    void eyeChanged(Eye eye);
+    void scaleChanged(qreal scale);
+
+protected:
+    void exposeEvent(QExposeEvent *event) Q_DECL_OVERRIDE;
+    void resizeEvent(QResizeEvent *event) Q_DECL_OVERRIDE;
+
+private:
+    void updateConfiguration();
+    void updateTarget();
+
+    MirrorRing *m_ring;
+    QThread *m_thread;
+    MirrorRenderer *m_renderer;
+    Eye m_eye;
+    qreal m_scale;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_QMIRRORWINDOW_H
@@ -17,8 +17,68 @@
 #include "qvirtualrealityapi_p.h"
 
 #include <QOpenGLContext>
+#include <QDebug>
 namespace Qt3DVirtualReality {
 
+QHeadMountedDisplayFormat::QHeadMountedDisplayFormat()
+    : m_renderTargetLayout(SideBySide)
+    , m_swapChainLength(3)
+    , m_samples(0)
+    , m_submitDepth(false)
+    , m_reverseDepth(false)
+{
+}
+
+void QHeadMountedDisplayFormat::setRenderTargetLayout(QHeadMountedDisplayFormat::RenderTargetLayout layout)
+{
+    m_renderTargetLayout = layout;
+}
+
+QHeadMountedDisplayFormat::RenderTargetLayout QHeadMountedDisplayFormat::renderTargetLayout() const
+{
+    return m_renderTargetLayout;
+}
+
+void QHeadMountedDisplayFormat::setSwapChainLength(int length)
+{
+    m_swapChainLength = qBound(2, length, 3);
+}
+
+int QHeadMountedDisplayFormat::swapChainLength() const
+{
+    return m_swapChainLength;
+}
+
+void QHeadMountedDisplayFormat::setSamples(int samples)
+{
+    m_samples = qMax(0, samples);
+}
+
+int QHeadMountedDisplayFormat::samples() const
+{
+    return m_samples;
+}
+
+void QHeadMountedDisplayFormat::setSubmitDepth(bool submitDepth)
+{
+    m_submitDepth = submitDepth;
+}
+
+bool QHeadMountedDisplayFormat::submitDepth() const
+{
+    return m_submitDepth;
+}
+
+void QHeadMountedDisplayFormat::setReverseDepth(bool reverseDepth)
+{
+    m_reverseDepth = reverseDepth;
+}
+
+bool QHeadMountedDisplayFormat::reverseDepth() const
+{
+    return m_reverseDepth;
+}
+
 QVirtualRealityApi::QVirtualRealityApi(Qt3DVirtualReality::QVirtualRealityApi::Type type)
     : QVirtualRealityApi()
 {
@@ -55,7 +115,11 @@ bool QVirtualRealityApi::isRuntimeInstalled(Qt3DVirtualReality::QVirtualRealityA
 QHeadMountedDisplay* QVirtualRealityApi::getHmd(int hmdId, const QHeadMountedDisplayFormat &format)
 {
     Q_D(QVirtualRealityApi);
-    Qt3DVirtualReality::QHeadMountedDisplay *hmd(new Qt3DVirtualReality::QHeadMountedDisplay(hmdId, format, this, d->m_apibackend));
+    // Must be known before the backend allocates its render targets
+    const QHeadMountedDisplayFormat hmdFormat(d->m_apibackend->setFormat(format));
+    if(hmdFormat.renderTargetLayout() != format.renderTargetLayout())
+        qWarning() << "Render target layout" << format.renderTargetLayout() << "is not supported by the vr backend, using side by side";
+    Qt3DVirtualReality::QHeadMountedDisplay *hmd(new Qt3DVirtualReality::QHeadMountedDisplay(hmdId, hmdFormat, this, d->m_apibackend));
     hmd->context()->makeCurrent(static_cast<QOffscreenSurface*>(hmd->surface()));
     d->initialize();
     return hmd;
@@ -28,11 +28,67 @@ namespace Qt3DVirtualReality {
 class QHeadMountedDisplay;
 class QVirtualRealityApiPrivate;
 
-class QHeadMountedDisplayFormat {
+class QT3DVR_EXPORT QHeadMountedDisplayFormat {
+public:
+    /*!
+     * \brief The RenderTargetLayout enum selects how the eyes are laid out in the render target.
+     * SideBySide: one texture, left eye in the left half. Works with every QHeadMountedDisplay::StereoMode.
+     * EyeTextureArray: one layer of a 2 layer color and depth texture array per eye, layer 0 is the left eye.
+     * Each eye has its own depth and its full texture, eyes are drawn with QHeadMountedDisplay::SinglePassLayered.
+     */
+    enum RenderTargetLayout {
+        SideBySide,
+        EyeTextureArray
+    };
+
+    QHeadMountedDisplayFormat();
+
+    void setRenderTargetLayout(RenderTargetLayout layout);
+    RenderTargetLayout renderTargetLayout() const;
+
+    /*!
+     * \brief setSwapChainLength is the number of render targets the backend rotates through, 2 or 3.
+     * The gpu renders the next frame while the compositor still reads the previous ones. Default is 3.
+     * Ignored by runtimes that own their swap chain (Oculus).
+     */
+    void setSwapChainLength(int length);
+    int swapChainLength() const;
+
+    /*!
+     * \brief setSamples for multisample anti aliasing of the eye render targets, 0 disables it.
+     * Eyes are rendered into a multisampled target that is resolved into the texture of the compositor at submit.
+     * Usually cheaper than the same quality with supersampling.
+     */
+    void setSamples(int samples);
+    int samples() const;
+
+    /*!
+     * \brief setSubmitDepth submits the depth of each eye with the color, along with the clip planes.
+     * The compositor can then reproject positionally, missed frames are hidden instead of juddering.
+     * Costs the bandwidth of the depth copy, and a depth resolve with multisampling.
+     */
+    void setSubmitDepth(bool submitDepth);
+    bool submitDepth() const;
+
+    /*!
+     * \brief setReverseDepth renders with a 32 bit float depth buffer and reversed depth: 1 at the near plane,
+     * 0 at the far plane. Precision is nearly uniform over distance, so the far plane can be infinite
+     * and the near plane close without z-fighting. Needs OpenGL 4.5 or GL_ARB_clip_control, otherwise
+     * depth is stored as float with the usual mapping.
+     */
+    void setReverseDepth(bool reverseDepth);
+    bool reverseDepth() const;
+
 //    void setSize(const QSize& size);
 //    const QSize& size();
 //    void setRenderingSurface(GLuint textureId);
 //    GLuint renderingSurface();
+private:
+    RenderTargetLayout m_renderTargetLayout;
+    int m_swapChainLength;
+    int m_samples;
+    bool m_submitDepth;
+    bool m_reverseDepth;
 };
 /**
  * @brief The QVrApi class
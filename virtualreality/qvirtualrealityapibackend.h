@@ -16,17 +16,29 @@
 #define QT3DVIRTUALREALITYAPIBACKEND_H
 
 #include "qt3dvr_global.h"
+#include "qvirtualrealityapi.h"
 #include <QOpenGLFramebufferObject>
 #include <QMatrix4x4>
 #include <qopengl.h>
 #include <QSize>
 #include <QSurfaceFormat>
 #include <QOpenGLTexture>
+#include <QVector2D>
+#include <QRect>
+#include <QRectF>
+#include <QImage>
+#include <QQuaternion>
+#include <QSizeF>
 
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DVirtualReality {
 
+// Default near plane of QVirtualrealityCamera. Projection matrices of the backends use these clip planes,
+// they only describe the shape of the lenses. Eyes are drawn with the projections of QVirtualrealityCamera.
+const float EyeNearClip = 0.2f;
+const float EyeFarClip = 1000.0f;
+
 /*!
  * \brief The QVirtualRealityApiBackend class hides the concrete implementation for a vr headset.
  * It should make it easy to add more Virtual reality devices. However, becaus we can't look into the future
@@ -35,6 +47,40 @@ namespace Qt3DVirtualReality {
 class QVirtualRealityApiBackend
 {
 public:
+    /*!
+     * \brief The FoveationProfile struct describes fixed foveated rendering for the lenses of a headset.
+     * Each eye is rendered as a full resolution center plus the whole eye at reduced resolution.
+     */
+    struct FoveationProfile {
+        QRectF leftCenter; //!< Full resolution region, normalized viewport coordinates of the eye, (0, 0) is bottom left
+        QRectF rightCenter;
+        float peripheryScale; //!< Resolution of the periphery relative to the eye target
+    };
+
+    /*!
+     * \brief The CompositorLayer struct is a textured quad or cylinder the compositor draws over the eyes.
+     * It is sampled at the resolution of the display and only uploaded when its revision changed.
+     */
+    struct CompositorLayer {
+        int id;
+        QVector3D position; //!< Tracking space. Center of a quad, center of the cylinder axis
+        QQuaternion orientation; //!< Quads face +z, the arc of a cylinder is centered on -z
+        QSizeF size; //!< Meters, the width of a cylinder is the arc length
+        float radius; //!< Of the cylinder, 0 for a quad
+        QImage image; //!< Top row first
+        int revision;
+    };
+
+    /*!
+     * \brief The MirrorTexture struct is the part of a texture showing one eye.
+     */
+    struct MirrorTexture {
+        GLuint textureId;
+        QSize size; //!< Of the whole texture
+        int layer; //!< Of a 2 layer array texture, -1 for a 2D texture
+        QRect eyeRect; //!< Pixels of the eye, a negative height if the texture is upside down
+    };
+
     enum TrackedObjectType {
         Head,
         LeftHand,
@@ -44,6 +90,12 @@ public:
     };
     virtual bool isHmdPresent() = 0;
 
+    /*!
+     * \brief setFormat is called once before initialize.
+     * \return the format actually used. Unsupported options are replaced, SideBySide must always be supported.
+     */
+    virtual QHeadMountedDisplayFormat setFormat(const QHeadMountedDisplayFormat &format) = 0;
+
     /*!
      * \brief initialize is to initialize the concrete vr framework.
      * This is called while correct opengl context is current and already initialized
@@ -75,10 +127,21 @@ public:
     virtual QMatrix4x4 headPose(int hmdId) = 0;
 
     //TO DO: introduce getRecomendedSize()
+    /*!
+     * \brief getRenderTargetSize of the whole side by side target, or of one layer with
+     * QHeadMountedDisplayFormat::EyeTextureArray.
+     */
     virtual QSize getRenderTargetSize() = 0;
 
     virtual int timeUntilNextFrame() = 0;
     virtual void swapToHeadset() = 0;
+    /*!
+     * \brief resubmitFrame submits the eye textures of the last swapToHeadset again, instead of a new frame.
+     * They keep the pose they were rendered with, so reprojection of the compositor corrects for head motion.
+     * Paces like swapToHeadset, the next frame is rendered into a new image as usual.
+     * \return false if nothing can be resubmitted, a new frame has to be rendered then
+     */
+    virtual bool resubmitFrame() = 0;
 
     /*!
      * \brief getEyeMatrices without projection applied. Relative to transform-origin.
@@ -89,27 +152,93 @@ public:
     virtual void getEyeMatrices(QMatrix4x4 &leftEye, QMatrix4x4 &rightEye) = 0;
 
     /*!
-     * \brief getProjectionMatrices get correct projection matrix for each eye. These can be asymetrical.
-     * \param leftProjection
-     * \param rightProjection
+     * \brief The ProjectionTangents struct is the raw field of view of an eye, tangents of the half angles
+     * from the view axis to each edge. OpenGL orientation: left and bottom are negative, unless the frustum
+     * does not contain the view axis. These can be asymetrical.
+     */
+    struct ProjectionTangents {
+        ProjectionTangents() : left(-1.0f), right(1.0f), bottom(-1.0f), top(1.0f) {}
+        float left;
+        float right;
+        float bottom;
+        float top;
+    };
+
+    /*!
+     * \brief getProjectionTangents of each eye, independent of clip planes.
+     * QVirtualrealityCamera builds the projections from them.
      */
-    virtual void getProjectionMatrices(QMatrix4x4 &leftProjection, QMatrix4x4 &rightProjection) = 0;
+    virtual void getProjectionTangents(ProjectionTangents &leftEye, ProjectionTangents &rightEye) = 0;
+
+    /*!
+     * \brief setDepthProjections the eyes are drawn with. Handed to the compositor with submitted depth,
+     * so that it can linearize it. Called whenever clip planes or depth mode change.
+     * \param reverseDepth depth is 1 at the near plane and 0 at the far plane, with a 0..1 clip range
+     */
+    virtual void setDepthProjections(const QMatrix4x4 &leftProjection, const QMatrix4x4 &rightProjection, bool reverseDepth) = 0;
+
+    /*!
+     * \brief getHiddenAreaMeshes areas of the eye viewports that are not visible through the lenses.
+     * Triangle lists in normalized viewport coordinates of each eye, (0, 0) is bottom left.
+     * Backends without sdk support synthesize them (see HiddenAreaMesh::synthesize).
+     * \param left
+     * \param right
+     */
+    virtual void getHiddenAreaMeshes(QVector<QVector2D> &left, QVector<QVector2D> &right) = 0;
+
+    /*!
+     * \brief foveationProfile for the lenses of the headset, see Foveation::lensProfile.
+     */
+    virtual FoveationProfile foveationProfile() = 0;
 
     virtual QList<int> currentlyTrackedObjects() = 0;
     virtual void getTrackedObject(int id, QMatrix4x4 &transform) = 0;
     virtual TrackedObjectType getTrackedObjectType(int id) = 0;
-    virtual void getTrackedObjectModel(int id, QVector<float> &vertices, QVector<int> &indices, QOpenGLTexture *texture) = 0;
+    virtual void getTrackedObjectModel(int id, QVector<float> &vertices, QVector<int> &indices) = 0;
+
+    /*!
+     * \brief getTrackedObjectModelRevision changes whenever the cached model of a tracked object changed.
+     * E.g. texture coordinates are remapped once the texture of the model was packed into the texture atlas.
+     * \param id
+     * \return -1 if the model has not yet been loaded.
+     */
+    virtual int getTrackedObjectModelRevision(int id) = 0;
+
+    /*!
+     * \brief getTrackedObjectTextureSize of the diffuse texture all tracked object models share.
+     * Texture coordinates returned by getTrackedObjectModel() refer to it.
+     * \return an empty size if the backend has no textures.
+     */
+    virtual QSize getTrackedObjectTextureSize() = 0;
+
+    /*!
+     * \brief uploadTrackedObjectTexture streams the loaded model textures into \a texture.
+     * \a texture has getTrackedObjectTextureSize() and is allocated by Qt3D. Textures are loaded
+     * and uploaded asynchronously, a frame is never blocked by this. Must be called on the render thread.
+     */
+    virtual void uploadTrackedObjectTexture(QOpenGLTexture *texture) = 0;
 
     virtual bool isTriggerTmp() = 0;
     /*!
-     * \brief getMirrorTexture
-     * Used to get a texture witch can be rendered in another window/thread.
-     * Some SDKs will not automaticly fill the QOpenGLTextue itself but return an OpenGL texture name.
-     * This method has to be called every time the mirror should update to allow copying in this case.
-     * It might work for some SDKs, but not for others.
-     * \param outMirrorTexture
+     * \brief getMirrorTexture of an eye of the frame submitted last, e.g. for a desktop mirror window.
+     * Called on the render thread after swapToHeadset. The texture can be read until the next frame is rendered,
+     * reading it must never make the headset wait.
+     * \param eye 0 is the left eye
+     * \return false if there is nothing to mirror
+     */
+    virtual bool getMirrorTexture(int eye, MirrorTexture &mirrorTexture) = 0;
+
+    /*!
+     * \brief supportsCompositorLayers if setCompositorLayers submits layers to the compositor.
+     * Otherwise QCompositorLayer draws itself into the eye textures.
+     */
+    virtual bool supportsCompositorLayers() = 0;
+    /*!
+     * \brief setCompositorLayers submitted with the next swapToHeadset, on top of the eyes in the given order.
+     * Layers not listed anymore are removed. Images are only uploaded if the revision of a layer changed.
+     * Called every frame on the render thread.
      */
-    virtual void getMirrorTexture(QOpenGLTexture *outMirrorTexture) = 0;
+    virtual void setCompositorLayers(const QVector<CompositorLayer> &layers) = 0;
 
 };
 
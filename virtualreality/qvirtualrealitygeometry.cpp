@@ -33,13 +33,13 @@
 
 #include "qvirtualrealitygeometry.h"
 #include "qvirtualrealitygeometry_p.h"
+#include "meshoptimizer_p.h"
 #include <Qt3DRender/qbuffer.h>
 #include <Qt3DRender/qbufferdatagenerator.h>
 #include <Qt3DRender/qattribute.h>
 #include <QVector3D>
 #include <cmath>
 #include <qvirtualrealityapibackend.h>
-#include <QOpenGLTexture>
 
 QT_BEGIN_NAMESPACE
 
@@ -50,18 +50,19 @@ namespace Qt3DVirtualReality {
 class VirtualrealityVertexDataFunctor : public QBufferDataGenerator
 {
 public:
-    VirtualrealityVertexDataFunctor(QVirtualRealityApiBackend *apibackend, int trackedObjectIndex)
+    VirtualrealityVertexDataFunctor(QVirtualRealityApiBackend *apibackend, int trackedObjectIndex, int revision)
         : m_apibackend(apibackend)
         , m_trackedObjectIndex(trackedObjectIndex)
+        , m_revision(revision)
     {}
 
     QByteArray operator ()() Q_DECL_OVERRIDE
     {
         QVector<float> vertices;
         QVector<int> indices;
-        QOpenGLTexture tex(QOpenGLTexture::Target2D);
-        m_apibackend->getTrackedObjectModel(m_trackedObjectIndex, vertices, indices, &tex);
-        return QByteArray::fromRawData( reinterpret_cast<const char*>(vertices.constData()), sizeof(float) * vertices.size());
+        m_apibackend->getTrackedObjectModel(m_trackedObjectIndex, vertices, indices);
+        // Copy, vertices are local
+        return QByteArray(reinterpret_cast<const char*>(vertices.constData()), sizeof(float) * vertices.size());
     }
 
     bool operator ==(const QBufferDataGenerator &other) const Q_DECL_OVERRIDE
@@ -69,6 +70,7 @@ public:
         const VirtualrealityVertexDataFunctor *otherFunctor = functor_cast<VirtualrealityVertexDataFunctor>(&other);
         if (otherFunctor != nullptr)
             return (otherFunctor->m_trackedObjectIndex == m_trackedObjectIndex
+                 && otherFunctor->m_revision == m_revision
                  && otherFunctor->m_apibackend == m_apibackend);
         return false;
     }
@@ -78,6 +80,7 @@ public:
 private:
     QVirtualRealityApiBackend *m_apibackend;
     int m_trackedObjectIndex;
+    int m_revision; // Texture coordinates change once the texture is in the atlas
 };
 
 class VirtualrealityIndexDataFunctor : public QBufferDataGenerator
@@ -92,9 +95,9 @@ public:
     {
         QVector<float> vertices;
         QVector<int> indices;
-        QOpenGLTexture tex(QOpenGLTexture::Target2D);
-        m_apibackend->getTrackedObjectModel(m_trackedObjectIndex, vertices, indices, &tex);
-        return QByteArray::fromRawData( reinterpret_cast<const char*>(indices.constData()), sizeof(float) * indices.size());
+        m_apibackend->getTrackedObjectModel(m_trackedObjectIndex, vertices, indices);
+        // Must match the vertexBaseType chosen in QVirtualRealityGeometry::updateIndices()
+        return MeshOptimizer::packIndices(indices, MeshOptimizer::canUseShortIndices(vertices.count()/8));
     }
 
     bool operator ==(const QBufferDataGenerator &other) const Q_DECL_OVERRIDE
@@ -144,8 +147,7 @@ void QVirtualRealityGeometryPrivate::init()
     const quint32 stride = elementSize * sizeof(float);
 //    QVector<float> vertices;
 //    QVector<int> indices;
-//    QOpenGLTexture tex(QOpenGLTexture::Target2D);
-//    m_apibackend->getTrackedObjectModel(m_trackedObjectIndex, vertices, indices, &tex);
+//    m_apibackend->getTrackedObjectModel(m_trackedObjectIndex, vertices, indices);
     const int faces = 1;//indices.count()/3;
     const int nVerts = 3;//vertices.count()/elementSize;
 
@@ -255,13 +257,13 @@ void QVirtualRealityGeometry::updateVertices()
     //TO DO: do not query whole object here. lazy loading of vertex count
     QVector<float> vertices;
     QVector<int> indices;
-    QOpenGLTexture tex(QOpenGLTexture::Target2D);
-    d->m_apibackend->getTrackedObjectModel(d->m_trackedObjectIndex, vertices, indices, &tex);
+    d->m_apibackend->getTrackedObjectModel(d->m_trackedObjectIndex, vertices, indices);
 
     d->m_positionAttribute->setCount(vertices.count()/8);
     d->m_texCoordAttribute->setCount(vertices.count()/8);
     d->m_normalAttribute->setCount(vertices.count()/8);
-    d->m_vertexBuffer->setDataGenerator(QSharedPointer<VirtualrealityVertexDataFunctor>::create(d->m_apibackend, d->m_trackedObjectIndex));
+    const int revision = d->m_apibackend->getTrackedObjectModelRevision(d->m_trackedObjectIndex);
+    d->m_vertexBuffer->setDataGenerator(QSharedPointer<VirtualrealityVertexDataFunctor>::create(d->m_apibackend, d->m_trackedObjectIndex, revision));
 }
 
 /*!
@@ -275,9 +277,11 @@ void QVirtualRealityGeometry::updateIndices()
     //TO DO: do not query whole object here. lazy loading of vertex count
     QVector<float> vertices;
     QVector<int> indices;
-    QOpenGLTexture tex(QOpenGLTexture::Target2D);
-    d->m_apibackend->getTrackedObjectModel(d->m_trackedObjectIndex, vertices, indices, &tex);
+    d->m_apibackend->getTrackedObjectModel(d->m_trackedObjectIndex, vertices, indices);
 
+    // Indices of the model cache are already optimized for the vertex cache. Halve the index bandwidth if possible.
+    d->m_indexAttribute->setVertexBaseType(MeshOptimizer::canUseShortIndices(vertices.count()/8) ? QAttribute::UnsignedShort
+                                                                                                  : QAttribute::UnsignedInt);
     d->m_indexAttribute->setCount(indices.count());
     d->m_indexBuffer->setDataGenerator(QSharedPointer<VirtualrealityIndexDataFunctor>::create(d->m_apibackend, d->m_trackedObjectIndex));
 }
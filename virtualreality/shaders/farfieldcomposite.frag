@@ -0,0 +1,19 @@
+#version 150 core
+
+in vec2 targetCoord;
+
+// Drawn once from between the eyes, everything beyond the far field distance
+uniform sampler2D farField;
+// Normalized eye coordinates to far field coordinates, a homography in the upper 3x3
+uniform mat4 leftMapping;
+uniform mat4 rightMapping;
+
+out vec4 fragColor;
+
+void main()
+{
+    bool rightEye = targetCoord.x >= 0.5;
+    vec2 eyeCoord = vec2(rightEye ? targetCoord.x * 2.0 - 1.0 : targetCoord.x * 2.0, targetCoord.y);
+    vec3 farFieldCoord = ((rightEye ? rightMapping : leftMapping) * vec4(eyeCoord, 1.0, 1.0)).xyz;
+    fragColor = texture(farField, farFieldCoord.xy / farFieldCoord.z);
+}
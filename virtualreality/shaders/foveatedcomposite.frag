@@ -0,0 +1,36 @@
+#version 150 core
+
+in vec2 targetCoord;
+
+uniform sampler2D leftPeriphery;
+uniform sampler2D rightPeriphery;
+uniform sampler2D leftCenter;
+uniform sampler2D rightCenter;
+// x, y, width, height of the full resolution region in normalized eye coordinates
+uniform vec4 leftCenterRect;
+uniform vec4 rightCenterRect;
+
+out vec4 fragColor;
+
+// Width of the blend between center and periphery, relative to the center
+const float edgeWidth = 0.05;
+
+void main()
+{
+    bool rightEye = targetCoord.x >= 0.5;
+    vec2 eyeCoord = vec2(rightEye ? targetCoord.x * 2.0 - 1.0 : targetCoord.x * 2.0, targetCoord.y);
+    vec4 centerRect = rightEye ? rightCenterRect : leftCenterRect;
+
+    // Bilinear upscale of the periphery
+    vec4 periphery = rightEye ? texture(rightPeriphery, eyeCoord) : texture(leftPeriphery, eyeCoord);
+
+    vec2 centerCoord = (eyeCoord - centerRect.xy) / centerRect.zw;
+    vec2 edge = min(centerCoord, 1.0 - centerCoord);
+    float weight = smoothstep(0.0, edgeWidth, min(edge.x, edge.y));
+    if (weight <= 0.0) {
+        fragColor = periphery;
+        return;
+    }
+    vec4 center = rightEye ? texture(rightCenter, centerCoord) : texture(leftCenter, centerCoord);
+    fragColor = mix(periphery, center, weight);
+}
@@ -0,0 +1,16 @@
+#version 150 core
+
+// Normalized coordinates of the whole side by side target
+in vec2 vertexPosition;
+
+// Depth ranges 0..1 with near at 1
+uniform bool reverseDepth;
+
+out vec2 targetCoord;
+
+void main()
+{
+    targetCoord = vertexPosition;
+    // Just in front of the far plane, pixels primed by the hidden area mask keep their color
+    gl_Position = vec4(vertexPosition * 2.0 - 1.0, reverseDepth ? 0.001 : 0.999, 1.0);
+}
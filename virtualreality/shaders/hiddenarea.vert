@@ -0,0 +1,13 @@
+#version 150 core
+
+// Normalized coordinates of the whole side by side target
+in vec2 vertexPosition;
+
+// Depth ranges 0..1 with near at 1
+uniform bool reverseDepth;
+
+void main()
+{
+    // On the near plane, every fragment of the scene behind it fails the depth test
+    gl_Position = vec4(vertexPosition * 2.0 - 1.0, reverseDepth ? 1.0 : -1.0, 1.0);
+}
@@ -0,0 +1,25 @@
+#version 150 core
+
+in vec3 worldPosition;
+in vec3 worldNormal;
+in vec3 worldView;
+
+out vec4 fragColor;
+
+uniform vec4 ambient;
+uniform vec4 diffuse;
+uniform vec4 specular;
+uniform float shininess;
+uniform vec3 lightDirection;
+
+void main()
+{
+    vec3 n = normalize(worldNormal);
+    vec3 l = normalize(-lightDirection);
+    vec3 v = normalize(worldView);
+    float diffuseFactor = max(dot(n, l), 0.0);
+    float specularFactor = 0.0;
+    if (diffuseFactor > 0.0)
+        specularFactor = pow(max(dot(reflect(-l, n), v), 0.0), shininess);
+    fragColor = vec4(ambient.rgb + diffuseFactor * diffuse.rgb + specularFactor * specular.rgb, diffuse.a);
+}
@@ -0,0 +1,21 @@
+#version 150 core
+
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+
+out vec3 worldPosition;
+out vec3 worldNormal;
+out vec3 worldView;
+
+uniform mat4 modelMatrix;
+uniform mat3 modelNormalMatrix;
+uniform mat4 modelViewProjection;
+uniform vec3 eyePosition;
+
+void main()
+{
+    worldPosition = vec3(modelMatrix * vec4(vertexPosition, 1.0));
+    worldNormal = normalize(modelNormalMatrix * vertexNormal);
+    worldView = eyePosition - worldPosition;
+    gl_Position = modelViewProjection * vec4(vertexPosition, 1.0);
+}
@@ -0,0 +1,18 @@
+#version 150 core
+
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+
+// Projected per eye in phong_layered.geom
+out vec3 vertexWorldPosition;
+out vec3 vertexWorldNormal;
+
+uniform mat4 modelMatrix;
+uniform mat3 modelNormalMatrix;
+
+void main()
+{
+    vertexWorldPosition = vec3(modelMatrix * vec4(vertexPosition, 1.0));
+    vertexWorldNormal = normalize(modelNormalMatrix * vertexNormal);
+    gl_Position = vec4(vertexWorldPosition, 1.0);
+}
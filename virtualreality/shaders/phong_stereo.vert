@@ -0,0 +1,47 @@
+#version 150 core
+
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+
+out vec3 worldPosition;
+out vec3 worldNormal;
+out vec3 worldView;
+out float gl_ClipDistance[1];
+
+// Provided by StereoFrameGraph, see QVirtualrealityCamera::stereoUniformBuffer
+layout(std140) uniform StereoEyes {
+    mat4 eyeViewProjection[2];
+    vec4 eyePosition[2];
+};
+
+uniform mat4 modelMatrix;
+uniform mat3 modelNormalMatrix;
+
+// Set by offscreen branches of StereoFrameGraph, which draw the doubled instances with their own camera
+uniform bool monoView;
+uniform mat4 viewProjectionMatrix;
+uniform mat4 inverseViewMatrix;
+
+void main()
+{
+    // Each draw is issued with twice the instance count, even instances are the left eye
+    int eye = gl_InstanceID % 2;
+    worldPosition = vec3(modelMatrix * vec4(vertexPosition, 1.0));
+    worldNormal = normalize(modelNormalMatrix * vertexNormal);
+    worldView = eyePosition[eye].xyz - worldPosition;
+
+    if (monoView) {
+        // Odd instances are moved outside the clip volume, every mesh is drawn once
+        worldView = inverseViewMatrix[3].xyz - worldPosition;
+        gl_ClipDistance[0] = 1.0;
+        gl_Position = eye == 0 ? viewProjectionMatrix * vec4(worldPosition, 1.0) : vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+
+    vec4 clipPosition = eyeViewProjection[eye] * vec4(worldPosition, 1.0);
+    // Move into the half of the side by side target of the eye and clip at the center
+    float side = float(eye) * 2.0 - 1.0;
+    gl_ClipDistance[0] = clipPosition.w + side * clipPosition.x;
+    clipPosition.x = 0.5 * (clipPosition.x + side * clipPosition.w);
+    gl_Position = clipPosition;
+}
@@ -0,0 +1,13 @@
+#version 150 core
+
+in vec2 targetCoord;
+
+// Side by side result of temporal upsampling, same size as the target
+uniform sampler2D resolved;
+
+out vec4 fragColor;
+
+void main()
+{
+    fragColor = texture(resolved, targetCoord);
+}
@@ -0,0 +1,63 @@
+#version 150 core
+
+in vec2 targetCoord;
+
+// Jittered eyes of this frame at reduced resolution
+uniform sampler2D leftCurrent;
+uniform sampler2D rightCurrent;
+uniform sampler2D leftDepth;
+uniform sampler2D rightDepth;
+// Side by side result of the previous frame
+uniform sampler2D history;
+// Clip coordinates of this frame to those of the previous frame, both without jitter
+uniform mat4 leftReprojection;
+uniform mat4 rightReprojection;
+// The scene appears moved by jitter in the current textures, in normalized eye coordinates
+uniform vec2 jitter;
+// Weight of the history
+uniform float feedback;
+// Depth ranges 0..1 with near at 1, it is the normalized device coordinate then
+uniform bool reverseDepth;
+
+out vec4 fragColor;
+
+vec4 current(bool rightEye, vec2 coord)
+{
+    return rightEye ? texture(rightCurrent, coord) : texture(leftCurrent, coord);
+}
+
+void main()
+{
+    bool rightEye = targetCoord.x >= 0.5;
+    vec2 eyeCoord = vec2(rightEye ? targetCoord.x * 2.0 - 1.0 : targetCoord.x * 2.0, targetCoord.y);
+    vec2 currentSize = vec2(rightEye ? textureSize(rightCurrent, 0) : textureSize(leftCurrent, 0));
+
+    // Undo the jitter, then bound the history by the neighbourhood of the pixel
+    vec2 currentCoord = eyeCoord + jitter;
+    vec4 color = current(rightEye, currentCoord);
+    vec4 minColor = color;
+    vec4 maxColor = color;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            vec4 neighbour = current(rightEye, currentCoord + vec2(x, y) / currentSize);
+            minColor = min(minColor, neighbour);
+            maxColor = max(maxColor, neighbour);
+        }
+    }
+
+    ivec2 depthTexel = clamp(ivec2(currentCoord * currentSize), ivec2(0), ivec2(currentSize) - 1);
+    float depth = rightEye ? texelFetch(rightDepth, depthTexel, 0).r : texelFetch(leftDepth, depthTexel, 0).r;
+    vec4 previous = (rightEye ? rightReprojection : leftReprojection) * vec4(eyeCoord * 2.0 - 1.0, reverseDepth ? depth : depth * 2.0 - 1.0, 1.0);
+    vec2 previousCoord = previous.xy / previous.w * 0.5 + 0.5;
+    if (previous.w <= 0.0 || any(lessThan(previousCoord, vec2(0.0))) || any(greaterThan(previousCoord, vec2(1.0)))) {
+        // Not visible last frame
+        fragColor = color;
+        return;
+    }
+
+    // Stay inside the half of the eye
+    float halfTexel = 0.5 / float(textureSize(history, 0).x);
+    vec2 historyCoord = vec2(clamp(previousCoord.x * 0.5, halfTexel, 0.5 - halfTexel) + (rightEye ? 0.5 : 0.0), previousCoord.y);
+    vec4 historyColor = clamp(texture(history, historyCoord), minColor, maxColor);
+    fragColor = mix(color, historyColor, feedback);
+}
@@ -0,0 +1,15 @@
+#version 150 core
+
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+
+// Projected per eye in trackedobject_layered.geom
+out vec2 vertexLayeredTexCoord;
+
+uniform mat4 modelMatrix;
+
+void main()
+{
+    vertexLayeredTexCoord = vertexTexCoord;
+    gl_Position = modelMatrix * vec4(vertexPosition, 1.0);
+}
@@ -0,0 +1,21 @@
+#version 150 core
+
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in float vertexTrackedObjectSlot;
+
+out vec2 texCoord;
+
+// Must match QTrackedObjectsLayer::MaxTrackedObjects
+layout(std140) uniform TrackedObjectTransforms {
+    mat4 transforms[64];
+};
+
+uniform mat4 modelMatrix;
+uniform mat4 viewProjectionMatrix;
+
+void main()
+{
+    texCoord = vertexTexCoord;
+    gl_Position = viewProjectionMatrix * modelMatrix * transforms[int(vertexTrackedObjectSlot)] * vec4(vertexPosition, 1.0);
+}
@@ -0,0 +1,21 @@
+#version 150 core
+
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in float vertexTrackedObjectSlot;
+
+// Projected per eye in trackedobject_layered.geom
+out vec2 vertexLayeredTexCoord;
+
+// Must match QTrackedObjectsLayer::MaxTrackedObjects
+layout(std140) uniform TrackedObjectTransforms {
+    mat4 transforms[64];
+};
+
+uniform mat4 modelMatrix;
+
+void main()
+{
+    vertexLayeredTexCoord = vertexTexCoord;
+    gl_Position = modelMatrix * transforms[int(vertexTrackedObjectSlot)] * vec4(vertexPosition, 1.0);
+}
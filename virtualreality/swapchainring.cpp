@@ -0,0 +1,251 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#include "swapchainring_p.h"
+#include "eyetexturearray_p.h"
+
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions_3_2_Core>
+#include <QDebug>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+SwapChainRing::SwapChainRing()
+    : m_current(0)
+    , m_layout(QHeadMountedDisplayFormat::SideBySide)
+    , m_floatDepth(false)
+    , m_funcs(nullptr)
+{
+}
+
+SwapChainRing::~SwapChainRing()
+{
+    // Gpu resources are freed in destroy(), there is no context here.
+}
+
+bool SwapChainRing::create(const QSize &size, QHeadMountedDisplayFormat::RenderTargetLayout layout, int length, int samples, bool floatDepth)
+{
+    if (!m_funcs) {
+        m_funcs = QOpenGLContext::currentContext()->versionFunctions<QOpenGLFunctions_3_2_Core>();
+        if (!m_funcs) {
+            qWarning() << "Could not get OpenGLFunctions 3.2, no swap chain";
+            return false;
+        }
+        m_funcs->initializeOpenGLFunctions();
+    }
+    destroy();
+    m_layout = layout;
+    m_size = size;
+    m_floatDepth = floatDepth;
+    m_images.resize(qMax(1, length));
+    for (Image &image : m_images) {
+        if (layout == QHeadMountedDisplayFormat::EyeTextureArray) {
+            image.textureArray = new EyeTextureArray;
+            if (!image.textureArray->create(size, 0, floatDepth)) {
+                destroy();
+                return false;
+            }
+        } else {
+            // Depth is a texture instead of the renderbuffer of QOpenGLFramebufferObject, so it can be submitted
+            image.fbo = new QOpenGLFramebufferObject(size, QOpenGLFramebufferObject::NoAttachment);
+            if (!image.fbo->isValid() || !attachDepthTexture(image, 0)) {
+                qWarning() << "Could not create swap chain framebuffer of size" << size;
+                destroy();
+                return false;
+            }
+        }
+    }
+    if (samples > 1) {
+        if (layout == QHeadMountedDisplayFormat::EyeTextureArray) {
+            m_multisampled.textureArray = new EyeTextureArray;
+            if (!m_multisampled.textureArray->create(size, samples, floatDepth)) {
+                destroy();
+                return false;
+            }
+        } else {
+            QOpenGLFramebufferObjectFormat format;
+            format.setAttachment(QOpenGLFramebufferObject::NoAttachment);
+            format.setSamples(samples);
+            m_multisampled.fbo = new QOpenGLFramebufferObject(size, format);
+            // Same depth format as the depth texture it is resolved into
+            if (!m_multisampled.fbo->isValid() || !attachDepthTexture(m_multisampled, m_multisampled.fbo->format().samples())) {
+                qWarning() << "Could not create multisampled framebuffer with" << samples << "samples";
+                destroy();
+                return false;
+            }
+        }
+    }
+    m_current = 0;
+    return true;
+}
+
+bool SwapChainRing::attachDepthTexture(Image &image, int samples)
+{
+    const GLenum internalFormat = m_floatDepth ? GL_DEPTH32F_STENCIL8 : GL_DEPTH24_STENCIL8;
+    const GLenum target = samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+    m_funcs->glGenTextures(1, &image.depthTexture);
+    m_funcs->glBindTexture(target, image.depthTexture);
+    if (samples > 1) {
+        // Fixed sample locations, the color attachment of QOpenGLFramebufferObject is a renderbuffer
+        m_funcs->glTexImage2DMultisample(target, samples, internalFormat, m_size.width(), m_size.height(), GL_TRUE);
+    } else {
+        m_funcs->glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        m_funcs->glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        m_funcs->glTexImage2D(target, 0, internalFormat, m_size.width(), m_size.height(), 0, GL_DEPTH_STENCIL,
+                              m_floatDepth ? GL_FLOAT_32_UNSIGNED_INT_24_8_REV : GL_UNSIGNED_INT_24_8, nullptr);
+    }
+    m_funcs->glBindTexture(target, 0);
+    image.fbo->bind();
+    m_funcs->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, target, image.depthTexture, 0);
+    const GLenum status = m_funcs->glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    image.fbo->release();
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        qWarning() << "Swap chain framebuffer with depth texture is incomplete, status:" << status;
+        return false;
+    }
+    return true;
+}
+
+void SwapChainRing::destroy()
+{
+    for (Image &image : m_images) {
+        if (image.fence != 0)
+            m_funcs->glDeleteSync(image.fence);
+        delete image.fbo;
+        if (image.depthTexture)
+            m_funcs->glDeleteTextures(1, &image.depthTexture);
+        if (image.textureArray)
+            image.textureArray->destroy();
+        delete image.textureArray;
+    }
+    m_images.clear();
+    delete m_multisampled.fbo;
+    if (m_multisampled.depthTexture)
+        m_funcs->glDeleteTextures(1, &m_multisampled.depthTexture);
+    if (m_multisampled.textureArray)
+        m_multisampled.textureArray->destroy();
+    delete m_multisampled.textureArray;
+    m_multisampled = Image();
+    m_current = 0;
+}
+
+bool SwapChainRing::bindCurrent()
+{
+    if (m_images.isEmpty())
+        return false;
+    Image &image = m_images[m_current];
+    if (image.fence != 0) {
+        // Zero timeout: only poll. With 2-3 images the copy of the compositor has long finished.
+        const GLenum result = m_funcs->glClientWaitSync(image.fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+            m_funcs->glWaitSync(image.fence, 0, GL_TIMEOUT_IGNORED); // Order on the gpu, the cpu goes on
+        m_funcs->glDeleteSync(image.fence);
+        image.fence = 0;
+    }
+    if (m_multisampled.textureArray)
+        return m_multisampled.textureArray->bind();
+    if (m_multisampled.fbo)
+        return m_multisampled.fbo->bind();
+    if (image.textureArray)
+        return image.textureArray->bind();
+    return image.fbo->bind();
+}
+
+void SwapChainRing::resolveCurrent(bool depth)
+{
+    if (m_images.isEmpty())
+        return;
+    Image &image = m_images[m_current];
+    const GLbitfield buffers = depth ? GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT;
+    // Depth blits must be nearest, averaging depth samples would be meaningless anyway
+    if (m_multisampled.textureArray) {
+        m_multisampled.textureArray->resolveTo(*image.textureArray, buffers);
+    } else if (m_multisampled.fbo) {
+        const QRect rect(QPoint(0, 0), m_size);
+        QOpenGLFramebufferObject::blitFramebuffer(image.fbo, rect, m_multisampled.fbo, rect, buffers, GL_NEAREST);
+    }
+}
+
+GLuint SwapChainRing::currentColorTexture() const
+{
+    if (m_images.isEmpty())
+        return 0;
+    const Image &image = m_images[m_current];
+    if (image.textureArray)
+        return image.textureArray->colorTexture();
+    return image.fbo->texture();
+}
+
+GLuint SwapChainRing::currentDepthTexture() const
+{
+    if (m_images.isEmpty())
+        return 0;
+    const Image &image = m_images[m_current];
+    if (image.textureArray)
+        return image.textureArray->depthTexture();
+    return image.depthTexture;
+}
+
+GLuint SwapChainRing::submittedColorTexture() const
+{
+    if (m_images.isEmpty())
+        return 0;
+    const Image &image = m_images[(m_current + m_images.size() - 1) % m_images.size()];
+    if (image.textureArray)
+        return image.textureArray->colorTexture();
+    return image.fbo->texture();
+}
+
+GLuint SwapChainRing::submittedDepthTexture() const
+{
+    if (m_images.isEmpty())
+        return 0;
+    const Image &image = m_images[(m_current + m_images.size() - 1) % m_images.size()];
+    if (image.textureArray)
+        return image.textureArray->depthTexture();
+    return image.depthTexture;
+}
+
+void SwapChainRing::advance()
+{
+    if (m_images.isEmpty())
+        return;
+    Image &image = m_images[m_current];
+    // Signals when the gpu passed the submit, including the copy the compositor queued on our context
+    image.fence = m_funcs->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_current = (m_current + 1) % m_images.size();
+}
+
+bool SwapChainRing::isCreated() const
+{
+    return !m_images.isEmpty();
+}
+
+QHeadMountedDisplayFormat::RenderTargetLayout SwapChainRing::layout() const
+{
+    return m_layout;
+}
+
+int SwapChainRing::length() const
+{
+    return m_images.size();
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
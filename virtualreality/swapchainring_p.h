@@ -0,0 +1,117 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+
+#ifndef QT3DVIRTUALREALITY_SWAPCHAINRING_P_H
+#define QT3DVIRTUALREALITY_SWAPCHAINRING_P_H
+
+#include "qvirtualrealityapi.h"
+
+#include <QSize>
+#include <QVector>
+#include <qopengl.h>
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLFramebufferObject;
+class QOpenGLFunctions_3_2_Core;
+
+namespace Qt3DVirtualReality {
+
+class EyeTextureArray;
+
+/*!
+ * \brief The SwapChainRing class rotates through render targets for runtimes that copy the submitted texture.
+ * After submit a fence is inserted for the image, the next frame renders into the next image.
+ * An image is reused only after its fence signaled, so the gpu never waits for the compositor copy
+ * of the previous frame. The wait for a late fence happens on the gpu, not on the cpu.
+ * With multisampling, all frames are rendered into one multisampled target, resolveCurrent
+ * blits it into the image before submit.
+ * Every image has a depth texture, so depth can be submitted to the compositor.
+ */
+class SwapChainRing
+{
+public:
+    SwapChainRing();
+    ~SwapChainRing();
+
+    /*!
+     * \brief create allocates \a length images. Context must be current.
+     * \param size of the side by side target, or of one eye with QHeadMountedDisplayFormat::EyeTextureArray
+     * \param samples more than 1 renders into a multisampled target
+     * \param floatDepth depth32f stencil8 instead of depth24 stencil8, for QHeadMountedDisplayFormat::reverseDepth
+     */
+    bool create(const QSize &size, QHeadMountedDisplayFormat::RenderTargetLayout layout, int length, int samples = 0,
+                bool floatDepth = false);
+    /*!
+     * \brief destroy deletes all images and fences. Context must be current.
+     */
+    void destroy();
+
+    /*!
+     * \brief bindCurrent binds the framebuffer of the current image for rendering,
+     * or the multisampled target.
+     */
+    bool bindCurrent();
+    /*!
+     * \brief resolveCurrent resolves the multisampled target into the current image. Call before submit.
+     * \param depth also resolves depth, when it is submitted
+     */
+    void resolveCurrent(bool depth = false);
+    /*!
+     * \brief currentColorTexture to submit, a 2 layer array with EyeTextureArray.
+     */
+    GLuint currentColorTexture() const;
+    /*!
+     * \brief currentDepthTexture to submit, packed depth stencil, a 2 layer array with EyeTextureArray.
+     */
+    GLuint currentDepthTexture() const;
+    /*!
+     * \brief submittedColorTexture is the color texture of the image submitted last, valid after advance.
+     */
+    GLuint submittedColorTexture() const;
+    GLuint submittedDepthTexture() const;
+    /*!
+     * \brief advance fences the current image after it was submitted and moves to the next one.
+     */
+    void advance();
+
+    bool isCreated() const;
+    QHeadMountedDisplayFormat::RenderTargetLayout layout() const;
+    int length() const;
+
+private:
+    struct Image {
+        Image() : fbo(nullptr), depthTexture(0), textureArray(nullptr), fence(0) {}
+        QOpenGLFramebufferObject *fbo;
+        GLuint depthTexture; // Attached to fbo
+        EyeTextureArray *textureArray;
+        GLsync fence;
+    };
+    bool attachDepthTexture(Image &image, int samples);
+
+    QVector<Image> m_images;
+    Image m_multisampled; // Never submitted, has no fence
+    QSize m_size;
+    int m_current;
+    QHeadMountedDisplayFormat::RenderTargetLayout m_layout;
+    bool m_floatDepth;
+    QOpenGLFunctions_3_2_Core *m_funcs;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_SWAPCHAINRING_P_H
@@ -0,0 +1,183 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#include "textureatlas_p.h"
+
+#include <QImage>
+#include <QDebug>
+
+#include <cstring>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+namespace {
+
+// Not a texture id of the sdks, those are never negative
+const int FallbackKey = std::numeric_limits<int>::min();
+
+// Opaque mid gray, drawn where a texture is missing
+QByteArray fallbackTexel()
+{
+    return QByteArray("\x80\x80\x80\xff", 4);
+}
+
+} // anonymous
+
+TextureAtlas::TextureAtlas(int size, int padding)
+    : m_size(size)
+    , m_padding(padding)
+{
+}
+
+bool TextureAtlas::insert(int key, const QSize &size, const QByteArray &rgbaData)
+{
+    if (m_rects.contains(key))
+        return true;
+    // Placed before the atlas can fill up
+    if (key != FallbackKey && !m_rects.contains(FallbackKey))
+        insert(FallbackKey, QSize(1, 1), fallbackTexel());
+
+    QImage image(reinterpret_cast<const uchar*>(rgbaData.constData()), size.width(), size.height(), QImage::Format_RGBA8888);
+    QRect rect;
+    while (!allocate(image.size(), rect)) {
+        if (image.width() <= 1 && image.height() <= 1)
+            return false;
+        qWarning() << "Texture" << key << "does not fit into the atlas, downscaling it to half the size.";
+        image = image.scaled(qMax(1, image.width() / 2), qMax(1, image.height() / 2), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    // Allocate lazily, an atlas without textures costs nothing
+    if (m_data.isEmpty())
+        m_data.fill(0, m_size * m_size * 4);
+    // Half of the padding around the texture belongs to it, the other half to its neighbour
+    const int before = m_padding / 2;
+    const int after = m_padding - before;
+    const QRect region = rect.adjusted(-before, -before, after, after).intersected(QRect(0, 0, m_size, m_size));
+    char *dst = m_data.data();
+    for (int y = region.top(); y <= region.bottom(); ++y) {
+        const uchar *src = image.constScanLine(qBound(0, y - rect.y(), rect.height() - 1));
+        char *row = dst + (y * m_size + region.x()) * 4;
+        for (int x = region.left(); x < rect.left(); ++x, row += 4)
+            memcpy(row, src, 4);
+        memcpy(row, src, rect.width() * 4);
+        row += rect.width() * 4;
+        for (int x = rect.right() + 1; x <= region.right(); ++x, row += 4)
+            memcpy(row, src + (rect.width() - 1) * 4, 4);
+    }
+
+    m_rects.insert(key, rect);
+    m_regions.append(region);
+    return true;
+}
+
+bool TextureAtlas::contains(int key) const
+{
+    return m_rects.contains(key);
+}
+
+bool TextureAtlas::isEmpty() const
+{
+    return m_rects.isEmpty();
+}
+
+QRectF TextureAtlas::normalizedRect(int key) const
+{
+    const QRect rect = m_rects.value(key);
+    const qreal scale = 1.0 / m_size;
+    return QRectF(rect.x() * scale, rect.y() * scale, rect.width() * scale, rect.height() * scale);
+}
+
+void TextureAtlas::remapTexCoords(int key, QVector<float> &vertices, int vertexSize, int texCoordOffset) const
+{
+    const QRectF rect = normalizedRect(key);
+    float *texCoord = vertices.data() + texCoordOffset;
+    for (int i = 0; i < vertices.size() / vertexSize; ++i, texCoord += vertexSize) {
+        texCoord[0] = rect.x() + texCoord[0] * rect.width();
+        texCoord[1] = rect.y() + texCoord[1] * rect.height();
+    }
+}
+
+bool TextureAtlas::remapToFallback(QVector<float> &vertices, int vertexSize, int texCoordOffset)
+{
+    if (!insert(FallbackKey, QSize(1, 1), fallbackTexel()))
+        return false;
+    // Center of the texel, its gutter keeps the finer mip levels gray as well
+    const QPointF center = normalizedRect(FallbackKey).center();
+    float *texCoord = vertices.data() + texCoordOffset;
+    for (int i = 0; i < vertices.size() / vertexSize; ++i, texCoord += vertexSize) {
+        texCoord[0] = center.x();
+        texCoord[1] = center.y();
+    }
+    return true;
+}
+
+QSize TextureAtlas::size() const
+{
+    return QSize(m_size, m_size);
+}
+
+int TextureAtlas::regionCount() const
+{
+    return m_regions.size();
+}
+
+QRect TextureAtlas::region(int index) const
+{
+    return m_regions.at(index);
+}
+
+QByteArray TextureAtlas::regionData(const QRect &rect) const
+{
+    QByteArray data(rect.width() * rect.height() * 4, Qt::Uninitialized);
+    for (int y = 0; y < rect.height(); ++y)
+        memcpy(data.data() + y * rect.width() * 4, m_data.constData() + ((rect.y() + y) * m_size + rect.x()) * 4, rect.width() * 4);
+    return data;
+}
+
+bool TextureAtlas::allocate(const QSize &size, QRect &rect)
+{
+    const int width = size.width() + m_padding;
+    const int height = size.height() + m_padding;
+    if (width > m_size || height > m_size)
+        return false;
+
+    // Best fitting shelf with enough space left
+    Shelf *best = nullptr;
+    for (Shelf &shelf : m_shelves) {
+        if (shelf.height >= height && m_size - shelf.nextX >= width
+                && (!best || shelf.height < best->height))
+            best = &shelf;
+    }
+    if (!best) {
+        const int y = m_shelves.isEmpty() ? 0 : m_shelves.last().y + m_shelves.last().height;
+        if (m_size - y < height)
+            return false;
+        Shelf shelf;
+        shelf.y = y;
+        shelf.height = height;
+        shelf.nextX = 0;
+        m_shelves.append(shelf);
+        best = &m_shelves.last();
+    }
+    rect = QRect(best->nextX, best->y, size.width(), size.height());
+    best->nextX += width;
+    return true;
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
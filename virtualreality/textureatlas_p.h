@@ -0,0 +1,106 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#ifndef QT3DVIRTUALREALITY_TEXTUREATLAS_P_H
+#define QT3DVIRTUALREALITY_TEXTUREATLAS_P_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QRect>
+#include <QRectF>
+#include <QSize>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The TextureAtlas class packs the textures of all tracked object models into one rgba texture.
+ * Shelf packing, textures never move once inserted. Textures that do not fit are downscaled.
+ * Gutters repeat the edge texels of their texture, so mip levels do not bleed in neighbours or black.
+ * A gray fallback texel is reserved with the first texture, for models whose texture is missing.
+ * Not thread safe, the owner has to lock.
+ */
+class TextureAtlas
+{
+public:
+    explicit TextureAtlas(int size = 2048, int padding = 4);
+
+    /*!
+     * \brief insert copies a texture into the atlas.
+     * \param key identifies the texture, e.g. the texture id of the sdk
+     * \param rgbaData tightly packed 8 bit rgba pixels
+     * \return false if the texture could not be placed, even downscaled
+     */
+    bool insert(int key, const QSize &size, const QByteArray &rgbaData);
+    bool contains(int key) const;
+    bool isEmpty() const;
+
+    /*!
+     * \brief normalizedRect of the texture in texture coordinates of the atlas.
+     */
+    QRectF normalizedRect(int key) const;
+
+    /*!
+     * \brief remapTexCoords transforms texture coordinates of interleaved vertices into the atlas.
+     * \param vertices interleaved vertex data
+     * \param vertexSize number of floats per vertex
+     * \param texCoordOffset offset of the texture coordinate in floats
+     */
+    void remapTexCoords(int key, QVector<float> &vertices, int vertexSize, int texCoordOffset) const;
+    /*!
+     * \brief remapToFallback points all texture coordinates of interleaved vertices at the fallback texel,
+     * e.g. for a model whose texture could not be inserted. Parameters as for remapTexCoords.
+     * \return false if not even the fallback texel fits
+     */
+    bool remapToFallback(QVector<float> &vertices, int vertexSize, int texCoordOffset);
+
+    QSize size() const;
+
+    /*!
+     * \brief regionCount of the atlas written so far, each insert adds one region.
+     * Uploading the regions added since the last upload keeps a copy on the gpu up to date.
+     */
+    int regionCount() const;
+    /*!
+     * \brief region of the atlas written by an insert, including its gutter.
+     */
+    QRect region(int index) const;
+    /*!
+     * \brief regionData tightly packed rgba pixels of \a rect.
+     */
+    QByteArray regionData(const QRect &rect) const;
+
+private:
+    struct Shelf {
+        int y;
+        int height;
+        int nextX;
+    };
+    bool allocate(const QSize &size, QRect &rect);
+
+    int m_size;
+    int m_padding;
+    QVector<Shelf> m_shelves;
+    QHash<int, QRect> m_rects;
+    QByteArray m_data;
+    QVector<QRect> m_regions;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_TEXTUREATLAS_P_H
@@ -0,0 +1,138 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#include "textureuploader_p.h"
+
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions_3_2_Core>
+#include <QDebug>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DVirtualReality {
+
+TextureUploader::TextureUploader(int ringSize)
+    : m_slots(qMax(1, ringSize))
+    , m_funcs(nullptr)
+{
+}
+
+TextureUploader::~TextureUploader()
+{
+    // Gpu resources are freed in releaseResources(), there is no context here.
+}
+
+void TextureUploader::enqueue(GLuint textureId, const QRect &rect, const QByteArray &rgbaData)
+{
+    Q_ASSERT(rgbaData.size() >= rect.width() * rect.height() * 4);
+    QMutexLocker lock(&m_mutex);
+    PendingUpload upload;
+    upload.textureId = textureId;
+    upload.rect = rect;
+    upload.data = rgbaData;
+    m_pending.enqueue(upload);
+}
+
+void TextureUploader::processUploads()
+{
+    if (!m_funcs) {
+        m_funcs = QOpenGLContext::currentContext()->versionFunctions<QOpenGLFunctions_3_2_Core>();
+        if (!m_funcs) {
+            qWarning() << "Could not get OpenGLFunctions 3.2, textures will not be uploaded";
+            return;
+        }
+        m_funcs->initializeOpenGLFunctions();
+    }
+
+    for (Slot &slot : m_slots) {
+        if (slot.fence != 0) {
+            // Zero timeout: only poll, never wait for the gpu
+            const GLenum result = m_funcs->glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (result == GL_TIMEOUT_EXPIRED)
+                continue;
+            if (result == GL_WAIT_FAILED)
+                qWarning() << "Waiting for texture upload failed";
+            m_funcs->glDeleteSync(slot.fence);
+            slot.fence = 0;
+        }
+
+        PendingUpload upload;
+        {
+            QMutexLocker lock(&m_mutex);
+            if (m_pending.isEmpty())
+                return;
+            upload = m_pending.dequeue();
+        }
+        startUpload(slot, upload);
+    }
+}
+
+void TextureUploader::startUpload(Slot &slot, const PendingUpload &upload)
+{
+    if (!slot.buffer) {
+        slot.buffer = new QOpenGLBuffer(QOpenGLBuffer::PixelUnpackBuffer);
+        slot.buffer->setUsagePattern(QOpenGLBuffer::StreamDraw);
+        slot.buffer->create();
+    }
+    const int byteCount = upload.rect.width() * upload.rect.height() * 4;
+    slot.buffer->bind();
+    if (slot.buffer->size() < byteCount)
+        slot.buffer->allocate(byteCount);
+
+    // The fence of this slot has signaled, nothing reads from the buffer anymore.
+    void *dst = slot.buffer->mapRange(0, byteCount, QOpenGLBuffer::RangeWrite
+                                                  | QOpenGLBuffer::RangeInvalidateBuffer
+                                                  | QOpenGLBuffer::RangeUnsynchronized);
+    if (!dst) {
+        qWarning() << "Could not map pixel buffer for texture upload, texture:" << upload.textureId;
+        slot.buffer->release();
+        return;
+    }
+    memcpy(dst, upload.data.constData(), byteCount);
+    slot.buffer->unmap();
+
+    // The texture belongs to Qt3D, which tracks its own bindings. Restore the previous one.
+    GLint previousTexture = 0;
+    m_funcs->glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+    m_funcs->glBindTexture(GL_TEXTURE_2D, upload.textureId);
+    m_funcs->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    // Source is the bound pixel unpack buffer, offset 0
+    m_funcs->glTexSubImage2D(GL_TEXTURE_2D, 0, upload.rect.x(), upload.rect.y(), upload.rect.width(), upload.rect.height(),
+                             GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    slot.buffer->release();
+    m_funcs->glGenerateMipmap(GL_TEXTURE_2D);
+    m_funcs->glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previousTexture));
+
+    slot.fence = m_funcs->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void TextureUploader::releaseResources()
+{
+    for (Slot &slot : m_slots) {
+        if (slot.fence != 0 && m_funcs)
+            m_funcs->glDeleteSync(slot.fence);
+        slot.fence = 0;
+        delete slot.buffer;
+        slot.buffer = nullptr;
+    }
+    QMutexLocker lock(&m_mutex);
+    m_pending.clear();
+}
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
@@ -0,0 +1,87 @@
+//****************************************************************************
+//**
+//** Author: Daniel Bulla
+//** Contact: qt3d-vr@danielbulla.de
+//**
+//** GNU Lesser General Public License Usage
+//** General Public License version 3 as published by the Free Software
+//** Foundation and appearing in the file LICENSE.LGPL3 included in the
+//** packaging of this file. Please review the following information to
+//** ensure the GNU Lesser General Public License version 3 requirements
+//** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+//**
+//****************************************************************************/
+
+#ifndef QT3DVIRTUALREALITY_TEXTUREUPLOADER_P_H
+#define QT3DVIRTUALREALITY_TEXTUREUPLOADER_P_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QQueue>
+#include <QRect>
+#include <QVector>
+#include <qopengl.h>
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLBuffer;
+class QOpenGLFunctions_3_2_Core;
+
+namespace Qt3DVirtualReality {
+
+/*!
+ * \brief The TextureUploader class streams RGBA8 pixels into existing textures without stalling the frame.
+ * Pixel data is copied into a ring of pixel buffer objects, the mip chain of the texture is rebuilt after each write.
+ * Each slot is guarded by a fence, it is reused only after the gpu has finished the transfer.
+ * At most one write per slot is started each frame.
+ */
+class TextureUploader
+{
+public:
+    explicit TextureUploader(int ringSize = 3);
+    ~TextureUploader();
+
+    /*!
+     * \brief enqueue pixel data for upload. Can be called from any thread.
+     * \param textureId 2d texture with storage for \a rect and mip levels
+     * \param rect texels written in level 0
+     * \param rgbaData tightly packed 8 bit rgba pixels of \a rect
+     */
+    void enqueue(GLuint textureId, const QRect &rect, const QByteArray &rgbaData);
+
+    /*!
+     * \brief processUploads starts pending writes in slots the gpu is done with. Never blocks.
+     * Must be called once per frame on the render thread with the context current.
+     */
+    void processUploads();
+
+    /*!
+     * \brief releaseResources deletes all buffers. Context must be current.
+     */
+    void releaseResources();
+
+private:
+    struct PendingUpload {
+        GLuint textureId;
+        QRect rect;
+        QByteArray data;
+    };
+    struct Slot {
+        Slot() : buffer(nullptr), fence(0) {}
+        QOpenGLBuffer *buffer;
+        GLsync fence;
+    };
+
+    void startUpload(Slot &slot, const PendingUpload &upload);
+
+    QMutex m_mutex;
+    QQueue<PendingUpload> m_pending;
+    QVector<Slot> m_slots;
+    QOpenGLFunctions_3_2_Core *m_funcs;
+};
+
+} // namespace Qt3DVirtualReality
+
+QT_END_NAMESPACE
+
+#endif // QT3DVIRTUALREALITY_TEXTUREUPLOADER_P_H
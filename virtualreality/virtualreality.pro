@@ -36,7 +36,37 @@ SOURCES += \
     qvirtualrealitygeometry.cpp \
     handler.cpp \
     frontend/qtrackedtransform.cpp \
-    trackedtransform.cpp
+    trackedtransform.cpp \
+    meshoptimizer.cpp \
+    textureuploader.cpp \
+    textureatlas.cpp \
+    frontend/qtrackedobjectmaterial.cpp \
+    frontend/qtrackedobjectslayer.cpp \
+    frontend/materialtechnique.cpp \
+    frontend/qstereophongmaterial.cpp \
+    frontend/stereofrustum.cpp \
+    frontend/qhiddenareamask.cpp \
+    hiddenareamesh.cpp \
+    foveation.cpp \
+    frontend/qfoveatedcomposite.cpp \
+    frontend/qtemporalresolve.cpp \
+    frontend/qfarfieldcomposite.cpp \
+    frontend/qstereolevelofdetail.cpp \
+    frontend/updatelevelofdetailjob.cpp \
+    frontend/qocclusionvolume.cpp \
+    frontend/occlusioncullingjob.cpp \
+    frontend/cullingstatisticsjob.cpp \
+    depthreadback.cpp \
+    geometrycache.cpp \
+    eyetexturearray.cpp \
+    swapchainring.cpp \
+    frontend/qcompositorlayer.cpp \
+    frontend/compositorlayertextureimage.cpp \
+    mirrorring.cpp \
+    qmirrorwindow.cpp \
+    captureencoder.cpp \
+    framecapture.cpp \
+    frametiming.cpp
 
 HEADERS += \
     vrbackends/ovr/virtualrealityapiovr.h \
@@ -56,7 +86,46 @@ HEADERS += \
     qvirtualrealitygeometry_p.h \
     handler_p.h \
     frontend/qtrackedtransform.h \
-    trackedtransform_p.h
+    trackedtransform_p.h \
+    meshoptimizer_p.h \
+    textureuploader_p.h \
+    textureatlas_p.h \
+    frontend/qtrackedobjectmaterial.h \
+    frontend/qtrackedobjectslayer.h \
+    frontend/materialtechnique_p.h \
+    frontend/qstereophongmaterial.h \
+    frontend/stereofrustum_p.h \
+    frontend/qhiddenareamask.h \
+    hiddenareamesh_p.h \
+    foveation_p.h \
+    frontend/qfoveatedcomposite.h \
+    frontend/qtemporalresolve.h \
+    frontend/qfarfieldcomposite.h \
+    frontend/qstereolevelofdetail.h \
+    frontend/updatelevelofdetailjob_p.h \
+    frontend/qocclusionvolume.h \
+    frontend/occlusioncullingjob_p.h \
+    frontend/cullingstatisticsjob_p.h \
+    depthreadback_p.h \
+    geometrycache_p.h \
+    frontend/jobtypes_p.h \
+    eyetexturearray_p.h \
+    swapchainring_p.h \
+    frontend/qcompositorlayer.h \
+    frontend/compositorlayertextureimage_p.h \
+    mirrorring_p.h \
+    qmirrorwindow.h \
+    captureencoder_p.h \
+    framecapture_p.h \
+    frametiming_p.h
+
+RESOURCES += \
+    virtualreality.qrc
+
+OTHER_FILES += \
+    shaders/*.vert \
+    shaders/*.geom \
+    shaders/*.frag
 
 ###### OpenVR ######
 if($$WITH_VR_SDK_OPENVR) {
@@ -14,8 +14,12 @@
 
 #if(QT3DVR_COMPILE_WITH_OPENVR)
 #include "virtualrealityapiopenvr.h"
+#include "../../meshoptimizer_p.h"
+#include "../../hiddenareamesh_p.h"
+#include "../../foveation_p.h"
 
 #include <QOpenGLContext>
+#include <QSet>
 #include <QOpenGLFunctions>
 #include <QThread>
 
@@ -53,9 +57,7 @@ QMatrix4x4 VirtualRealityApiOpenVR::getHmdMatrixProjectionEye( vr::Hmd_Eye nEye
 {
     if ( !m_hmd )
         return QMatrix4x4();
-    float nearClip = 0.2f;
-    float farClip = 1000.0f;
-    vr::HmdMatrix44_t mat = m_hmd->GetProjectionMatrix( nEye, nearClip, farClip );
+    vr::HmdMatrix44_t mat = m_hmd->GetProjectionMatrix( nEye, Qt3DVirtualReality::EyeNearClip, Qt3DVirtualReality::EyeFarClip );
 
     return convertSteamVrMatrixToQMatrix4x4(mat);
 //    return QMatrix4x4(
@@ -196,11 +198,11 @@ bool VirtualRealityApiOpenVR::isRuntimeInstalled()
 }
 
 VirtualRealityApiOpenVR::VirtualRealityApiOpenVR()
-    : m_fbo(nullptr)
-    , m_poseNewEnough(false)
+    : m_poseNewEnough(false)
     , m_isTrigger(false)
+    , m_atlasFullWarned(false)
 {
-
+    m_submittedHmdPose.bPoseIsValid = false;
 }
 
 bool VirtualRealityApiOpenVR::isHmdPresent()
@@ -208,6 +210,17 @@ bool VirtualRealityApiOpenVR::isHmdPresent()
     return vr::VR_IsHmdPresent();
 }
 
+Qt3DVirtualReality::QHeadMountedDisplayFormat VirtualRealityApiOpenVR::setFormat(const Qt3DVirtualReality::QHeadMountedDisplayFormat &format)
+{
+    m_format = format;
+    if ( m_format.submitDepth() && m_format.renderTargetLayout() == Qt3DVirtualReality::QHeadMountedDisplayFormat::EyeTextureArray ) {
+        // There is no submit flag for an array texture with depth
+        qWarning() << "Depth can not be submitted with an eye texture array, submitting color only";
+        m_format.setSubmitDepth( false );
+    }
+    return m_format;
+}
+
 void VirtualRealityApiOpenVR::initialize()
 {
     vr::EVRInitError error = vr::VRInitError_None;
@@ -231,21 +244,45 @@ void VirtualRealityApiOpenVR::initialize()
         return;
     }
     setupCameras();
+    // Until QVirtualrealityCamera hands over the projections it draws with
+    m_depthProjection[ vr::Eye_Left ] = m_hmd->GetProjectionMatrix( vr::Eye_Left, Qt3DVirtualReality::EyeNearClip, Qt3DVirtualReality::EyeFarClip );
+    m_depthProjection[ vr::Eye_Right ] = m_hmd->GetProjectionMatrix( vr::Eye_Right, Qt3DVirtualReality::EyeNearClip, Qt3DVirtualReality::EyeFarClip );
 
-    m_fbo = new QOpenGLFramebufferObject(getRenderTargetSize(), QOpenGLFramebufferObject::Depth);
-    m_fbo->addColorAttachment(m_fbo->size(), GL_RGBA8);
+    // The compositor copies the submitted textures, with a ring the gpu does not wait for that copy
+    if ( m_swapChain.create( getRenderTargetSize(), m_format.renderTargetLayout(), m_format.swapChainLength(), m_format.samples(), m_format.reverseDepth() ) )
+        return;
+    if ( m_format.renderTargetLayout() == Qt3DVirtualReality::QHeadMountedDisplayFormat::EyeTextureArray ) {
+        qWarning() << "Falling back to a side by side render target";
+        m_format.setRenderTargetLayout( Qt3DVirtualReality::QHeadMountedDisplayFormat::SideBySide );
+        if ( m_swapChain.create( getRenderTargetSize(), m_format.renderTargetLayout(), m_format.swapChainLength(), m_format.samples(), m_format.reverseDepth() ) )
+            return;
+    }
+    if ( m_format.samples() > 1 ) {
+        qWarning() << "Falling back to a render target without multisampling";
+        m_format.setSamples( 0 );
+        m_swapChain.create( getRenderTargetSize(), m_format.renderTargetLayout(), m_format.swapChainLength(), 0, m_format.reverseDepth() );
+    }
 }
 
 void VirtualRealityApiOpenVR::shutdown()
 {
+    // Overlays belong to the runtime, destroy them before it shuts down
+    for ( CompositorOverlay &overlay : m_overlays )
+        destroyOverlay( overlay );
+    m_overlays.clear();
     if( m_hmd ) {
         vr::VR_Shutdown();
         m_hmd = NULL;
     }
-    if(m_fbo) {
-        delete m_fbo;
-        m_fbo = nullptr;
-    }
+    m_swapChain.destroy();
+    m_textureUploader.releaseResources();
+    QMutexLocker lock(&m_modelsMutex);
+    qDeleteAll(m_models);
+    m_models.clear();
+    m_pendingTextures.clear();
+    m_atlas = Qt3DVirtualReality::TextureAtlas();
+    m_uploadedAtlasRegions.clear();
+    m_atlasFullWarned = false;
 }
 
 
@@ -274,7 +311,7 @@ void VirtualRealityApiOpenVR::processVrEvent( const vr::VREvent_t & event )
 
 bool VirtualRealityApiOpenVR::bindFrambufferObject(int hmdId)
 {
-    return m_fbo->bind();
+    return m_swapChain.bindCurrent();
 }
 
 qreal VirtualRealityApiOpenVR::refreshRate(int hmdId) const
@@ -293,6 +330,8 @@ QSize VirtualRealityApiOpenVR::getRenderTargetSize()
     if ( !m_hmd ) return QSize(0, 0);
     uint32_t width, height;
     m_hmd->GetRecommendedRenderTargetSize( &width, &height );
+    if ( m_format.renderTargetLayout() == Qt3DVirtualReality::QHeadMountedDisplayFormat::EyeTextureArray )
+        return QSize(width, height);
     return QSize(width*2, height);
     //return QSize(width, height);
 }
@@ -304,18 +343,99 @@ int VirtualRealityApiOpenVR::timeUntilNextFrame()
 
 void VirtualRealityApiOpenVR::swapToHeadset()
 {
-    vr::Texture_t leftEyeTexture = {(void*)m_fbo->handle(), vr::TextureType_OpenGL, vr::ColorSpace_Gamma };
-    vr::VRTextureBounds_t leftViewport = {0.0f, 0.0f, 0.5f, 1.0f};
-    vr::VRCompositor()->Submit(vr::Eye_Left, &leftEyeTexture, &leftViewport );
-    vr::Texture_t rightEyeTexture = {(void*)m_fbo->handle(), vr::TextureType_OpenGL, vr::ColorSpace_Gamma };
-    vr::VRTextureBounds_t rightViewport = {0.5f, 0.0f, 1.0f, 1.0f};
-    vr::VRCompositor()->Submit(vr::Eye_Right, &rightEyeTexture, &rightViewport );
+    if ( !m_swapChain.isCreated() )
+        return;
+    m_swapChain.resolveCurrent( m_format.submitDepth() );
+    void *colorTexture = reinterpret_cast<void*>( static_cast<uintptr_t>( m_swapChain.currentColorTexture() ) );
+    if ( m_swapChain.layout() == Qt3DVirtualReality::QHeadMountedDisplayFormat::EyeTextureArray ) {
+        // One layer per eye, the whole layer is the eye
+        vr::VRTextureWithArrayData_t leftEyeTexture;
+        leftEyeTexture.handle = colorTexture;
+        leftEyeTexture.eType = vr::TextureType_OpenGL;
+        leftEyeTexture.eColorSpace = vr::ColorSpace_Gamma;
+        leftEyeTexture.m_unArrayIndex = 0;
+        vr::VRCompositor()->Submit( vr::Eye_Left, &leftEyeTexture, nullptr, vr::Submit_GlArrayTexture );
+        vr::VRTextureWithArrayData_t rightEyeTexture( leftEyeTexture );
+        rightEyeTexture.m_unArrayIndex = 1;
+        vr::VRCompositor()->Submit( vr::Eye_Right, &rightEyeTexture, nullptr, vr::Submit_GlArrayTexture );
+    } else if ( m_format.submitDepth() ) {
+        // Depth lets the compositor reproject positionally, it needs the projection to linearize it
+        vr::VRTextureWithDepth_t leftEyeTexture;
+        leftEyeTexture.handle = colorTexture;
+        leftEyeTexture.eType = vr::TextureType_OpenGL;
+        leftEyeTexture.eColorSpace = vr::ColorSpace_Gamma;
+        leftEyeTexture.depth.handle = reinterpret_cast<void*>( static_cast<uintptr_t>( m_swapChain.currentDepthTexture() ) );
+        leftEyeTexture.depth.mProjection = m_depthProjection[ vr::Eye_Left ];
+        leftEyeTexture.depth.vRange.v[0] = 0.0f;
+        leftEyeTexture.depth.vRange.v[1] = 1.0f;
+        vr::VRTextureBounds_t leftViewport = {0.0f, 0.0f, 0.5f, 1.0f};
+        vr::VRCompositor()->Submit( vr::Eye_Left, &leftEyeTexture, &leftViewport, vr::Submit_TextureWithDepth );
+        vr::VRTextureWithDepth_t rightEyeTexture( leftEyeTexture );
+        rightEyeTexture.depth.mProjection = m_depthProjection[ vr::Eye_Right ];
+        vr::VRTextureBounds_t rightViewport = {0.5f, 0.0f, 1.0f, 1.0f};
+        vr::VRCompositor()->Submit( vr::Eye_Right, &rightEyeTexture, &rightViewport, vr::Submit_TextureWithDepth );
+    } else {
+        vr::Texture_t leftEyeTexture = {colorTexture, vr::TextureType_OpenGL, vr::ColorSpace_Gamma };
+        vr::VRTextureBounds_t leftViewport = {0.0f, 0.0f, 0.5f, 1.0f};
+        vr::VRCompositor()->Submit(vr::Eye_Left, &leftEyeTexture, &leftViewport );
+        vr::Texture_t rightEyeTexture = {colorTexture, vr::TextureType_OpenGL, vr::ColorSpace_Gamma };
+        vr::VRTextureBounds_t rightViewport = {0.5f, 0.0f, 1.0f, 1.0f};
+        vr::VRCompositor()->Submit(vr::Eye_Right, &rightEyeTexture, &rightViewport );
+    }
+    m_submittedHmdPose = m_trackedDevicePose[vr::k_unTrackedDeviceIndex_Hmd];
+    m_swapChain.advance();
     m_poseNewEnough = false;
+
+    // The frame is submitted, use the remaining time to load and stream textures of new devices.
+    loadPendingTextures();
+    m_textureUploader.processUploads();
 //    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
 //    f->glFlush();
 //    f->glFinish();
 }
 
+bool VirtualRealityApiOpenVR::resubmitFrame()
+{
+    // Array textures can not be submitted with a pose
+    if ( !m_swapChain.isCreated() || !m_submittedHmdPose.bPoseIsValid
+         || m_swapChain.layout() == Qt3DVirtualReality::QHeadMountedDisplayFormat::EyeTextureArray )
+        return false;
+    // Paces like a rendered frame
+    updateHmdMatrixPose();
+    void *colorTexture = reinterpret_cast<void*>( static_cast<uintptr_t>( m_swapChain.submittedColorTexture() ) );
+    vr::VRTextureBounds_t leftViewport = {0.0f, 0.0f, 0.5f, 1.0f};
+    vr::VRTextureBounds_t rightViewport = {0.5f, 0.0f, 1.0f, 1.0f};
+    if ( m_format.submitDepth() ) {
+        vr::VRTextureWithPoseAndDepth_t leftEyeTexture;
+        leftEyeTexture.handle = colorTexture;
+        leftEyeTexture.eType = vr::TextureType_OpenGL;
+        leftEyeTexture.eColorSpace = vr::ColorSpace_Gamma;
+        leftEyeTexture.mDeviceToAbsoluteTracking = m_submittedHmdPose.mDeviceToAbsoluteTracking;
+        leftEyeTexture.depth.handle = reinterpret_cast<void*>( static_cast<uintptr_t>( m_swapChain.submittedDepthTexture() ) );
+        leftEyeTexture.depth.mProjection = m_depthProjection[ vr::Eye_Left ];
+        leftEyeTexture.depth.vRange.v[0] = 0.0f;
+        leftEyeTexture.depth.vRange.v[1] = 1.0f;
+        const vr::EVRSubmitFlags flags = vr::EVRSubmitFlags( vr::Submit_TextureWithPose | vr::Submit_TextureWithDepth );
+        vr::VRCompositor()->Submit( vr::Eye_Left, &leftEyeTexture, &leftViewport, flags );
+        vr::VRTextureWithPoseAndDepth_t rightEyeTexture( leftEyeTexture );
+        rightEyeTexture.depth.mProjection = m_depthProjection[ vr::Eye_Right ];
+        vr::VRCompositor()->Submit( vr::Eye_Right, &rightEyeTexture, &rightViewport, flags );
+    } else {
+        vr::VRTextureWithPose_t eyeTexture;
+        eyeTexture.handle = colorTexture;
+        eyeTexture.eType = vr::TextureType_OpenGL;
+        eyeTexture.eColorSpace = vr::ColorSpace_Gamma;
+        eyeTexture.mDeviceToAbsoluteTracking = m_submittedHmdPose.mDeviceToAbsoluteTracking;
+        vr::VRCompositor()->Submit( vr::Eye_Left, &eyeTexture, &leftViewport, vr::Submit_TextureWithPose );
+        vr::VRCompositor()->Submit( vr::Eye_Right, &eyeTexture, &rightViewport, vr::Submit_TextureWithPose );
+    }
+    m_poseNewEnough = false;
+
+    loadPendingTextures();
+    m_textureUploader.processUploads();
+    return true;
+}
+
 void VirtualRealityApiOpenVR::getEyeMatrices(QMatrix4x4 &leftEye, QMatrix4x4 &rightEye)
 {
     updateHmdMatrixPose();
@@ -323,10 +443,66 @@ void VirtualRealityApiOpenVR::getEyeMatrices(QMatrix4x4 &leftEye, QMatrix4x4 &ri
     rightEye = getCurrentViewMatrix(vr::Eye_Right);
 }
 
-void VirtualRealityApiOpenVR::getProjectionMatrices(QMatrix4x4 &leftProjection, QMatrix4x4 &rightProjection)
+void VirtualRealityApiOpenVR::getProjectionTangents(ProjectionTangents &leftEye, ProjectionTangents &rightEye)
+{
+    if ( !m_hmd )
+        return;
+    // OpenVR names top and bottom with y pointing down, top is the lower edge in OpenGL
+    ProjectionTangents *tangents[ 2 ] = { &leftEye, &rightEye };
+    for ( int eye = 0; eye < 2; ++eye ) {
+        float left, right, top, bottom;
+        m_hmd->GetProjectionRaw( vr::Hmd_Eye( eye ), &left, &right, &top, &bottom );
+        tangents[ eye ]->left = left;
+        tangents[ eye ]->right = right;
+        tangents[ eye ]->bottom = top;
+        tangents[ eye ]->top = bottom;
+    }
+}
+
+void VirtualRealityApiOpenVR::setDepthProjections(const QMatrix4x4 &leftProjection, const QMatrix4x4 &rightProjection, bool reverseDepth)
+{
+    // The projection maps to the depth buffer as drawn, reversed or not
+    Q_UNUSED( reverseDepth );
+    const QMatrix4x4 projections[ 2 ] = { leftProjection, rightProjection };
+    for ( int eye = 0; eye < 2; ++eye ) {
+        for ( int row = 0; row < 4; ++row ) {
+            for ( int column = 0; column < 4; ++column )
+                m_depthProjection[ eye ].m[ row ][ column ] = projections[ eye ]( row, column );
+        }
+    }
+}
+
+void VirtualRealityApiOpenVR::getHiddenAreaMeshes(QVector<QVector2D> &left, QVector<QVector2D> &right)
 {
-    leftProjection = getHmdMatrixProjectionEye( vr::Eye_Left );
-    rightProjection = getHmdMatrixProjectionEye( vr::Eye_Right );
+    left = getHiddenAreaMesh(vr::Eye_Left);
+    right = getHiddenAreaMesh(vr::Eye_Right);
+}
+
+QVirtualRealityApiBackend::FoveationProfile VirtualRealityApiOpenVR::foveationProfile()
+{
+    // Fresnel lenses of Vive/Index class headsets are sharp in about the inner half of the field of view
+    return Qt3DVirtualReality::Foveation::lensProfile( getHmdMatrixProjectionEye( vr::Eye_Left ),
+                                                       getHmdMatrixProjectionEye( vr::Eye_Right ),
+                                                       0.5f, 0.5f );
+}
+
+QVector<QVector2D> VirtualRealityApiOpenVR::getHiddenAreaMesh(vr::Hmd_Eye nEye)
+{
+    if ( !m_hmd )
+        return QVector<QVector2D>();
+    vr::HiddenAreaMesh_t mesh = m_hmd->GetHiddenAreaMesh( nEye );
+    if ( mesh.unTriangleCount == 0 || !mesh.pVertexData ) {
+        // Not every driver provides one
+        return Qt3DVirtualReality::HiddenAreaMesh::synthesize( getHmdMatrixProjectionEye( nEye ) );
+    }
+    QVector<QVector2D> triangles;
+    triangles.reserve( mesh.unTriangleCount * 3 );
+    for ( uint32_t i = 0; i < mesh.unTriangleCount * 3; ++i ) {
+        // OpenVR has (0, 0) top left
+        const vr::HmdVector2_t &vertex = mesh.pVertexData[i];
+        triangles.append( QVector2D( vertex.v[0], 1.0f - vertex.v[1] ) );
+    }
+    return triangles;
 }
 
 QList<int> VirtualRealityApiOpenVR::currentlyTrackedObjects()
@@ -361,31 +537,32 @@ bool VirtualRealityApiOpenVR::isTriggerTmp()
     return m_isTrigger;
 }
 
-void VirtualRealityApiOpenVR::getTrackedObjectModel(int id, QVector<float> &vertices, QVector<int> &indices, QOpenGLTexture *texture)
+void VirtualRealityApiOpenVR::getTrackedObjectModel(int id, QVector<float> &vertices, QVector<int> &indices)
 {
     if( id >= vr::k_unMaxTrackedDeviceCount) {
         qWarning("Requested tracked object vertices: Index out of bounds.");
         return;
     }
 
-    if (m_models.contains(id)){
-        vertices = m_models[id]->vertices;
-        indices = m_models[id]->indices;
-        texture = m_models[id]->texture;
-        return;
+    {
+        QMutexLocker lock(&m_modelsMutex);
+        if (m_models.contains(id)){
+            vertices = m_models[id]->vertices;
+            indices = m_models[id]->indices;
+            return;
+        }
     }
 
+    // Polled without the lock, the render thread keeps loading textures meanwhile
     std::string sRenderModelName = getTrackedDeviceString( m_hmd, id, vr::Prop_RenderModelName_String );
 
-    //TODO: load renderModels only once
-
     vr::RenderModel_t *pModel;
     vr::EVRRenderModelError error;
     while ( 1 ) {
         error = vr::VRRenderModels()->LoadRenderModel_Async( sRenderModelName.c_str(), &pModel );
         if ( error != vr::VRRenderModelError_Loading )
             break;
-        QThread::currentThread()->sleep( 1 );
+        QThread::currentThread()->msleep( 1 );
     }
 
     if ( error != vr::VRRenderModelError_None ) {
@@ -393,42 +570,224 @@ void VirtualRealityApiOpenVR::getTrackedObjectModel(int id, QVector<float> &vert
         return;
     }
 
-    vr::RenderModel_TextureMap_t *pTexture;
-    while ( 1 ) {
-        error = vr::VRRenderModels()->LoadTexture_Async( pModel->diffuseTextureId, &pTexture );
-        if ( error != vr::VRRenderModelError_Loading )
-            break;
-        QThread::currentThread()->sleep( 1 );
-    }
-
-    if ( error != vr::VRRenderModelError_None ) {
-        qWarning( "Unable to load render texture id:%d for render model %s\n", pModel->diffuseTextureId, sRenderModelName.c_str() );
-        vr::VRRenderModels()->FreeRenderModel( pModel );
-        return;
-    }
-
     //Position, Normal, Texture
     vertices.resize(pModel->unVertexCount * (3 + 3 + 2));
     memcpy(vertices.data(), pModel->rVertexData, sizeof(float) * vertices.size());
     indices.resize(pModel->unTriangleCount * 3);
-    for(int i=0; i<pModel->unTriangleCount; i++) {
-        indices[i*3  ] = pModel->rIndexData[i*3  ];
-        indices[i*3+1] = pModel->rIndexData[i*3+1];
-        indices[i*3+2] = pModel->rIndexData[i*3+2];
+    for(int i=0; i<indices.size(); i++) {
+        indices[i] = pModel->rIndexData[i];
     }
+    // Done once per model, the optimized result is what gets cached
+    Qt3DVirtualReality::MeshOptimizer::optimizeVertexCache(indices, pModel->unVertexCount);
+    Qt3DVirtualReality::MeshOptimizer::optimizeVertexFetch(vertices, indices, 3 + 3 + 2);
 
-    //texture = new QOpenGLTexture(QOpenGLTexture::BindingTarget2D);
-    texture->setSize(pTexture->unWidth, pTexture->unHeight);
-    texture->setData( QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, pTexture->rubTextureMapData );
+    const vr::TextureID_t diffuseTextureId = pModel->diffuseTextureId;
+    vr::VRRenderModels()->FreeRenderModel( pModel );
 
-    m_models.insert(id,new TrackedObjectModel(vertices, indices, texture));
+    QMutexLocker lock(&m_modelsMutex);
+    if (m_models.contains(id)){
+        // Another job loaded it meanwhile
+        vertices = m_models[id]->vertices;
+        indices = m_models[id]->indices;
+        return;
+    }
+    TrackedObjectModel *model = new TrackedObjectModel(vertices, indices, diffuseTextureId);
+
+    // The texture is not waited for. It is loaded in the background, see loadPendingTextures().
+    // Devices of the same kind share the texture.
+    if ( m_atlas.contains(diffuseTextureId) ) {
+        m_atlas.remapTexCoords(model->textureId, model->vertices, 3 + 3 + 2, 3 + 3);
+        model->inAtlas = true;
+        vertices = model->vertices;
+    } else if ( diffuseTextureId < 0 ) {
+        // Without a texture the atlas would be sampled at arbitrary places
+        model->inAtlas = m_atlas.remapToFallback(model->vertices, 3 + 3 + 2, 3 + 3);
+        vertices = model->vertices;
+    } else if ( !m_pendingTextures.contains(diffuseTextureId) ) {
+        m_pendingTextures.append(diffuseTextureId);
+    }
 
-    vr::VRRenderModels()->FreeRenderModel( pModel );
-    vr::VRRenderModels()->FreeTexture( pTexture );
+    m_models.insert(id, model);
+}
+
+int VirtualRealityApiOpenVR::getTrackedObjectModelRevision(int id)
+{
+    QMutexLocker lock(&m_modelsMutex);
+    TrackedObjectModel *model = m_models.value(id, nullptr);
+    return model ? model->revision : -1;
+}
+
+QSize VirtualRealityApiOpenVR::getTrackedObjectTextureSize()
+{
+    return m_atlas.size();
+}
+
+void VirtualRealityApiOpenVR::uploadTrackedObjectTexture(QOpenGLTexture *texture)
+{
+    QMutexLocker lock(&m_modelsMutex);
+    if ( m_atlas.isEmpty() )
+        return;
+    // Every texture Qt3D allocated for the atlas gets its own copy. Only the parts inserted since are written.
+    UploadedAtlasRegions &uploaded = m_uploadedAtlasRegions[ texture ];
+    // Qt3D recreated the texture, GL may hand out the same id again. A new texture starts empty.
+    if ( uploaded.textureId != texture->textureId() ) {
+        uploaded.textureId = texture->textureId();
+        uploaded.count = 0;
+    }
+    for ( ; uploaded.count < m_atlas.regionCount(); ++uploaded.count ) {
+        const QRect region = m_atlas.region( uploaded.count );
+        m_textureUploader.enqueue( texture->textureId(), region, m_atlas.regionData( region ) );
+    }
+}
+
+void VirtualRealityApiOpenVR::loadPendingTextures()
+{
+    QMutexLocker lock(&m_modelsMutex);
+    for ( QList<vr::TextureID_t>::iterator iter(m_pendingTextures.begin()); iter != m_pendingTextures.end(); ) {
+        // Only poll, the sdk loads in the background
+        vr::RenderModel_TextureMap_t *pTexture;
+        vr::EVRRenderModelError error = vr::VRRenderModels()->LoadTexture_Async( *iter, &pTexture );
+        if ( error == vr::VRRenderModelError_Loading ) {
+            ++iter;
+            continue;
+        }
+        bool inserted = false;
+        if ( error != vr::VRRenderModelError_None ) {
+            qWarning( "Unable to load render texture id:%d\n", *iter );
+        } else {
+            QByteArray data(reinterpret_cast<const char*>(pTexture->rubTextureMapData), pTexture->unWidth * pTexture->unHeight * 4);
+            inserted = m_atlas.insert(*iter, QSize(pTexture->unWidth, pTexture->unHeight), data);
+            if ( !inserted && !m_atlasFullWarned ) {
+                qWarning( "Render model textures do not fit into the texture atlas, their models are drawn gray\n" );
+                m_atlasFullWarned = true;
+            }
+            vr::VRRenderModels()->FreeTexture( pTexture );
+        }
+        // Remap texture coordinates of all models waiting for this texture, to the fallback texel if it is missing
+        for ( QMap<int, TrackedObjectModel*>::iterator model(m_models.begin()); model != m_models.end(); ++model ) {
+            if ( (*model)->textureId != *iter || (*model)->inAtlas )
+                continue;
+            if ( inserted )
+                m_atlas.remapTexCoords(*iter, (*model)->vertices, 3 + 3 + 2, 3 + 3);
+            else if ( !m_atlas.remapToFallback((*model)->vertices, 3 + 3 + 2, 3 + 3) )
+                continue;
+            (*model)->inAtlas = true;
+            ++(*model)->revision;
+        }
+        iter = m_pendingTextures.erase(iter);
+    }
 }
 
-void VirtualRealityApiOpenVR::getMirrorTexture(QOpenGLTexture *outMirrorTexture)
+bool VirtualRealityApiOpenVR::getMirrorTexture( int eye, MirrorTexture &mirrorTexture )
+{
+    if ( !m_swapChain.isCreated() )
+        return false;
+    // The image submitted last. The compositor only reads it, reading it as well never waits.
+    const QSize size = getRenderTargetSize();
+    mirrorTexture.textureId = m_swapChain.submittedColorTexture();
+    mirrorTexture.size = size;
+    if ( m_swapChain.layout() == Qt3DVirtualReality::QHeadMountedDisplayFormat::EyeTextureArray ) {
+        mirrorTexture.layer = eye;
+        mirrorTexture.eyeRect = QRect( QPoint( 0, 0 ), size );
+    } else {
+        const int halfWidth = size.width() / 2;
+        mirrorTexture.layer = -1;
+        mirrorTexture.eyeRect = QRect( eye * halfWidth, 0, halfWidth, size.height() );
+    }
+    return true;
+}
+bool VirtualRealityApiOpenVR::supportsCompositorLayers()
 {
+    return vr::VROverlay() != nullptr;
+}
 
+void VirtualRealityApiOpenVR::setCompositorLayers( const QVector<CompositorLayer> &layers )
+{
+    vr::IVROverlay *overlays = vr::VROverlay();
+    if ( !overlays )
+        return;
+    QSet<int> listed;
+    uint32_t sortOrder = 0;
+    for ( const CompositorLayer &layer : layers ) {
+        listed.insert( layer.id );
+        CompositorOverlay &overlay = m_overlays[ layer.id ];
+        if ( overlay.handle == vr::k_ulOverlayHandleInvalid ) {
+            const QByteArray key = QByteArrayLiteral( "qt3dvr.layer." ) + QByteArray::number( layer.id );
+            const vr::VROverlayError error = overlays->CreateOverlay( key.constData(), key.constData(), &overlay.handle );
+            if ( error != vr::VROverlayError_None ) {
+                qWarning() << "Could not create overlay for compositor layer" << layer.id << overlays->GetOverlayErrorNameFromEnum( error );
+                m_overlays.remove( layer.id );
+                continue;
+            }
+            overlays->ShowOverlay( overlay.handle );
+        }
+        if ( overlay.sortOrder != sortOrder ) {
+            overlays->SetOverlaySortOrder( overlay.handle, sortOrder );
+            overlay.sortOrder = sortOrder;
+        }
+        ++sortOrder;
+
+        if ( overlay.revision != layer.revision ) {
+            const QSize imageSize = layer.image.size();
+            if ( !overlay.texture || overlay.texture->width() != imageSize.width() || overlay.texture->height() != imageSize.height() ) {
+                delete overlay.texture;
+                overlay.texture = new QOpenGLTexture( QOpenGLTexture::Target2D );
+                overlay.texture->setFormat( QOpenGLTexture::RGBA8_UNorm );
+                overlay.texture->setSize( imageSize.width(), imageSize.height() );
+                overlay.texture->setMinMagFilters( QOpenGLTexture::Linear, QOpenGLTexture::Linear );
+                overlay.texture->setWrapMode( QOpenGLTexture::ClampToEdge );
+                overlay.texture->allocateStorage( QOpenGLTexture::RGBA, QOpenGLTexture::UInt8 );
+            }
+            // Top row first, like the compositor expects it
+            overlay.texture->setData( QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, layer.image.constBits() );
+            vr::Texture_t texture = { reinterpret_cast<void*>( static_cast<uintptr_t>( overlay.texture->textureId() ) ),
+                                      vr::TextureType_OpenGL, vr::ColorSpace_Auto };
+            overlays->SetOverlayTexture( overlay.handle, &texture );
+            overlay.revision = layer.revision;
+        }
+
+        if ( overlay.position != layer.position || overlay.orientation != layer.orientation
+             || overlay.size != layer.size || !qFuzzyCompare( overlay.radius, layer.radius ) ) {
+            // The height follows from the aspect of the image
+            overlays->SetOverlayWidthInMeters( overlay.handle, layer.size.width() );
+            // Curvature is the fraction of a full cylinder, bent towards +z
+            const float curvature = layer.radius > 0.0f ? qMin( 1.0f, float( layer.size.width() / ( 2.0 * M_PI * layer.radius ) ) ) : 0.0f;
+            overlays->SetOverlayCurvature( overlay.handle, curvature );
+            // Overlays are placed at the center of their surface, a cylinder is placed at its axis
+            QMatrix4x4 transform;
+            transform.translate( layer.position );
+            transform.rotate( layer.orientation );
+            if ( layer.radius > 0.0f )
+                transform.translate( 0.0f, 0.0f, -layer.radius );
+            vr::HmdMatrix34_t pose;
+            for ( int row = 0; row < 3; ++row ) {
+                for ( int column = 0; column < 4; ++column )
+                    pose.m[ row ][ column ] = transform( row, column );
+            }
+            overlays->SetOverlayTransformAbsolute( overlay.handle, vr::TrackingUniverseStanding, &pose );
+            overlay.position = layer.position;
+            overlay.orientation = layer.orientation;
+            overlay.size = layer.size;
+            overlay.radius = layer.radius;
+        }
+    }
+
+    for ( auto iter = m_overlays.begin(); iter != m_overlays.end(); ) {
+        if ( listed.contains( iter.key() ) ) {
+            ++iter;
+            continue;
+        }
+        destroyOverlay( iter.value() );
+        iter = m_overlays.erase( iter );
+    }
+}
+
+void VirtualRealityApiOpenVR::destroyOverlay( CompositorOverlay &overlay )
+{
+    if ( overlay.handle != vr::k_ulOverlayHandleInvalid && vr::VROverlay() )
+        vr::VROverlay()->DestroyOverlay( overlay.handle );
+    overlay.handle = vr::k_ulOverlayHandleInvalid;
+    delete overlay.texture;
+    overlay.texture = nullptr;
 }
 #endif
@@ -17,16 +17,38 @@
 #define VIRTUALREALITYAPIOPENVR_H
 
 #include "../../qvirtualrealityapibackend.h"
+#include "../../textureuploader_p.h"
+#include "../../textureatlas_p.h"
+#include "../../swapchainring_p.h"
 #include "openvr.h"
+#include <QMutex>
+#include <QHash>
 class QSurfaceFormat;
 
 struct TrackedObjectModel {
-    TrackedObjectModel(QVector<float> t_vertices, QVector<int> t_indices, QOpenGLTexture* t_texture) :
-        vertices(t_vertices), indices(t_indices), texture(t_texture) {}
+    TrackedObjectModel(QVector<float> t_vertices, QVector<int> t_indices, vr::TextureID_t t_textureId) :
+        vertices(t_vertices), indices(t_indices), textureId(t_textureId), inAtlas(false), revision(0) {}
 
     QVector<float> vertices;
     QVector<int> indices;
-    QOpenGLTexture* texture;
+    vr::TextureID_t textureId; // Key of the texture in m_atlas
+    bool inAtlas; // Texture coordinates have been remapped into m_atlas
+    int revision;
+};
+
+// Overlay of a compositor layer, its texture is only uploaded when the layer revision changed
+struct CompositorOverlay {
+    CompositorOverlay() : handle(vr::k_ulOverlayHandleInvalid), texture(nullptr), revision(-1), sortOrder(0), radius(-1.0f) {}
+
+    vr::VROverlayHandle_t handle;
+    QOpenGLTexture *texture;
+    int revision;
+    uint32_t sortOrder;
+    // Placement last handed to the overlay
+    QVector3D position;
+    QQuaternion orientation;
+    QSizeF size;
+    float radius;
 };
 
 class VirtualRealityApiOpenVR : public Qt3DVirtualReality::QVirtualRealityApiBackend
@@ -36,6 +58,7 @@ public:
     VirtualRealityApiOpenVR();
     bool isHmdPresent();
 
+    Qt3DVirtualReality::QHeadMountedDisplayFormat setFormat(const Qt3DVirtualReality::QHeadMountedDisplayFormat &format);
     void initialize();
     void shutdown();
     bool bindFrambufferObject(int hmdId);
@@ -47,21 +70,32 @@ public:
     int timeUntilNextFrame();
 
     void swapToHeadset();
+    bool resubmitFrame();
 
     void getEyeMatrices(QMatrix4x4 &leftEye, QMatrix4x4 &rightEye);
 
-    void getProjectionMatrices(QMatrix4x4 &leftProjection, QMatrix4x4 &rightProjection);
+    void getProjectionTangents(ProjectionTangents &leftEye, ProjectionTangents &rightEye);
+    void setDepthProjections(const QMatrix4x4 &leftProjection, const QMatrix4x4 &rightProjection, bool reverseDepth);
+    void getHiddenAreaMeshes(QVector<QVector2D> &left, QVector<QVector2D> &right);
+    FoveationProfile foveationProfile();
 
     QList<int> currentlyTrackedObjects();
     void getTrackedObject(int id, QMatrix4x4 &transform);
     TrackedObjectType getTrackedObjectType(int id);
-    void getTrackedObjectModel(int id, QVector<float> &vertices, QVector<int> &indices, QOpenGLTexture *texture);
+    void getTrackedObjectModel(int id, QVector<float> &vertices, QVector<int> &indices);
+    int getTrackedObjectModelRevision(int id);
+    QSize getTrackedObjectTextureSize();
+    void uploadTrackedObjectTexture(QOpenGLTexture *texture);
 
-    void getMirrorTexture(QOpenGLTexture *outMirrorTexture);
+    bool getMirrorTexture(int eye, MirrorTexture &mirrorTexture);
+
+    bool supportsCompositorLayers();
+    void setCompositorLayers(const QVector<CompositorLayer> &layers);
 
     bool isTriggerTmp();
 private:
-    QOpenGLFramebufferObject *m_fbo;
+    Qt3DVirtualReality::QHeadMountedDisplayFormat m_format;
+    Qt3DVirtualReality::SwapChainRing m_swapChain;
     double m_sensorSampleTime;
     long long m_frameIndex;
     vr::IVRSystem *m_hmd;
@@ -86,6 +120,7 @@ private:
 
     QMatrix4x4 getHmdMatrixProjectionEye(vr::Hmd_Eye nEye);
     QMatrix4x4 getHmdMatrixPoseEye(vr::Hmd_Eye nEye);
+    QVector<QVector2D> getHiddenAreaMesh(vr::Hmd_Eye nEye);
     QMatrix4x4 getCurrentViewMatrix(vr::Hmd_Eye nEye);
     void updateHmdMatrixPose();
     QMatrix4x4 convertSteamVrMatrixToQMatrix4x4(const vr::HmdMatrix34_t matPose);
@@ -93,8 +128,27 @@ private:
     void processVrEvent(const vr::VREvent_t &event);
     void setupCameras();
     bool m_poseNewEnough; //TO DO: openvr in example only updates poses once a frame
+    vr::TrackedDevicePose_t m_submittedHmdPose; // Of the last swapToHeadset, for resubmitFrame
+    vr::HmdMatrix44_t m_depthProjection[ 2 ]; // Of the eyes, submitted with depth
+
+    void loadPendingTextures();
 
     QMap<int, TrackedObjectModel*> m_models;
+    QMutex m_modelsMutex; // Models are requested by Qt3D jobs, textures are polled on the render thread
+    QList<vr::TextureID_t> m_pendingTextures;
+    Qt3DVirtualReality::TextureAtlas m_atlas; // All render model textures, so all tracked objects share material state
+    Qt3DVirtualReality::TextureUploader m_textureUploader; // Streams m_atlas into the textures of Qt3D
+    // Count of regions uploaded into a texture of Qt3D, together with the GL texture it was counted for
+    struct UploadedAtlasRegions {
+        UploadedAtlasRegions() : textureId(0), count(0) {}
+        GLuint textureId;
+        int count;
+    };
+    QHash<QOpenGLTexture*, UploadedAtlasRegions> m_uploadedAtlasRegions;
+    bool m_atlasFullWarned; // Models whose texture did not fit are drawn with the fallback texel of m_atlas
+
+    QHash<int, CompositorOverlay> m_overlays; // Keyed by layer id
+    void destroyOverlay(CompositorOverlay &overlay);
 };
 
 #endif
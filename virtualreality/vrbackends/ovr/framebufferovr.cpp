@@ -25,7 +25,7 @@ class FramebufferOvr
     GLuint m_framebuffer;
     QOpenGLFunctions_3_2_Core *m_funcs;
 public:
-    FramebufferOvr(GLuint colorAttachment0TextureId, GLuint depthBufferRenderbufferId, QOpenGLFunctions_3_2_Core *funcs)
+    FramebufferOvr(GLuint colorAttachment0TextureId, GLuint depthBufferRenderbufferId, QOpenGLFunctions_3_2_Core *funcs, bool depthIsTexture = false)
         : m_colorAttachment(colorAttachment0TextureId)
         , m_depthBuffer(depthBufferRenderbufferId)
         , m_funcs(funcs)
@@ -39,14 +39,16 @@ public:
         m_funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         m_funcs->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-        if(depthBufferRenderbufferId > 0) {
+        if(depthBufferRenderbufferId > 0 && depthIsTexture) {
+            // Texture of the depth chain
+            funcs->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                                          GL_TEXTURE_2D, m_depthBuffer, 0);
+        } else if(depthBufferRenderbufferId > 0) {
             Q_ASSERT(funcs->glIsRenderbuffer(m_depthBuffer));
             funcs->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
                                          GL_RENDERBUFFER, m_depthBuffer);
         }
-        int sampleCount = 1;
-        GLenum texTarget = (sampleCount > 1) ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
-        m_funcs->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texTarget, m_colorAttachment, 0);
+        m_funcs->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorAttachment, 0);
 
         m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
@@ -60,19 +62,28 @@ public:
     void bind() {
         m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
     }
+    GLuint framebufferId() {
+        return m_framebuffer;
+    }
 };
 
-OvrSwapChain::OvrSwapChain( ovrSession session, QSize size)
+OvrSwapChain::OvrSwapChain( ovrSession session, QSize size, int samples, bool depthChain, bool floatDepth)
     :m_session(session),
      m_texSize(size),
-     m_textureChain(0)
+     m_textureChain(0),
+     m_depthTextureChain(0),
+     m_samples(samples > 1 ? samples : 0),
+     m_multisampleFramebuffer(0)
 {
+    m_multisampleRenderbuffers[0] = m_multisampleRenderbuffers[1] = 0;
     m_funcs = QOpenGLContext::currentContext()->versionFunctions<QOpenGLFunctions_3_2_Core>();
     if(!m_funcs)
     {
         qDebug() << "Could not get OpenGLFunctions 3.2";
         return;
     }
+    // Float depth for reversed depth, see QHeadMountedDisplayFormat::setReverseDepth
+    const GLenum depthFormat = floatDepth ? GL_DEPTH32F_STENCIL8 : GL_DEPTH24_STENCIL8;
     ovrTextureSwapChainDesc desc = {};
     desc.Type = ovrTexture_2D;
     desc.ArraySize = 1;
@@ -96,19 +107,67 @@ OvrSwapChain::OvrSwapChain( ovrSession session, QSize size)
     int length = 0;
     ovr_GetTextureSwapChainLength(m_session, m_textureChain, &length);
 
+    if(OVR_SUCCESS(result) && depthChain)
+    {
+        // The compositor reads depth from its own chain, rendered to like the color chain
+        desc.Format = floatDepth ? OVR_FORMAT_D32_FLOAT_S8X24_UINT : OVR_FORMAT_D24_UNORM_S8_UINT;
+        ovrResult depthResult = ovr_CreateTextureSwapChainGL(m_session, &desc, &m_depthTextureChain);
+        int depthLength = 0;
+        if(OVR_SUCCESS(depthResult))
+            ovr_GetTextureSwapChainLength(m_session, m_depthTextureChain, &depthLength);
+        if(depthLength != length)
+        {
+            qDebug() << "Could not create depth texture swap chain, submitting color only";
+            if(m_depthTextureChain)
+                ovr_DestroyTextureSwapChain(m_session, m_depthTextureChain);
+            m_depthTextureChain = nullptr;
+        }
+    }
+
     if(OVR_SUCCESS(result))
     {
-        GLuint depthBufferId;
-        m_funcs->glGenRenderbuffers(1, &depthBufferId);
-        m_funcs->glBindRenderbuffer(GL_RENDERBUFFER, depthBufferId);
-        Q_ASSERT(m_funcs->glIsRenderbuffer(depthBufferId));
-        m_funcs->glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_texSize.width(), m_texSize.height());
+        GLuint depthBufferId = 0;
+        if(!m_depthTextureChain)
+        {
+            m_funcs->glGenRenderbuffers(1, &depthBufferId);
+            m_funcs->glBindRenderbuffer(GL_RENDERBUFFER, depthBufferId);
+            Q_ASSERT(m_funcs->glIsRenderbuffer(depthBufferId));
+            m_funcs->glRenderbufferStorage(GL_RENDERBUFFER, depthFormat, m_texSize.width(), m_texSize.height());
+        }
 
         for (int i = 0; i < length; ++i)
         {
             GLuint chainTextureId;
             ovr_GetTextureSwapChainBufferGL(m_session, m_textureChain, i, &chainTextureId);
-            m_framebuffers.push_back(new FramebufferOvr(chainTextureId, depthBufferId, m_funcs));
+            if(m_depthTextureChain)
+                ovr_GetTextureSwapChainBufferGL(m_session, m_depthTextureChain, i, &depthBufferId);
+            m_framebuffers.push_back(new FramebufferOvr(chainTextureId, depthBufferId, m_funcs, m_depthTextureChain != nullptr));
+        }
+    }
+
+    // The sdk chain is single sampled. Render into multisampled renderbuffers and resolve on commit.
+    if(OVR_SUCCESS(result) && m_samples > 1)
+    {
+        m_funcs->glGenRenderbuffers(2, m_multisampleRenderbuffers);
+        m_funcs->glBindRenderbuffer(GL_RENDERBUFFER, m_multisampleRenderbuffers[0]);
+        m_funcs->glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_samples, GL_SRGB8_ALPHA8, m_texSize.width(), m_texSize.height());
+        m_funcs->glBindRenderbuffer(GL_RENDERBUFFER, m_multisampleRenderbuffers[1]);
+        m_funcs->glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_samples, depthFormat, m_texSize.width(), m_texSize.height());
+        m_funcs->glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        m_funcs->glGenFramebuffers(1, &m_multisampleFramebuffer);
+        m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, m_multisampleFramebuffer);
+        m_funcs->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_multisampleRenderbuffers[0]);
+        m_funcs->glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_multisampleRenderbuffers[1]);
+        const GLenum status = m_funcs->glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if(status != GL_FRAMEBUFFER_COMPLETE)
+        {
+            qDebug() << "Multisampled framebuffer incomplete, rendering without multisampling. Status:" << status;
+            m_funcs->glDeleteFramebuffers(1, &m_multisampleFramebuffer);
+            m_funcs->glDeleteRenderbuffers(2, m_multisampleRenderbuffers);
+            m_multisampleFramebuffer = 0;
+            m_samples = 0;
         }
     }
 
@@ -127,9 +186,19 @@ OvrSwapChain::~OvrSwapChain()
         ovr_DestroyTextureSwapChain(m_session, m_textureChain);
         m_textureChain = nullptr;
     }
+    if (m_depthTextureChain)
+    {
+        ovr_DestroyTextureSwapChain(m_session, m_depthTextureChain);
+        m_depthTextureChain = nullptr;
+    }
     for(QVector<FramebufferOvr *>::iterator iter(m_framebuffers.begin()) ; iter != m_framebuffers.end() ; ++iter) {
         delete *iter;
     }
+    if (m_multisampleFramebuffer)
+    {
+        m_funcs->glDeleteFramebuffers(1, &m_multisampleFramebuffer);
+        m_funcs->glDeleteRenderbuffers(2, m_multisampleRenderbuffers);
+    }
 }
 
 QSize OvrSwapChain::size() const
@@ -140,7 +209,22 @@ QSize OvrSwapChain::size() const
 void OvrSwapChain::commit()
 {
     Q_ASSERT(m_textureChain != nullptr);
+    if (m_multisampleFramebuffer)
+    {
+        int curIndex;
+        ovr_GetTextureSwapChainCurrentIndex(m_session, m_textureChain, &curIndex);
+        m_funcs->glBindFramebuffer(GL_READ_FRAMEBUFFER, m_multisampleFramebuffer);
+        m_funcs->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffers[curIndex]->framebufferId());
+        // Depth can only be resolved with nearest
+        const GLbitfield buffers = m_depthTextureChain ? GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT;
+        m_funcs->glBlitFramebuffer(0, 0, m_texSize.width(), m_texSize.height(),
+                                   0, 0, m_texSize.width(), m_texSize.height(),
+                                   buffers, GL_NEAREST);
+        m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
     ovr_CommitTextureSwapChain(m_session, m_textureChain);
+    if (m_depthTextureChain)
+        ovr_CommitTextureSwapChain(m_session, m_depthTextureChain);
 }
 
 const ovrTextureSwapChain& OvrSwapChain::ovrTextureChain() const
@@ -148,9 +232,19 @@ const ovrTextureSwapChain& OvrSwapChain::ovrTextureChain() const
     return m_textureChain;
 }
 
+const ovrTextureSwapChain& OvrSwapChain::ovrDepthTextureChain() const
+{
+    return m_depthTextureChain;
+}
+
 void OvrSwapChain::bindCurrentChainIndexFramebuffer()
 {
     Q_ASSERT(m_textureChain != nullptr);
+    if (m_multisampleFramebuffer)
+    {
+        m_funcs->glBindFramebuffer(GL_FRAMEBUFFER, m_multisampleFramebuffer);
+        return;
+    }
     int curIndex;
     ovr_GetTextureSwapChainCurrentIndex(m_session, m_textureChain, &curIndex);
     m_framebuffers[curIndex]->bind();
@@ -43,8 +43,13 @@ class OvrSwapChain
     QOpenGLFunctions_3_2_Core *m_funcs;
     QVector<FramebufferOvr *> m_framebuffers;
     ovrTextureSwapChain m_textureChain;
+    ovrTextureSwapChain m_depthTextureChain; // Only when depth is submitted
+    // Rendered into with multisampling, resolved into the chain on commit
+    int m_samples;
+    GLuint m_multisampleFramebuffer;
+    GLuint m_multisampleRenderbuffers[2];
 public:
-    OvrSwapChain(ovrSession session, QSize size);
+    OvrSwapChain(ovrSession session, QSize size, int samples = 0, bool depthChain = false, bool floatDepth = false);
     ~OvrSwapChain();
 
     QSize size() const;
@@ -53,6 +58,7 @@ public:
     int    chainLength() const;
     void   commit();
     const ovrTextureSwapChain &ovrTextureChain() const;
+    const ovrTextureSwapChain &ovrDepthTextureChain() const;
 };
 
 #endif
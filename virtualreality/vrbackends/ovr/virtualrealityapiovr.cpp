@@ -15,9 +15,15 @@
 #if(QT3DVR_COMPILE_WITH_OCULUSVR)
 #include "virtualrealityapiovr.h"
 #include "framebufferovr.h"
+#include "../../hiddenareamesh_p.h"
+#include "../../foveation_p.h"
 
 #include "Extras/OVR_Math.h"
 #include "OVR_CAPI_GL.h"
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QQuaternion>
+#include <QSet>
 
 using namespace OVR;
 
@@ -65,6 +71,10 @@ VirtualRealityApiOvr::VirtualRealityApiOvr()
     , m_sensorSampleTime(0.0)
     , m_frameIndex(0)
     , m_swapChain(nullptr)
+    , m_eyeLayerSubmitted(false)
+    , m_mirrorTexture(nullptr)
+    , m_mirrorTextureId(0)
+    , m_mirrorTextureFailed(false)
 {
 }
 
@@ -104,6 +114,15 @@ bool VirtualRealityApiOvr::isHmdPresent()
     return initializeIfHmdIsPresent();
 }
 
+Qt3DVirtualReality::QHeadMountedDisplayFormat VirtualRealityApiOvr::setFormat(const Qt3DVirtualReality::QHeadMountedDisplayFormat &format)
+{
+    Qt3DVirtualReality::QHeadMountedDisplayFormat supported(format);
+    // Texture swap chains with an ArraySize of 2 are not supported by the sdk on PC
+    supported.setRenderTargetLayout(Qt3DVirtualReality::QHeadMountedDisplayFormat::SideBySide);
+    m_format = supported;
+    return supported;
+}
+
 void VirtualRealityApiOvr::initialize()
 {
     bool hmdPresent = initializeIfHmdIsPresent();
@@ -111,11 +130,22 @@ void VirtualRealityApiOvr::initialize()
         return;
     m_hmdDesc = ovr_GetHmdDesc(m_session);
     ovr_SetTrackingOriginType(m_session, ovrTrackingOrigin_FloorLevel);
-    m_swapChain = new OvrSwapChain(m_session, getRenderTargetSize());
+    m_swapChain = new OvrSwapChain(m_session, getRenderTargetSize(), m_format.samples(), m_format.submitDepth(), m_format.reverseDepth());
+    // Until QVirtualrealityCamera hands over the projections it draws with
+    Matrix4f projection = ovrMatrix4f_Projection(m_hmdDesc.DefaultEyeFov[ovrEye_Left], Qt3DVirtualReality::EyeNearClip,
+                                                 Qt3DVirtualReality::EyeFarClip, ovrProjection_ClipRangeOpenGL);
+    m_depthProjectionDesc = ovrTimewarpProjectionDesc_FromProjection(projection, ovrProjection_ClipRangeOpenGL);
 }
 
 void VirtualRealityApiOvr::shutdown()
 {
+    if(m_mirrorTexture != nullptr)
+        ovr_DestroyMirrorTexture(m_session, m_mirrorTexture);
+    m_mirrorTexture = nullptr;
+    for(const LayerChain &layerChain : qAsConst(m_layerChains))
+        ovr_DestroyTextureSwapChain(m_session, layerChain.chain);
+    m_layerChains.clear();
+    m_layerHeaders.clear();
     if(m_swapChain != nullptr)
         delete m_swapChain;
 }
@@ -130,7 +160,8 @@ void VirtualRealityApiOvr::swapToHeadset()
 {
     m_swapChain->commit();
 
-    ovrLayerEyeFov ld;
+    // EyeFovDepth extends EyeFov, the depth members are only read with the depth layer type
+    ovrLayerEyeFovDepth &ld = m_eyeLayer;
     ld.Header.Type  = ovrLayerType_EyeFov;
     ld.Header.Flags = ovrLayerFlag_TextureOriginAtBottomLeft;   // Because OpenGL.
 
@@ -148,17 +179,43 @@ void VirtualRealityApiOvr::swapToHeadset()
 
     ld.SensorSampleTime  = m_sensorSampleTime;
 
-    ovrLayerHeader* layers = &ld.Header;
-    ovrResult result = ovr_SubmitFrame(m_session, m_frameIndex, nullptr, &layers, 1);
+    if (m_swapChain->ovrDepthTextureChain())
+    {
+        // Lets the compositor reproject positionally, with the clip planes of the projection
+        ld.Header.Type = ovrLayerType_EyeFovDepth;
+        ld.DepthTexture[ovrEye_Left] = m_swapChain->ovrDepthTextureChain();
+        ld.DepthTexture[ovrEye_Right] = m_swapChain->ovrDepthTextureChain();
+        ld.ProjectionDesc = m_depthProjectionDesc;
+    }
+    m_eyeLayerSubmitted = submitLayers();
+}
+
+bool VirtualRealityApiOvr::resubmitFrame()
+{
+    if (!m_eyeLayerSubmitted)
+        return false;
+    // Chains are not committed again, the compositor shows their last image with the render poses of the layer
+    return submitLayers();
+}
+
+bool VirtualRealityApiOvr::submitLayers()
+{
+    // Eyes first, compositor layers on top
+    QVector<ovrLayerHeader*> layers;
+    layers.reserve(1 + m_layerHeaders.size());
+    layers.append(&m_eyeLayer.Header);
+    layers += m_layerHeaders.mid(0, ovrMaxLayerCount - 1);
+    ovrResult result = ovr_SubmitFrame(m_session, m_frameIndex, nullptr, layers.constData(), layers.size());
 
     if (!OVR_SUCCESS(result))
     {
         ovrErrorInfo inf;
         ovr_GetLastErrorInfo(&inf);
         qDebug() << inf.ErrorString;
-        return;
+        return false;
     }
     m_frameIndex++;
+    return true;
 }
 
 void VirtualRealityApiOvr::getEyeMatrices(QMatrix4x4 &leftEye, QMatrix4x4 &rightEye)
@@ -193,8 +250,8 @@ void VirtualRealityApiOvr::getEyeMatrices(QMatrix4x4 &leftEye, QMatrix4x4 &right
 
 void VirtualRealityApiOvr::getProjectionMatrices(QMatrix4x4 &leftProjection, QMatrix4x4 &rightProjection)
 {
-    Matrix4f   projLeft   = ovrMatrix4f_Projection(m_hmdDesc.DefaultEyeFov[ovrEye_Left], 0.2f, 1000.0f, ovrProjection_None);
-    Matrix4f   projRight  = ovrMatrix4f_Projection(m_hmdDesc.DefaultEyeFov[ovrEye_Right], 0.2f, 1000.0f, ovrProjection_None);
+    Matrix4f   projLeft   = ovrMatrix4f_Projection(m_hmdDesc.DefaultEyeFov[ovrEye_Left], Qt3DVirtualReality::EyeNearClip, Qt3DVirtualReality::EyeFarClip, ovrProjection_None);
+    Matrix4f   projRight  = ovrMatrix4f_Projection(m_hmdDesc.DefaultEyeFov[ovrEye_Right], Qt3DVirtualReality::EyeNearClip, Qt3DVirtualReality::EyeFarClip, ovrProjection_None);
     QMatrix4x4 projL(projLeft.M[0][0], projLeft.M[0][1], projLeft.M[0][2], projLeft.M[0][3],
                      projLeft.M[1][0], projLeft.M[1][1], projLeft.M[1][2], projLeft.M[1][3],
                      projLeft.M[2][0], projLeft.M[2][1], projLeft.M[2][2], projLeft.M[2][3],
@@ -208,6 +265,51 @@ void VirtualRealityApiOvr::getProjectionMatrices(QMatrix4x4 &leftProjection, QMa
     //TODO: don't copy
 }
 
+void VirtualRealityApiOvr::getProjectionTangents(ProjectionTangents &leftEye, ProjectionTangents &rightEye)
+{
+    ProjectionTangents *tangents[ovrEye_Count] = { &leftEye, &rightEye };
+    for (int eye = 0; eye < ovrEye_Count; ++eye) {
+        const ovrFovPort &fov = m_hmdDesc.DefaultEyeFov[eye];
+        tangents[eye]->left = -fov.LeftTan;
+        tangents[eye]->right = fov.RightTan;
+        tangents[eye]->bottom = -fov.DownTan;
+        tangents[eye]->top = fov.UpTan;
+    }
+}
+
+void VirtualRealityApiOvr::setDepthProjections(const QMatrix4x4 &leftProjection, const QMatrix4x4 &rightProjection, bool reverseDepth)
+{
+    // Only the depth mapping is described, it is the same for both eyes
+    Q_UNUSED(rightProjection);
+    ovrMatrix4f projection;
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column)
+            projection.M[row][column] = leftProjection(row, column);
+    }
+    // Reversed depth is drawn with a 0..1 clip range
+    m_depthProjectionDesc = ovrTimewarpProjectionDesc_FromProjection(projection, reverseDepth ? ovrProjection_FarLessThanNear
+                                                                                              : ovrProjection_ClipRangeOpenGL);
+}
+
+void VirtualRealityApiOvr::getHiddenAreaMeshes(QVector<QVector2D> &left, QVector<QVector2D> &right)
+{
+    // No hidden area mesh in the sdk, mask the corners outside the lens
+    QMatrix4x4 projLeft;
+    QMatrix4x4 projRight;
+    getProjectionMatrices(projLeft, projRight);
+    left = Qt3DVirtualReality::HiddenAreaMesh::synthesize(projLeft);
+    right = Qt3DVirtualReality::HiddenAreaMesh::synthesize(projRight);
+}
+
+QVirtualRealityApiBackend::FoveationProfile VirtualRealityApiOvr::foveationProfile()
+{
+    // Rift lenses have a slightly larger sweet spot
+    QMatrix4x4 projLeft;
+    QMatrix4x4 projRight;
+    getProjectionMatrices(projLeft, projRight);
+    return Qt3DVirtualReality::Foveation::lensProfile(projLeft, projRight, 0.55f, 0.5f);
+}
+
 QList<int> VirtualRealityApiOvr::currentlyTrackedObjects()
 {
     //TODO: does this work?
@@ -225,14 +327,56 @@ Qt3DVirtualReality::QVirtualRealityApiBackend::TrackedObjectType VirtualRealityA
     return Qt3DVirtualReality::QVirtualRealityApiBackend::Other;
 }
 
-void VirtualRealityApiOvr::getTrackedObjectModel(int id, QVector<float> &vertices, QVector<int> &indices, QOpenGLTexture *texture)
+void VirtualRealityApiOvr::getTrackedObjectModel(int id, QVector<float> &vertices, QVector<int> &indices)
 {
 
 }
 
-void VirtualRealityApiOvr::getMirrorTexture(QOpenGLTexture *outMirrorTexture)
+int VirtualRealityApiOvr::getTrackedObjectModelRevision(int id)
 {
+    return -1;
+}
 
+QSize VirtualRealityApiOvr::getTrackedObjectTextureSize()
+{
+    return QSize();
+}
+
+void VirtualRealityApiOvr::uploadTrackedObjectTexture(QOpenGLTexture *texture)
+{
+}
+
+bool VirtualRealityApiOvr::getMirrorTexture(int eye, MirrorTexture &mirrorTexture)
+{
+    if(m_swapChain == nullptr || m_mirrorTextureFailed)
+        return false;
+    const QSize size = m_swapChain->size();
+    if(m_mirrorTexture == nullptr)
+    {
+        // Written by the compositor, both eyes side by side without distortion
+        ovrMirrorTextureDesc desc = {};
+        desc.Format = OVR_FORMAT_R8G8B8A8_UNORM_SRGB;
+        desc.Width = size.width();
+        desc.Height = size.height();
+        ovrResult result = ovr_CreateMirrorTextureGL(m_session, &desc, &m_mirrorTexture);
+        if(!OVR_SUCCESS(result))
+        {
+            ovrErrorInfo inf;
+            ovr_GetLastErrorInfo(&inf);
+            qDebug() << "Could not create mirror texture" << inf.ErrorString;
+            m_mirrorTexture = nullptr;
+            m_mirrorTextureFailed = true;
+            return false;
+        }
+        ovr_GetMirrorTextureBufferGL(m_session, m_mirrorTexture, &m_mirrorTextureId);
+    }
+    const int halfWidth = size.width() / 2;
+    mirrorTexture.textureId = m_mirrorTextureId;
+    mirrorTexture.size = size;
+    mirrorTexture.layer = -1;
+    // Top row first
+    mirrorTexture.eyeRect = QRect(eye * halfWidth, size.height(), halfWidth, -size.height());
+    return true;
 }
 
 bool VirtualRealityApiOvr::isTriggerTmp()
@@ -248,7 +392,14 @@ qreal VirtualRealityApiOvr::refreshRate(int hmdId) const
 
 QMatrix4x4 VirtualRealityApiOvr::headPose(int hmdId)
 {
-    return QMatrix4x4();
+    Q_UNUSED(hmdId);
+    const double displayTime = ovr_GetPredictedDisplayTime(m_session, m_frameIndex);
+    const ovrTrackingState trackingState = ovr_GetTrackingState(m_session, displayTime, ovrTrue);
+    const ovrPosef &pose = trackingState.HeadPose.ThePose;
+    QMatrix4x4 transform;
+    transform.translate(pose.Position.x, pose.Position.y, pose.Position.z);
+    transform.rotate(QQuaternion(pose.Orientation.w, pose.Orientation.x, pose.Orientation.y, pose.Orientation.z));
+    return transform;
 }
 
 QSize VirtualRealityApiOvr::getRenderTargetSize()
@@ -269,4 +420,104 @@ int VirtualRealityApiOvr::timeUntilNextFrame()
     double now = ovr_GetTimeInSeconds();
     return static_cast<int>(std::floor(1000.0*(absolutFrameTime-now)));
 }
+bool VirtualRealityApiOvr::supportsCompositorLayers()
+{
+    return true;
+}
+
+void VirtualRealityApiOvr::setCompositorLayers(const QVector<CompositorLayer> &layers)
+{
+    QOpenGLFunctions *funcs = QOpenGLContext::currentContext()->functions();
+    QSet<int> listed;
+    m_quadLayers.clear();
+    m_cylinderLayers.clear();
+    m_layerHeaders.clear();
+    // Headers point into the vectors, they must not reallocate
+    m_quadLayers.reserve(layers.size());
+    m_cylinderLayers.reserve(layers.size());
+    for (const CompositorLayer &layer : layers) {
+        listed.insert(layer.id);
+        LayerChain &layerChain = m_layerChains[layer.id];
+        const QSize imageSize = layer.image.size();
+        if (layerChain.chain && layerChain.size != imageSize) {
+            ovr_DestroyTextureSwapChain(m_session, layerChain.chain);
+            layerChain = LayerChain();
+        }
+        if (!layerChain.chain) {
+            ovrTextureSwapChainDesc desc = {};
+            desc.Type = ovrTexture_2D;
+            desc.ArraySize = 1;
+            desc.Format = OVR_FORMAT_R8G8B8A8_UNORM_SRGB;
+            desc.Width = imageSize.width();
+            desc.Height = imageSize.height();
+            desc.MipLevels = 1;
+            desc.SampleCount = 1;
+            desc.StaticImage = ovrFalse;
+            if (!OVR_SUCCESS(ovr_CreateTextureSwapChainGL(m_session, &desc, &layerChain.chain))) {
+                ovrErrorInfo inf;
+                ovr_GetLastErrorInfo(&inf);
+                qDebug() << "Could not create texture swap chain for compositor layer" << layer.id << inf.ErrorString;
+                m_layerChains.remove(layer.id);
+                continue;
+            }
+            layerChain.size = imageSize;
+        }
+        if (layerChain.revision != layer.revision) {
+            int index;
+            GLuint textureId;
+            ovr_GetTextureSwapChainCurrentIndex(m_session, layerChain.chain, &index);
+            ovr_GetTextureSwapChainBufferGL(m_session, layerChain.chain, index, &textureId);
+            funcs->glBindTexture(GL_TEXTURE_2D, textureId);
+            funcs->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            funcs->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, imageSize.width(), imageSize.height(),
+                                   GL_RGBA, GL_UNSIGNED_BYTE, layer.image.constBits());
+            funcs->glBindTexture(GL_TEXTURE_2D, 0);
+            ovr_CommitTextureSwapChain(m_session, layerChain.chain);
+            layerChain.revision = layer.revision;
+        }
+
+        ovrPosef pose;
+        pose.Position.x = layer.position.x();
+        pose.Position.y = layer.position.y();
+        pose.Position.z = layer.position.z();
+        pose.Orientation.x = layer.orientation.x();
+        pose.Orientation.y = layer.orientation.y();
+        pose.Orientation.z = layer.orientation.z();
+        pose.Orientation.w = layer.orientation.scalar();
+        // No ovrLayerFlag_TextureOriginAtBottomLeft, images are uploaded top row first
+        if (layer.radius > 0.0f) {
+            ovrLayerCylinder cylinder;
+            cylinder.Header.Type = ovrLayerType_Cylinder;
+            cylinder.Header.Flags = ovrLayerFlag_HighQuality;
+            cylinder.ColorTexture = layerChain.chain;
+            cylinder.Viewport = Recti(0, 0, imageSize.width(), imageSize.height());
+            cylinder.CylinderPoseCenter = pose;
+            cylinder.CylinderRadius = layer.radius;
+            cylinder.CylinderAngle = qMin(float(layer.size.width()) / layer.radius, 2.0f * float(M_PI));
+            cylinder.CylinderAspectRatio = float(layer.size.width() / layer.size.height());
+            m_cylinderLayers.append(cylinder);
+            m_layerHeaders.append(&m_cylinderLayers.last().Header);
+        } else {
+            ovrLayerQuad quad;
+            quad.Header.Type = ovrLayerType_Quad;
+            quad.Header.Flags = ovrLayerFlag_HighQuality;
+            quad.ColorTexture = layerChain.chain;
+            quad.Viewport = Recti(0, 0, imageSize.width(), imageSize.height());
+            quad.QuadPoseCenter = pose;
+            quad.QuadSize.x = layer.size.width();
+            quad.QuadSize.y = layer.size.height();
+            m_quadLayers.append(quad);
+            m_layerHeaders.append(&m_quadLayers.last().Header);
+        }
+    }
+
+    for (auto iter = m_layerChains.begin(); iter != m_layerChains.end(); ) {
+        if (listed.contains(iter.key())) {
+            ++iter;
+            continue;
+        }
+        ovr_DestroyTextureSwapChain(m_session, iter.value().chain);
+        iter = m_layerChains.erase(iter);
+    }
+}
 #endif
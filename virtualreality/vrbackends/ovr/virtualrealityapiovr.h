@@ -17,6 +17,7 @@
 #define VIRTUALREALITYAPIOVR_H
 #include "../../qvirtualrealityapibackend.h"
 #include "OVR_CAPI_GL.h"
+#include <QHash>
 
 class OvrSwapChain;
 
@@ -28,6 +29,7 @@ public:
     ~VirtualRealityApiOvr();
     bool isHmdPresent();
 
+    Qt3DVirtualReality::QHeadMountedDisplayFormat setFormat(const Qt3DVirtualReality::QHeadMountedDisplayFormat &format);
     void initialize();
     void shutdown();
     bool bindFrambufferObject(int hmdId);
@@ -39,17 +41,27 @@ public:
     int timeUntilNextFrame();
 
     void swapToHeadset();
+    bool resubmitFrame();
 
     void getEyeMatrices(QMatrix4x4 &leftEye, QMatrix4x4 &rightEye);
 
-    void getProjectionMatrices(QMatrix4x4 &leftProjection, QMatrix4x4 &rightProjection);
+    void getProjectionTangents(ProjectionTangents &leftEye, ProjectionTangents &rightEye);
+    void setDepthProjections(const QMatrix4x4 &leftProjection, const QMatrix4x4 &rightProjection, bool reverseDepth);
+    void getHiddenAreaMeshes(QVector<QVector2D> &left, QVector<QVector2D> &right);
+    FoveationProfile foveationProfile();
 
     QList<int> currentlyTrackedObjects();
     void getTrackedObject(int id, QMatrix4x4 &transform);
     TrackedObjectType getTrackedObjectType(int id);
-    void getTrackedObjectModel(int id, QVector<float> &vertices, QVector<int> &indices, QOpenGLTexture *texture);
+    void getTrackedObjectModel(int id, QVector<float> &vertices, QVector<int> &indices);
+    int getTrackedObjectModelRevision(int id);
+    QSize getTrackedObjectTextureSize();
+    void uploadTrackedObjectTexture(QOpenGLTexture *texture);
+
+    bool getMirrorTexture(int eye, MirrorTexture &mirrorTexture);
 
-    void getMirrorTexture(QOpenGLTexture *outMirrorTexture);
+    bool supportsCompositorLayers();
+    void setCompositorLayers(const QVector<CompositorLayer> &layers);
 
     bool isTriggerTmp();
 private:
@@ -62,8 +74,29 @@ private:
     double m_sensorSampleTime;
     long long m_frameIndex;
     OvrSwapChain *m_swapChain;
+    ovrLayerEyeFovDepth m_eyeLayer; // Of the last swapToHeadset, resubmitted as is
+    bool m_eyeLayerSubmitted;
+    ovrTimewarpProjectionDesc m_depthProjectionDesc; // Of the projections the eyes are drawn with
+    ovrMirrorTexture m_mirrorTexture; // Created with the first request
+    GLuint m_mirrorTextureId;
+    bool m_mirrorTextureFailed;
+    Qt3DVirtualReality::QHeadMountedDisplayFormat m_format;
+
+    // Texture chain of a compositor layer, committed only when the layer revision changed
+    struct LayerChain {
+        LayerChain() : chain(nullptr), revision(-1) {}
+        ovrTextureSwapChain chain;
+        QSize size;
+        int revision;
+    };
+    QHash<int, LayerChain> m_layerChains; // Keyed by layer id
+    QVector<ovrLayerQuad> m_quadLayers;
+    QVector<ovrLayerCylinder> m_cylinderLayers;
+    QVector<ovrLayerHeader*> m_layerHeaders; // Submission order, pointing into the vectors above
 
     bool initializeIfHmdIsPresent();
+    void getProjectionMatrices(QMatrix4x4 &leftProjection, QMatrix4x4 &rightProjection);
+    bool submitLayers();
 };
 
 #endif
@@ -0,0 +1,77 @@
+import QtQuick 2.1
+import Qt3D.Core 2.0
+import Qt3D.Render 2.0
+import Qt3D.Extras 2.0
+
+import QtQuick 2.0 as QQ2
+
+import vr 2.0
+
+// Test scene for stereo frustum culling. Start vr-window with --culling-test.
+// Spheres surround the player, every second the entities submitted to the renderer are logged together
+// with how many of them pass the combined frustum. The per eye check alternates between the logs.
+Entity {
+    id: root
+
+    components: RenderSettings {
+        StereoFrameGraph {
+            leftCamera: vrCam.leftCamera
+            rightCamera: vrCam.rightCamera
+            stereoCamera: vrCam.stereoCamera
+            stereoUniformBuffer: vrCam.stereoUniformBuffer
+        }
+    }
+
+    HiddenAreaMask {}
+
+    VrCamera {
+        id: vrCam
+    }
+
+    SphereMesh {
+        id: sphereMesh
+        radius: sphereGrid.sphereRadius
+        rings: 16
+        slices: 16
+    }
+
+    NodeInstantiator {
+        id: sphereGrid
+        readonly property int columns: 24
+        readonly property int rows: 8
+        readonly property real sphereRadius: 0.15
+        readonly property real distance: 4.0
+        model: columns * rows
+
+        function spherePosition(index) {
+            var angle = Math.PI * 2.0 * (index % columns) / columns
+            var height = (Math.floor(index / columns) - rows / 2) * 0.5
+            return Qt.vector3d(distance * Math.cos(angle), height, distance * Math.sin(angle))
+        }
+
+        delegate: Entity {
+            components: [
+                sphereMesh,
+                Transform {
+                    translation: sphereGrid.spherePosition(index)
+                },
+                StereoPhongMaterial {
+                    diffuse: Qt.rgba((index % sphereGrid.columns) / sphereGrid.columns, 0.6, 0.3, 1)
+                }
+            ]
+        }
+    }
+
+    QQ2.Timer {
+        running: true
+        repeat: true
+        interval: 1000
+        onTriggered: {
+            // Counted by the aspect a frame after culling, with the per eye check of the last second
+            console.log("Culling: " + _hmd.submittedEntities + " entities submitted, " + _hmd.visibleEntities
+                        + " pass the combined frustum, " + (_hmd.submittedEntities - _hmd.visibleEntities) + " culled, "
+                        + _hmd.eyeDraws + " eye draws" + (vrCam.perEyeCulling ? " with" : " without") + " per eye check")
+            vrCam.perEyeCulling = !vrCam.perEyeCulling
+        }
+    }
+}
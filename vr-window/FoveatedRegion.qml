@@ -0,0 +1,78 @@
+import Qt3D.Core 2.0
+import Qt3D.Render 2.0
+
+// One offscreen region of foveated rendering (StereoFrameGraph, HeadMountedDisplay.MultiPassFoveated).
+// Draws the scene with camera into texture, which is composited into the render target by FoveatedComposite.
+// Also used for the spectator view, which is mirrored instead, the jittered eyes of temporal upsampling
+// the far field of hybrid mono rendering and the depth of occlusion culling.
+RenderTargetSelector {
+    id: regionRoot
+
+    property alias camera: cameraSelector.camera
+    property size size: Qt.size(1, 1)
+    // Only clears while the region is used, the branch is kept in the frame graph
+    property bool active: true
+    // Culls against the frustum of camera, e.g. to skip everything before the near plane of the far field
+    property bool frustumCulling: false
+    property alias surface: regionSurfaceSelector.surface
+    readonly property alias texture: colorTexture
+    readonly property alias depthTexture: depthTexture
+
+    target: RenderTarget {
+        attachments: [
+            RenderTargetOutput {
+                attachmentPoint: RenderTargetOutput.Color0
+                texture: Texture2D {
+                    id: colorTexture
+                    width: regionRoot.size.width
+                    height: regionRoot.size.height
+                    format: Texture.RGBA8_UNorm
+                    generateMipMaps: false
+                    minificationFilter: Texture.Linear
+                    magnificationFilter: Texture.Linear
+                    wrapMode {
+                        x: WrapMode.ClampToEdge
+                        y: WrapMode.ClampToEdge
+                    }
+                }
+            },
+            RenderTargetOutput {
+                attachmentPoint: RenderTargetOutput.Depth
+                texture: Texture2D {
+                    id: depthTexture
+                    width: regionRoot.size.width
+                    height: regionRoot.size.height
+                    format: _hmd.reverseDepth ? Texture.D32F : Texture.D24
+                    generateMipMaps: false
+                }
+            }
+        ]
+    }
+
+    // Viewports are relative to the surface size, make it the size of the region
+    RenderSurfaceSelector {
+        id: regionSurfaceSelector
+        externalRenderTargetSize: regionRoot.size
+
+        ClearBuffers {
+            buffers: regionRoot.active ? ClearBuffers.ColorDepthBuffer : ClearBuffers.None
+            clearColor: "white"
+            clearDepthValue: _hmd.reverseDepth ? 0.0 : 1.0
+
+            CameraSelector {
+                id: cameraSelector
+                FrustumCulling {
+                    enabled: regionRoot.frustumCulling
+                    Viewport {
+                        normalizedRect: Qt.rect(0,0,1,1)
+                        RenderStateSet {
+                            renderStates: [
+                                DepthTest { depthFunction: _hmd.reverseDepth ? DepthTest.Greater : DepthTest.Less }
+                            ]
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
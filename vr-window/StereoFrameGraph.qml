@@ -51,10 +51,59 @@
 import Qt3D.Core 2.0
 import Qt3D.Render 2.0
 
+import vr 2.0
+
 Viewport {
 
     property alias leftCamera: leftCameraSelector.camera
     property alias rightCamera: rightCameraSelector.camera
+    // Encloses both eyes, culling and sorting of the single pass branch happen once for this camera
+    property alias stereoCamera: stereoCameraSelector.camera
+    // QVirtualrealityCamera.stereoUniformBuffer, matrices of both eyes for single pass stereo
+    property alias stereoUniformBuffer: stereoEyesParameter.value
+    readonly property bool multiPass: _hmd.stereoMode === HeadMountedDisplay.MultiPass
+    readonly property bool singlePass: _hmd.stereoMode === HeadMountedDisplay.SinglePassInstanced
+    // Render target is an eye texture array, the geometry shader picks the layer
+    readonly property bool layered: _hmd.stereoMode === HeadMountedDisplay.SinglePassLayered
+    readonly property bool foveated: _hmd.stereoMode === HeadMountedDisplay.MultiPassFoveated
+    readonly property bool temporal: _hmd.stereoMode === HeadMountedDisplay.MultiPassTemporal
+    readonly property bool hybridMono: _hmd.stereoMode === HeadMountedDisplay.MultiPassHybridMono
+    // QVirtualrealityCamera.leftFoveaCamera, sees only the full resolution center of the eye
+    property alias leftFoveaCamera: leftCenterRegion.camera
+    property alias rightFoveaCamera: rightCenterRegion.camera
+    // Offscreen regions of foveated rendering, input of FoveatedComposite
+    readonly property alias leftPeripheryTexture: leftPeripheryRegion.texture
+    readonly property alias rightPeripheryTexture: rightPeripheryRegion.texture
+    readonly property alias leftCenterTexture: leftCenterRegion.texture
+    readonly property alias rightCenterTexture: rightCenterRegion.texture
+    // Jittered eyes of temporal upsampling, input of TemporalResolve
+    readonly property alias leftTemporalTexture: leftTemporalRegion.texture
+    readonly property alias rightTemporalTexture: rightTemporalRegion.texture
+    readonly property alias leftTemporalDepthTexture: leftTemporalRegion.depthTexture
+    readonly property alias rightTemporalDepthTexture: rightTemporalRegion.depthTexture
+    // QVirtualrealityCamera.historyIndex, history target written this frame. The other one holds the previous frame.
+    property int historyIndex: 0
+    readonly property Texture2D currentHistoryTexture: historyIndex === 0 ? historyA.texture : historyB.texture
+    readonly property Texture2D previousHistoryTexture: historyIndex === 0 ? historyB.texture : historyA.texture
+    readonly property size temporalEyeSize: Qt.size(Math.ceil(eyeSize.width * _hmd.temporalScale),
+                                                    Math.ceil(eyeSize.height * _hmd.temporalScale))
+    // QVirtualrealityCamera.farFieldCamera and near field cameras of hybrid mono rendering
+    property alias farFieldCamera: farFieldRegion.camera
+    property alias leftNearFieldCamera: leftNearFieldSelector.camera
+    property alias rightNearFieldCamera: rightNearFieldSelector.camera
+    // QVirtualrealityCamera.farFieldScale, size of the far field relative to an eye
+    property size farFieldScale: Qt.size(1, 1)
+    // Input of FarFieldComposite
+    readonly property alias farFieldTexture: farFieldRegion.texture
+    // QVirtualrealityCamera.occlusionCamera, its depth is read back for HeadMountedDisplay.occlusionCulling
+    property alias occlusionCamera: occlusionRegion.camera
+    readonly property alias occlusionDepthTexture: occlusionRegion.depthTexture
+    // Third person camera, drawn offscreen every HeadMountedDisplay.spectatorInterval frames
+    property alias spectatorCamera: spectatorRegion.camera
+    readonly property alias spectatorTexture: spectatorRegion.texture
+    readonly property size eyeSize: Qt.size(_hmd.renderTargetSize.width / 2, _hmd.renderTargetSize.height)
+    // Depth ranges 0..1 with near at 1, cleared to 0 and nearer fragments are greater
+    readonly property int sceneDepthFunction: _hmd.reverseDepth ? DepthTest.Greater : DepthTest.Less
 //    property alias window: surfaceSelector.surface
 
     RenderSurfaceSelector {
@@ -67,32 +116,353 @@ Viewport {
         ClearBuffers {
             buffers: ClearBuffers.ColorDepthBuffer
             clearColor: "white" //Qt.rgba(0.2,0.9,0.9,0.5)
+            clearDepthValue: _hmd.reverseDepth ? 0.0 : 1.0
             NoDraw {} // We just want to clear the buffers
         }
 
-        // Draw with left eye
-        CameraSelector {
-            id: leftCameraSelector
+        // Prime depth with the areas hidden by the lenses (HiddenAreaMask), nothing is shaded there afterwards
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: layered ? "hiddenAreaLayered" : "hiddenArea" }
+            parameters: Parameter { name: "reverseDepth"; value: _hmd.reverseDepth }
             Viewport {
+                normalizedRect: Qt.rect(0,0,1,1)
                 RenderStateSet {
                     renderStates: [
-                        DepthTest { depthFunction: DepthTest.Less }
+                        DepthTest { depthFunction: DepthTest.Always }
                     ]
                 }
-                normalizedRect: Qt.rect(0,0,0.5,1)
             }
         }
 
-        // Draw with right eye
-        CameraSelector {
-            id: rightCameraSelector
-            Viewport {
-                RenderStateSet {
-                    renderStates: [
-                        DepthTest { depthFunction: DepthTest.Less }
-                    ]
+        // Multi pass: draw the scene once per eye
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: "forward" }
+            NoDraw {
+                enabled: !multiPass
+
+                // Draw with left eye
+                CameraSelector {
+                    id: leftCameraSelector
+                    Viewport {
+                        RenderStateSet {
+                            renderStates: [
+                                DepthTest { depthFunction: sceneDepthFunction }
+                            ]
+                        }
+                        normalizedRect: Qt.rect(0,0,0.5,1)
+                    }
+                }
+
+                // Draw with right eye
+                CameraSelector {
+                    id: rightCameraSelector
+                    Viewport {
+                        RenderStateSet {
+                            renderStates: [
+                                DepthTest { depthFunction: sceneDepthFunction }
+                            ]
+                        }
+                        normalizedRect: Qt.rect(0.5,0,0.5,1)
+                    }
+                }
+            }
+        }
+
+        // Foveated multi pass: per eye the whole eye at reduced resolution and the center at full resolution,
+        // offscreen. The sizes come from the foveation profile of the backend.
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: "forward" }
+            NoDraw {
+                enabled: !foveated
+
+                FoveatedRegion {
+                    id: leftPeripheryRegion
+                    camera: leftCameraSelector.camera
+                    surface: surfaceSelector.surface
+                    active: foveated
+                    size: Qt.size(Math.ceil(eyeSize.width * _hmd.foveaPeripheryScale),
+                                  Math.ceil(eyeSize.height * _hmd.foveaPeripheryScale))
+                }
+                FoveatedRegion {
+                    id: leftCenterRegion
+                    surface: surfaceSelector.surface
+                    active: foveated
+                    size: Qt.size(Math.ceil(eyeSize.width * _hmd.leftFoveaRect.width),
+                                  Math.ceil(eyeSize.height * _hmd.leftFoveaRect.height))
+                }
+                FoveatedRegion {
+                    id: rightPeripheryRegion
+                    camera: rightCameraSelector.camera
+                    surface: surfaceSelector.surface
+                    active: foveated
+                    size: Qt.size(Math.ceil(eyeSize.width * _hmd.foveaPeripheryScale),
+                                  Math.ceil(eyeSize.height * _hmd.foveaPeripheryScale))
+                }
+                FoveatedRegion {
+                    id: rightCenterRegion
+                    surface: surfaceSelector.surface
+                    active: foveated
+                    size: Qt.size(Math.ceil(eyeSize.width * _hmd.rightFoveaRect.width),
+                                  Math.ceil(eyeSize.height * _hmd.rightFoveaRect.height))
+                }
+            }
+        }
+
+        // Temporal multi pass: per eye the whole eye at temporalScale with a jittered camera, offscreen
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: "forward" }
+            NoDraw {
+                enabled: !temporal
+
+                FoveatedRegion {
+                    id: leftTemporalRegion
+                    camera: leftCameraSelector.camera
+                    surface: surfaceSelector.surface
+                    active: temporal
+                    size: temporalEyeSize
+                }
+                FoveatedRegion {
+                    id: rightTemporalRegion
+                    camera: rightCameraSelector.camera
+                    surface: surfaceSelector.surface
+                    active: temporal
+                    size: temporalEyeSize
+                }
+            }
+        }
+
+        // Occlusion depth: the scene from between the eyes at occlusionBufferSize, read back after the frame.
+        // Entities found occluded in an earlier frame disable their geometry renderers and are missing here as well.
+        // While the eyes are instanced, the stereoInstanced techniques draw every mesh once (monoView).
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: singlePass ? "stereoInstanced" : "forward" }
+            parameters: [
+                Parameter { name: "monoView"; value: true },
+                Parameter { name: "StereoEyes"; value: stereoEyesParameter.value }
+            ]
+            NoDraw {
+                enabled: !_hmd.occlusionCulling
+
+                FoveatedRegion {
+                    id: occlusionRegion
+                    surface: surfaceSelector.surface
+                    active: _hmd.occlusionCulling
+                    frustumCulling: true
+                    size: _hmd.occlusionBufferSize
+                }
+            }
+        }
+
+        // Spectator: drawn into its own texture at a reduced rate, only while the headset marks the frame active.
+        // Its cost shows up in HeadMountedDisplay.spectatorGpuTime. While the eyes are instanced, the
+        // stereoInstanced techniques draw every mesh once with the spectator camera (monoView).
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: singlePass ? "stereoInstanced" : "forward" }
+            parameters: [
+                Parameter { name: "monoView"; value: true },
+                Parameter { name: "StereoEyes"; value: stereoEyesParameter.value }
+            ]
+            NoDraw {
+                enabled: !_hmd.spectatorActive
+
+                FoveatedRegion {
+                    id: spectatorRegion
+                    surface: surfaceSelector.surface
+                    active: _hmd.spectatorActive
+                    size: _hmd.spectatorSize
+                }
+            }
+        }
+
+        // Foveated composite: upscale the regions into both halves of the target (FoveatedComposite).
+        // Pixels masked by the hidden area fail the depth test.
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: "foveatedComposite" }
+            parameters: Parameter { name: "reverseDepth"; value: _hmd.reverseDepth }
+            NoDraw {
+                enabled: !foveated
+                Viewport {
+                    normalizedRect: Qt.rect(0,0,1,1)
+                    RenderStateSet {
+                        renderStates: [
+                            DepthTest { depthFunction: sceneDepthFunction },
+                            NoDepthMask {}
+                        ]
+                    }
+                }
+            }
+        }
+
+        // Temporal resolve: accumulate the jittered eyes into the history target of this frame (TemporalResolve)
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: "temporalResolve" }
+            parameters: Parameter { name: "reverseDepth"; value: _hmd.reverseDepth }
+            NoDraw {
+                enabled: !temporal || historyIndex !== 0
+                TemporalHistory {
+                    id: historyA
+                    surface: surfaceSelector.surface
+                    size: _hmd.renderTargetSize
+                }
+            }
+            NoDraw {
+                enabled: !temporal || historyIndex !== 1
+                TemporalHistory {
+                    id: historyB
+                    surface: surfaceSelector.surface
+                    size: _hmd.renderTargetSize
+                }
+            }
+        }
+
+        // Temporal present: copy the history target of this frame into the render target.
+        // Pixels masked by the hidden area fail the depth test.
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: "temporalPresent" }
+            parameters: Parameter { name: "reverseDepth"; value: _hmd.reverseDepth }
+            NoDraw {
+                enabled: !temporal
+                Viewport {
+                    normalizedRect: Qt.rect(0,0,1,1)
+                    RenderStateSet {
+                        renderStates: [
+                            DepthTest { depthFunction: sceneDepthFunction },
+                            NoDepthMask {}
+                        ]
+                    }
+                }
+            }
+        }
+
+        // Hybrid mono: the far field is drawn once offscreen from between the eyes, where the disparity is below a pixel.
+        // Its near plane is the far field distance, closer entities are culled.
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: "forward" }
+            NoDraw {
+                enabled: !hybridMono
+
+                FoveatedRegion {
+                    id: farFieldRegion
+                    surface: surfaceSelector.surface
+                    active: hybridMono
+                    frustumCulling: true
+                    size: Qt.size(Math.ceil(eyeSize.width * farFieldScale.width),
+                                  Math.ceil(eyeSize.height * farFieldScale.height))
+                }
+            }
+        }
+
+        // Hybrid mono composite: the far field is drawn into both halves of the target (FarFieldComposite).
+        // Depth is not written, pixels masked by the hidden area fail the depth test.
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: "farFieldComposite" }
+            parameters: Parameter { name: "reverseDepth"; value: _hmd.reverseDepth }
+            NoDraw {
+                enabled: !hybridMono
+                Viewport {
+                    normalizedRect: Qt.rect(0,0,1,1)
+                    RenderStateSet {
+                        renderStates: [
+                            DepthTest { depthFunction: sceneDepthFunction },
+                            NoDepthMask {}
+                        ]
+                    }
+                }
+            }
+        }
+
+        // Hybrid mono near field: per eye on top of the far field, the far plane is the far field distance.
+        // Entities entirely beyond it are culled.
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: "forward" }
+            NoDraw {
+                enabled: !hybridMono
+
+                CameraSelector {
+                    id: leftNearFieldSelector
+                    FrustumCulling {
+                        Viewport {
+                            RenderStateSet {
+                                renderStates: [
+                                    DepthTest { depthFunction: sceneDepthFunction }
+                                ]
+                            }
+                            normalizedRect: Qt.rect(0,0,0.5,1)
+                        }
+                    }
+                }
+                CameraSelector {
+                    id: rightNearFieldSelector
+                    FrustumCulling {
+                        Viewport {
+                            RenderStateSet {
+                                renderStates: [
+                                    DepthTest { depthFunction: sceneDepthFunction }
+                                ]
+                            }
+                            normalizedRect: Qt.rect(0.5,0,0.5,1)
+                        }
+                    }
+                }
+            }
+        }
+
+        // Single pass: one RenderView for both eyes. Commands are gathered and sorted once,
+        // every draw covers both halves of the target with the instance count doubled.
+        // The vertex shader moves each instance into the half of its eye, clip plane 0 cuts at the center.
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: "stereoInstanced" }
+            parameters: Parameter { id: stereoEyesParameter; name: "StereoEyes" }
+            NoDraw {
+                enabled: !singlePass
+
+                // Eye matrices come from StereoEyes
+                CameraSelector {
+                    id: stereoCameraSelector
+                    // Culls once against the frustum enclosing both eyes
+                    FrustumCulling {
+                        SortPolicy {
+                            // Eyes share all state, minimize state changes of the one command list
+                            sortTypes: [ SortPolicy.StateChangeCost, SortPolicy.Material ]
+                            Viewport {
+                                RenderStateSet {
+                                    renderStates: [
+                                        DepthTest { depthFunction: sceneDepthFunction },
+                                        ClipPlane { planeIndex: 0 }
+                                    ]
+                                }
+                                normalizedRect: Qt.rect(0,0,1,1)
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // Single pass layered: like single pass, but each eye is a layer of the render target.
+        // The geometry shader emits every triangle into both layers, no instancing and no clip plane.
+        TechniqueFilter {
+            matchAll: FilterKey { name: "renderingStyle"; value: "stereoLayered" }
+            parameters: Parameter { name: "StereoEyes"; value: stereoEyesParameter.value }
+            NoDraw {
+                enabled: !layered
+
+                CameraSelector {
+                    camera: stereoCameraSelector.camera
+                    FrustumCulling {
+                        SortPolicy {
+                            sortTypes: [ SortPolicy.StateChangeCost, SortPolicy.Material ]
+                            Viewport {
+                                RenderStateSet {
+                                    renderStates: [
+                                        DepthTest { depthFunction: sceneDepthFunction }
+                                    ]
+                                }
+                                normalizedRect: Qt.rect(0,0,1,1)
+                            }
+                        }
+                    }
                 }
-                normalizedRect: Qt.rect(0.5,0,0.5,1)
             }
         }
     }
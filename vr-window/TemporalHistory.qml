@@ -0,0 +1,50 @@
+import Qt3D.Core 2.0
+import Qt3D.Render 2.0
+
+// One of the two side by side history targets of temporal upsampling (StereoFrameGraph, HeadMountedDisplay.MultiPassTemporal).
+// TemporalResolve writes the result of a frame into it, it is read as history by the next frame.
+RenderTargetSelector {
+    id: historyRoot
+
+    property size size: Qt.size(1, 1)
+    property alias surface: historySurfaceSelector.surface
+    readonly property alias texture: colorTexture
+
+    target: RenderTarget {
+        attachments: [
+            RenderTargetOutput {
+                attachmentPoint: RenderTargetOutput.Color0
+                texture: Texture2D {
+                    id: colorTexture
+                    width: historyRoot.size.width
+                    height: historyRoot.size.height
+                    // Small weights of many frames add up, 8 bit would band
+                    format: Texture.RGBA16F
+                    generateMipMaps: false
+                    minificationFilter: Texture.Linear
+                    magnificationFilter: Texture.Linear
+                    wrapMode {
+                        x: WrapMode.ClampToEdge
+                        y: WrapMode.ClampToEdge
+                    }
+                }
+            }
+        ]
+    }
+
+    // Every pixel is written, no clear
+    RenderSurfaceSelector {
+        id: historySurfaceSelector
+        externalRenderTargetSize: historyRoot.size
+
+        Viewport {
+            normalizedRect: Qt.rect(0,0,1,1)
+            RenderStateSet {
+                renderStates: [
+                    DepthTest { depthFunction: DepthTest.Always },
+                    NoDepthMask {}
+                ]
+            }
+        }
+    }
+}
@@ -20,6 +20,7 @@
 #include <QQmlEngine>
 #include "qvirtualrealityapi.h"
 #include "qheadmounteddisplay.h"
+#include "qmirrorwindow.h"
 
 int main(int argc, char* argv[])
 {
@@ -35,6 +36,14 @@ int main(int argc, char* argv[])
     qDebug() << "Starting...";
     Qt3DVirtualReality::QVirtualRealityApi vrapi(requestedVrApi);
     Qt3DVirtualReality::QHeadMountedDisplayFormat fmt;
+    if(app.arguments().contains(QStringLiteral("--layered")))
+        fmt.setRenderTargetLayout(Qt3DVirtualReality::QHeadMountedDisplayFormat::EyeTextureArray);
+    if(app.arguments().contains(QStringLiteral("--msaa")))
+        fmt.setSamples(4);
+    if(app.arguments().contains(QStringLiteral("--submit-depth")))
+        fmt.setSubmitDepth(true);
+    if(app.arguments().contains(QStringLiteral("--reverse-z")))
+        fmt.setReverseDepth(true);
     Qt3DVirtualReality::QHeadMountedDisplay *hmd(vrapi.getHmd(0, fmt));
     if( hmd == nullptr ) {
         qDebug() << "Head Mounted disply could not be initialized";
@@ -42,7 +51,60 @@ int main(int argc, char* argv[])
     }
     // Expose the head mounted display as a context property so we can set the aspect ratio
     hmd->engine()->qmlEngine()->rootContext()->setContextProperty("_hmd", hmd);
-    hmd->setSource(QUrl("qrc:/main.qml"));
+    // All materials of the scene support single pass stereo, --foveated renders with fixed foveation instead,
+    // --temporal at reduced resolution with temporal upsampling, --hybrid-mono draws the far field once for both eyes.
+    // Eye texture arrays are always drawn with SinglePassLayered.
+    if(hmd->eyeTextureArray())
+        hmd->setStereoMode(Qt3DVirtualReality::QHeadMountedDisplay::SinglePassLayered);
+    else if(app.arguments().contains(QStringLiteral("--foveated")))
+        hmd->setStereoMode(Qt3DVirtualReality::QHeadMountedDisplay::MultiPassFoveated);
+    else if(app.arguments().contains(QStringLiteral("--temporal")))
+        hmd->setStereoMode(Qt3DVirtualReality::QHeadMountedDisplay::MultiPassTemporal);
+    else if(app.arguments().contains(QStringLiteral("--hybrid-mono")))
+        hmd->setStereoMode(Qt3DVirtualReality::QHeadMountedDisplay::MultiPassHybridMono);
+    else
+        hmd->setStereoMode(Qt3DVirtualReality::QHeadMountedDisplay::SinglePassInstanced);
+    if(app.arguments().contains(QStringLiteral("--culling-test")))
+        hmd->setSource(QUrl("qrc:/CullingTestScene.qml"));
+    else
+        hmd->setSource(QUrl("qrc:/main.qml"));
+
+    // Kiosk mode: show the last frame again while nobody moves
+    if(app.arguments().contains(QStringLiteral("--idle-reuse")))
+        hmd->setReuseIdleFrames(true);
+    // Skip the obstacles hidden behind others
+    if(app.arguments().contains(QStringLiteral("--occlusion-culling")))
+        hmd->setOcclusionCulling(true);
+    // Every torus generates and uploads its own buffers, to compare load time and memory
+    if(app.arguments().contains(QStringLiteral("--no-geometry-sharing")))
+        hmd->setGeometrySharing(false);
+    // Third person view at a third of the refresh rate, shown by the mirror
+    const bool spectator = app.arguments().contains(QStringLiteral("--spectator"));
+    if(spectator)
+        hmd->setSpectatorInterval(3);
+    // Desktop view of the headset, --mirror-left shows the left eye only
+    QScopedPointer<Qt3DVirtualReality::QMirrorWindow> mirror;
+    if(spectator || app.arguments().contains(QStringLiteral("--mirror")) || app.arguments().contains(QStringLiteral("--mirror-left"))) {
+        mirror.reset(new Qt3DVirtualReality::QMirrorWindow(hmd));
+        if(spectator) {
+            mirror->setEye(Qt3DVirtualReality::QMirrorWindow::Spectator);
+            mirror->setScale(1.0);
+        } else if(app.arguments().contains(QStringLiteral("--mirror-left"))) {
+            mirror->setEye(Qt3DVirtualReality::QMirrorWindow::LeftEye);
+        }
+        mirror->resize(1280, 720);
+        mirror->show();
+    }
+
+    // --capture session.y4m records the eyes, a path without .y4m records a png sequence into a directory
+    const int captureArgument = app.arguments().indexOf(QStringLiteral("--capture"));
+    if(captureArgument >= 0 && captureArgument + 1 < app.arguments().size()) {
+        const QString capturePath(app.arguments().at(captureArgument + 1));
+        hmd->startCapture(capturePath, capturePath.endsWith(QStringLiteral(".y4m"))
+                          ? Qt3DVirtualReality::QHeadMountedDisplay::Y4mCapture
+                          : Qt3DVirtualReality::QHeadMountedDisplay::PngCapture);
+        QObject::connect(&app, &QGuiApplication::aboutToQuit, hmd, &Qt3DVirtualReality::QHeadMountedDisplay::stopCapture);
+    }
 
     hmd->run();
     return app.exec();
@@ -16,8 +16,29 @@ Entity {
             id: stereoFrameGraph
             leftCamera: vrCam.leftCamera
             rightCamera: vrCam.rightCamera
+            stereoCamera: vrCam.stereoCamera
+            stereoUniformBuffer: vrCam.stereoUniformBuffer
+            leftFoveaCamera: vrCam.leftFoveaCamera
+            rightFoveaCamera: vrCam.rightFoveaCamera
+            spectatorCamera: spectatorCam
+            historyIndex: vrCam.historyIndex
+            farFieldCamera: vrCam.farFieldCamera
+            leftNearFieldCamera: vrCam.leftNearFieldCamera
+            rightNearFieldCamera: vrCam.rightNearFieldCamera
+            farFieldScale: vrCam.farFieldScale
+            occlusionCamera: vrCam.occlusionCamera
         }
     }
+    QQ2.Binding {
+        target: _hmd
+        property: "spectatorTexture"
+        value: stereoFrameGraph.spectatorTexture
+    }
+    QQ2.Binding {
+        target: _hmd
+        property: "occlusionDepthTexture"
+        value: stereoFrameGraph.occlusionDepthTexture
+    }
     Item {
         id: cameraProps
         readonly property real cameraRadius: obstaclesRepeater.radius - 50
@@ -35,6 +56,32 @@ Entity {
         }
     }
     // Camera
+    HiddenAreaMask {}
+    FoveatedComposite {
+        leftPeriphery: stereoFrameGraph.leftPeripheryTexture
+        rightPeriphery: stereoFrameGraph.rightPeripheryTexture
+        leftCenter: stereoFrameGraph.leftCenterTexture
+        rightCenter: stereoFrameGraph.rightCenterTexture
+        leftCenterRect: _hmd.leftFoveaRect
+        rightCenterRect: _hmd.rightFoveaRect
+    }
+    TemporalResolve {
+        leftCurrent: stereoFrameGraph.leftTemporalTexture
+        rightCurrent: stereoFrameGraph.rightTemporalTexture
+        leftDepth: stereoFrameGraph.leftTemporalDepthTexture
+        rightDepth: stereoFrameGraph.rightTemporalDepthTexture
+        history: stereoFrameGraph.previousHistoryTexture
+        resolved: stereoFrameGraph.currentHistoryTexture
+        leftReprojection: vrCam.leftReprojection
+        rightReprojection: vrCam.rightReprojection
+        jitter: vrCam.projectionJitter
+    }
+    FarFieldComposite {
+        farField: stereoFrameGraph.farFieldTexture
+        leftMapping: vrCam.leftFarFieldMapping
+        rightMapping: vrCam.rightFarFieldMapping
+    }
+
     VrCamera {
         id: vrCam
         //offset: Qt.vector3d(80.0,-90.0,0.0)
@@ -42,6 +89,34 @@ Entity {
         //offset: cameraProps.circlePosition.plus(Qt.vector3d(0, 45 * Math.sin(cameraProps.circleRotation * 2), 0)).plus(cameraProps.tan.times(-2))
     }
 
+    // Spectator, looks at the ring of obstacles from above and behind the player
+    Camera {
+        id: spectatorCam
+        projectionType: CameraLens.PerspectiveProjection
+        fieldOfView: 60
+        aspectRatio: _hmd.spectatorSize.width / _hmd.spectatorSize.height
+        nearPlane: 0.1
+        farPlane: 100.0
+        position: Qt.vector3d(0.0, 2.5, 5.0)
+        viewCenter: Qt.vector3d(0.0, 0.0, 0.0)
+        upVector: Qt.vector3d(0.0, 1.0, 0.0)
+    }
+    // Clip control is set for the whole context, with reverse depth the spectator maps near to 1 like the eyes
+    QQ2.Binding {
+        target: spectatorCam
+        property: "projectionMatrix"
+        when: _hmd.reverseDepth
+        value: {
+            var f = 1.0 / Math.tan(spectatorCam.fieldOfView * Math.PI / 360.0)
+            var n = spectatorCam.nearPlane
+            var d = spectatorCam.farPlane - n
+            return Qt.matrix4x4(f / spectatorCam.aspectRatio, 0, 0, 0,
+                                0, f, 0, 0,
+                                0, 0, n / d, spectatorCam.farPlane * n / d,
+                                0, 0, -1, 0)
+        }
+    }
+
     // Torus obsctacles
     NodeInstantiator {
         id: obstaclesRepeater
@@ -50,11 +125,21 @@ Entity {
         readonly property real det: 1.0 / model
         delegate: Entity {
             components: [
+                StereoLevelOfDetail {
+                    id: lod
+                    radius: 0.55
+                    // Projected diameter in eye pixels of the finer levels
+                    thresholds: [ 400, 150, 50 ]
+                },
+                OcclusionVolume {
+                    radius: 0.55
+                },
+                // Tori of the same level draw from one set of buffers, see HeadMountedDisplay.geometrySharing
                 TorusMesh {
                     radius: 0.5
                     minorRadius: 0.05
-                    rings: 100
-                    slices: 20
+                    rings: [ 100, 48, 24, 12 ][ lod.currentIndex ]
+                    slices: [ 20, 12, 8, 6 ][ lod.currentIndex ]
                 },
                 Transform {
                     id: transform
@@ -64,7 +149,7 @@ Entity {
                                              obstaclesRepeater.radius * Math.sin(transform.angle))
                     rotation: fromAxisAndAngle(Qt.vector3d(0.0, 1.0, 0.0), -transform.angle * 180 / Math.PI)
                 },
-                PhongMaterial {
+                StereoPhongMaterial {
                     diffuse: Qt.rgba(Math.abs(Math.cos(transform.angle)), 204 / 255, 75 / 255, 1)
                     specular: "white"
                     shininess: 20.0
@@ -72,40 +157,8 @@ Entity {
             ]
         }
     }
-    NodeInstantiator {
-        id: trackedObjectsRepeater
-        // TO DO: a model does not yet work here (array with indices). temporarily using a number
-        model: 4 // default: 1 -> head, 2&3 -> base station, 4&5 -> controller/hands
-            // different setup? : 1&2 -> base stations, 3&4 -> controllers, 5 -> ?
-        delegate: Entity {
-            Timer {
-                running: true
-                repeat: true
-                interval: 1
-                onTriggered: {
-                    // this is a temporary workaround and there are no property change events here
-                    trackedTransform.matrix = vrCam.trackedObjectMatrixTmp(index+1)
-                }
-            }
-            components: [
-                TrackedObjectMesh {
-                    trackedObjectId: index+1
-                },
-//                TorusMesh {
-//                    radius: 0.1
-//                    minorRadius: 0.05
-//                    rings: 100
-//                    slices: 20
-//                },
-                Transform {
-                    id: trackedTransform
-                },
-                PhongMaterial {
-                    specular: "white"
-                    ambient: Qt.rgba(1.0*index,1.0*(index-1.0),0.0,1.0)
-                    shininess: 20.0
-                }
-            ]
-        }
+    // All tracked objects (hmd, base stations, controllers) with a single draw call
+    TrackedObjectsLayer {
+        offset: vrCam.offset
     }
 }